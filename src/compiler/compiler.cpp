@@ -6,16 +6,27 @@
 #include "../errors/errors.hpp"
 #include "../parser/parser.hpp"
 #include "../lexer/lexer.hpp"
+#include "../trace/trace.hpp"
 #include <fstream>
 #include <iostream>
+#include <unordered_set>
 #include <llvm/ADT/APInt.h>
+#include <llvm/ADT/SCCIterator.h>
+#include <llvm/Analysis/ConstantFolding.h>
+#include <llvm/Analysis/ValueTracking.h>
+#include <llvm/IR/CFG.h>
 #include <llvm/IR/Constants.h>
 #include <llvm/IR/DerivedTypes.h>
 #include <llvm/IR/InstrTypes.h>
 #include <llvm/IR/Instructions.h>
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/IR/Intrinsics.h>
+#include <llvm/IR/MDBuilder.h>
 #include <llvm/IR/Type.h>
+#include <llvm/Support/TimeProfiler.h>
 #include <regex.h>
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -56,6 +67,7 @@ compiler::Compiler::Compiler(const std::string& source, std::filesystem::path fi
     ir_gc_map_file >> this->ir_gc_map_json;
     this->ir_gc_map_json["functions"] = nlohmann::json::object();
     this->ir_gc_map_json["structs"] = nlohmann::json::object();
+    this->ir_gc_map_json["attributes"] = nlohmann::json::object();
     ir_gc_map_file.close();
 }
 void compiler::Compiler::_initializeBuiltins() {
@@ -65,7 +77,9 @@ void compiler::Compiler::_initializeBuiltins() {
     this->enviornment.parent->add(_float);
     auto _char = std::make_shared<enviornment::RecordStructType>("char", llvm::Type::getInt8Ty(llvm_context));
     this->enviornment.parent->add(_char);
-    auto _string = std::make_shared<enviornment::RecordStructType>("str", llvm::PointerType::get(llvm::Type::getInt8Ty(llvm_context), 0));
+    // layout of gigly_str in runtime/gigly_runtime.h, passed around by value
+    auto _string = std::make_shared<enviornment::RecordStructType>(
+        "str", llvm::StructType::create(this->llvm_context, {llvm::PointerType::get(this->llvm_context, 0), llvm::Type::getInt64Ty(llvm_context)}, "str"));
     this->enviornment.parent->add(_string);
     auto _void = std::make_shared<enviornment::RecordStructType>("void", llvm::Type::getVoidTy(llvm_context));
     this->enviornment.parent->add(_void);
@@ -74,32 +88,127 @@ void compiler::Compiler::_initializeBuiltins() {
     // array standalone type
     auto _array = std::make_shared<enviornment::RecordStructType>("array", llvm::PointerType::get(llvm::Type::getVoidTy(llvm_context), 0));
     this->enviornment.parent->add(_array);
+    // sized integers and f32, `int` and `float` are the 64-bit ones. An unsigned type shares the LLVM integer type of its
+    // signed counterpart and differs in how it divides, compares, shifts and widens
+    for (auto [name, type, is_unsigned] : std::vector<std::tuple<std::string, llvm::Type*, bool>>{{"i8", llvm::Type::getInt8Ty(llvm_context), false},
+                                                                                              {"i16", llvm::Type::getInt16Ty(llvm_context), false},
+                                                                                              {"i32", llvm::Type::getInt32Ty(llvm_context), false},
+                                                                                              {"i64", llvm::Type::getInt64Ty(llvm_context), false},
+                                                                                              {"u8", llvm::Type::getInt8Ty(llvm_context), true},
+                                                                                              {"u16", llvm::Type::getInt16Ty(llvm_context), true},
+                                                                                              {"u32", llvm::Type::getInt32Ty(llvm_context), true},
+                                                                                              {"u64", llvm::Type::getInt64Ty(llvm_context), true},
+                                                                                              {"f32", llvm::Type::getFloatTy(llvm_context), false}}) {
+        auto scalar = std::make_shared<enviornment::RecordStructType>(name, type);
+        scalar->is_unsigned = is_unsigned;
+        this->enviornment.parent->add(scalar);
+    }
+    // SIMD vectors, operators work lane by lane and comparisons produce the lane mask of the same width.
+    // The lane type is kept as the vector's only generic argument.
+    for (auto [name, lane, lanes] : std::vector<std::tuple<std::string, std::string, unsigned>>{
+             {"f64x2", "float", 2}, {"f64x4", "float", 4}, {"f64x8", "float", 8}, {"f32x4", "f32", 4},   {"f32x8", "f32", 8},     {"f32x16", "f32", 16},
+             {"i64x2", "int", 2},   {"i64x4", "int", 4},   {"i32x4", "i32", 4},   {"i32x8", "i32", 8},   {"i32x16", "i32", 16},   {"u32x4", "u32", 4},
+             {"u32x8", "u32", 8},   {"i8x16", "i8", 16},   {"i8x32", "i8", 32},   {"u8x16", "u8", 16},   {"u8x32", "u8", 32},     {"mask2", "bool", 2},
+             {"mask4", "bool", 4},  {"mask8", "bool", 8},  {"mask16", "bool", 16}, {"mask32", "bool", 32}}) {
+        auto lane_type = this->enviornment.parent->get_struct(lane);
+        auto vector = std::make_shared<enviornment::RecordStructType>(name, llvm::FixedVectorType::get(lane_type->stand_alone_type, lanes));
+        vector->is_unsigned = lane_type->is_unsigned;
+        vector->generic_arguments.push_back(std::make_shared<enviornment::RecordStructInstance>(lane_type));
+        this->enviornment.parent->add(vector);
+        this->vector_types.push_back(vector);
+    }
+    // layout of gigly_array in runtime/gigly_runtime.h
+    this->array_header = llvm::StructType::create(this->llvm_context, {_array->stand_alone_type, _int->stand_alone_type, _int->stand_alone_type, _array->stand_alone_type}, "array.header");
+
+    // Array runtime: allocation, the slow path of append and slicing. Arrays are collected, allocation takes the
+    // collector's descriptor of the element type (null when elements hold no pointers)
+    auto arrayNew = llvm::Function::Create(llvm::FunctionType::get(_array->stand_alone_type, {_int->stand_alone_type, _int->stand_alone_type, _array->stand_alone_type}, false),
+                                           llvm::Function::ExternalLinkage, "gigly_array_new", this->llvm_module.get());
+    arrayNew->addRetAttr(llvm::Attribute::NoAlias);
+    arrayNew->addFnAttr(llvm::Attribute::NoUnwind);
+    auto arrayGrow = llvm::Function::Create(llvm::FunctionType::get(_void->stand_alone_type, {_array->stand_alone_type, _int->stand_alone_type, _int->stand_alone_type, _array->stand_alone_type}, false),
+                                            llvm::Function::ExternalLinkage, "gigly_array_grow", this->llvm_module.get());
+    arrayGrow->addFnAttr(llvm::Attribute::NoUnwind);
+    arrayGrow->addFnAttr(llvm::Attribute::Cold);
+    arrayGrow->addParamAttr(0, llvm::Attribute::NoCapture);
+    auto arraySlice = llvm::Function::Create(llvm::FunctionType::get(_array->stand_alone_type, {_array->stand_alone_type, _int->stand_alone_type, _int->stand_alone_type, _int->stand_alone_type}, false),
+                                             llvm::Function::ExternalLinkage, "gigly_array_slice", this->llvm_module.get());
+    arraySlice->addRetAttr(llvm::Attribute::NoAlias);
+    arraySlice->addFnAttr(llvm::Attribute::NoUnwind);
+    arraySlice->addParamAttr(0, llvm::Attribute::NoCapture);
+    auto arenaCheckEscape = llvm::Function::Create(llvm::FunctionType::get(_void->stand_alone_type, {_array->stand_alone_type, _array->stand_alone_type, _array->stand_alone_type}, false),
+                                                   llvm::Function::ExternalLinkage, "gigly_arena_check_escape", this->llvm_module.get());
+    arenaCheckEscape->addFnAttr(llvm::Attribute::NoUnwind);
+    arenaCheckEscape->addParamAttr(0, llvm::Attribute::NoCapture);
+    arenaCheckEscape->addParamAttr(1, llvm::Attribute::NoCapture);
+    arraySlice->addParamAttr(0, llvm::Attribute::ReadOnly);
+    // Arena runtime behind `arena { ... }` blocks
+    auto arenaEnter = llvm::Function::Create(llvm::FunctionType::get(_array->stand_alone_type, {_int->stand_alone_type}, false), llvm::Function::ExternalLinkage,
+                                             "gigly_arena_enter", this->llvm_module.get());
+    arenaEnter->addRetAttr(llvm::Attribute::NoAlias);
+    arenaEnter->addFnAttr(llvm::Attribute::NoUnwind);
+    auto arenaExit = llvm::Function::Create(llvm::FunctionType::get(_void->stand_alone_type, {_array->stand_alone_type}, false), llvm::Function::ExternalLinkage,
+                                            "gigly_arena_exit", this->llvm_module.get());
+    arenaExit->addFnAttr(llvm::Attribute::NoUnwind);
+    auto boundsFail = llvm::Function::Create(llvm::FunctionType::get(_void->stand_alone_type, {_int->stand_alone_type, _int->stand_alone_type}, false),
+                                             llvm::Function::ExternalLinkage, "gigly_bounds_fail", this->llvm_module.get());
+    boundsFail->addFnAttr(llvm::Attribute::NoReturn);
+    boundsFail->addFnAttr(llvm::Attribute::NoUnwind);
+    boundsFail->addFnAttr(llvm::Attribute::Cold);
+    auto rangeStepFail = llvm::Function::Create(llvm::FunctionType::get(_void->stand_alone_type, {}, false), llvm::Function::ExternalLinkage, "gigly_range_step_fail",
+                                                this->llvm_module.get());
+    rangeStepFail->addFnAttr(llvm::Attribute::NoReturn);
+    rangeStepFail->addFnAttr(llvm::Attribute::NoUnwind);
+    rangeStepFail->addFnAttr(llvm::Attribute::Cold);
+
+    // String runtime: concatenation, slicing and output all take gigly_str by pointer
+    auto strConcat = llvm::Function::Create(llvm::FunctionType::get(_void->stand_alone_type, {_array->stand_alone_type, _array->stand_alone_type, _int->stand_alone_type}, false),
+                                            llvm::Function::ExternalLinkage, "gigly_str_concat", this->llvm_module.get());
+    strConcat->addFnAttr(llvm::Attribute::NoUnwind);
+    strConcat->addParamAttr(1, llvm::Attribute::ReadOnly);
+    auto strSlice = llvm::Function::Create(llvm::FunctionType::get(_void->stand_alone_type, {_array->stand_alone_type, _array->stand_alone_type, _int->stand_alone_type, _int->stand_alone_type}, false),
+                                           llvm::Function::ExternalLinkage, "gigly_str_slice", this->llvm_module.get());
+    strSlice->addFnAttr(llvm::Attribute::NoUnwind);
+    strSlice->addParamAttr(1, llvm::Attribute::ReadOnly);
+    this->_declareRuntimeBuiltin("puts", "gigly_str_puts", _void, {_string});
 
-    // Create the global variable 'true'
-    llvm::GlobalVariable* globalTrue =
-        new llvm::GlobalVariable(*this->llvm_module, this->enviornment.parent->get_struct("bool")->stand_alone_type, true, llvm::GlobalValue::InternalLinkage,
-            llvm::ConstantInt::get(this->enviornment.parent->get_struct("bool")->stand_alone_type, 1), "True");
-
-    // Create the global variable 'false'
-    llvm::GlobalVariable* globalFalse =
-        new llvm::GlobalVariable(*this->llvm_module, this->enviornment.parent->get_struct("bool")->stand_alone_type, true, llvm::GlobalValue::InternalLinkage,
-            llvm::ConstantInt::get(this->enviornment.parent->get_struct("bool")->stand_alone_type, 0), "False");
-        auto recordTrue = std::make_shared<enviornment::RecordVariable>("True", globalTrue, nullptr, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.parent->get_struct("bool")));
-        this->enviornment.parent->add(recordTrue);
-        auto recordFalse = std::make_shared<enviornment::RecordVariable>("False", globalFalse, nullptr, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.parent->get_struct("bool")));
-        this->enviornment.parent->add(recordFalse);
-
-    // Create the function type: void puts(const char*)
-    llvm::FunctionType* putsType = llvm::FunctionType::get(_void->stand_alone_type, _string->stand_alone_type, false);
-    auto puts = llvm::Function::Create(putsType, llvm::Function::ExternalLinkage, "puts", this->llvm_module.get());
-    std::vector<std::tuple<std::string, std::shared_ptr<enviornment::RecordVariable>>> putsParams = {{"string", nullptr}};
-    this->enviornment.parent->add(std::make_shared<enviornment::RecordFunction>("puts", puts, putsType, putsParams, std::make_shared<enviornment::RecordStructInstance>(_void)));
-
-    // Create the function type: int print(const char*)
-    llvm::FunctionType* funcType = llvm::FunctionType::get(_int->stand_alone_type, _string->stand_alone_type, false);
-    auto func = llvm::Function::Create(funcType, llvm::Function::ExternalLinkage, "print", this->llvm_module.get());
-    std::vector<std::tuple<std::string, std::shared_ptr<enviornment::RecordVariable>>> params = {{"string", nullptr}};
-    this->enviornment.parent->add(std::make_shared<enviornment::RecordFunction>("print", func, funcType, params, std::make_shared<enviornment::RecordStructInstance>(_int)));
+    // Files: open(path, mode) -> fd, read(fd, count) -> str, write(fd, data) -> bytes written, close(fd),
+    // mmap_file(path) -> str over the mapped file
+    this->_declareRuntimeBuiltin("open", "gigly_file_open", _int, {_string, _string});
+    this->_declareRuntimeBuiltin("read", "gigly_file_read", _string, {_int, _int});
+    this->_declareRuntimeBuiltin("write", "gigly_file_write", _int, {_int, _string});
+    this->_declareRuntimeBuiltin("close", "gigly_file_close", _int, {_int});
+    this->_declareRuntimeBuiltin("mmap_file", "gigly_file_map", _string, {_string});
+    // layout of gigly_line_reader, the collector sees the chunk lines are sliced from
+    this->line_reader = std::make_shared<enviornment::RecordStructType>(
+        "line.reader", llvm::StructType::create(this->llvm_context, {_string->stand_alone_type, _int->stand_alone_type, _int->stand_alone_type, _int->stand_alone_type}, "line.reader"),
+        std::vector<std::string>{"chunk", "offset", "fd", "buffer_size"});
+    this->line_reader->string_fields.push_back({0});
+    auto linesOpen = llvm::Function::Create(llvm::FunctionType::get(_void->stand_alone_type, {_array->stand_alone_type, _array->stand_alone_type, _int->stand_alone_type, _int->stand_alone_type}, false),
+                                            llvm::Function::ExternalLinkage, "gigly_lines_open", this->llvm_module.get());
+    linesOpen->addFnAttr(llvm::Attribute::NoUnwind);
+    auto linesNext = llvm::Function::Create(llvm::FunctionType::get(llvm::Type::getInt32Ty(llvm_context), {_array->stand_alone_type, _array->stand_alone_type}, false),
+                                            llvm::Function::ExternalLinkage, "gigly_lines_next", this->llvm_module.get());
+    linesNext->addFnAttr(llvm::Attribute::NoUnwind);
+
+    // Buffered output behind print, eprint and flush, one writer per value type
+    auto fd_type = llvm::Type::getInt32Ty(llvm_context);
+    for (auto [name, value_type] : std::vector<std::tuple<std::string, llvm::Type*>>{{"gigly_io_write_str", _array->stand_alone_type},
+                                                                                     {"gigly_io_write_int", _int->stand_alone_type},
+                                                                                     {"gigly_io_write_uint", _int->stand_alone_type},
+                                                                                     {"gigly_io_write_float", _float->stand_alone_type},
+                                                                                     {"gigly_io_write_f32", llvm::Type::getFloatTy(llvm_context)},
+                                                                                     {"gigly_io_write_bool", fd_type},
+                                                                                     {"gigly_io_write_char", fd_type}}) {
+        auto writer = llvm::Function::Create(llvm::FunctionType::get(_void->stand_alone_type, {fd_type, value_type}, false), llvm::Function::ExternalLinkage, name,
+                                             this->llvm_module.get());
+        writer->addFnAttr(llvm::Attribute::NoUnwind);
+    }
+    llvm::FunctionType* flushType = llvm::FunctionType::get(_void->stand_alone_type, false);
+    auto flush = llvm::Function::Create(flushType, llvm::Function::ExternalLinkage, "gigly_io_flush", this->llvm_module.get());
+    flush->addFnAttr(llvm::Attribute::NoUnwind);
+    this->enviornment.parent->add(std::make_shared<enviornment::RecordFunction>("flush", flush, flushType, std::vector<std::tuple<std::string, std::shared_ptr<enviornment::RecordVariable>>>{},
+                                                                                std::make_shared<enviornment::RecordStructInstance>(_void)));
 }
 
 void compiler::Compiler::compile(std::shared_ptr<AST::Node> node) {
@@ -115,6 +224,10 @@ void compiler::Compiler::compile(std::shared_ptr<AST::Node> node) {
         this->_visitInfixExpression(std::static_pointer_cast<AST::InfixExpression>(node));
         break;
     }
+    case AST::NodeType::PrefixedExpression: {
+        this->_visitPrefixExpression(std::static_pointer_cast<AST::PrefixExpression>(node));
+        break;
+    }
     case AST::NodeType::IndexExpression: {
         this->_visitIndexExpression(std::static_pointer_cast<AST::IndexExpression>(node));
         break;
@@ -151,12 +264,21 @@ void compiler::Compiler::compile(std::shared_ptr<AST::Node> node) {
         this->_visitWhileStatement(std::static_pointer_cast<AST::WhileStatement>(node));
         break;
     }
+    case AST::NodeType::ForStatement: {
+        this->_visitForStatement(std::static_pointer_cast<AST::ForStatement>(node));
+        break;
+    }
+    case AST::NodeType::ArenaStatement: {
+        this->_visitArenaStatement(std::static_pointer_cast<AST::ArenaStatement>(node));
+        break;
+    }
     case AST::NodeType::BreakStatement: {
         if(this->enviornment.loop_end_block.empty()) {
             std::cerr << "Break statement outside loop" << std::endl;
             exit(1);
         }
         auto f_node = std::static_pointer_cast<AST::BreakStatement>(node);
+        this->_exitArenas(this->enviornment.loop_arena_depth.at(this->enviornment.loop_arena_depth.size() - f_node->loopIdx - 1));
         auto breakInst = this->llvm_ir_builder.CreateBr(this->enviornment.loop_end_block.at(this->enviornment.loop_end_block.size() - f_node->loopIdx - 1));
         break;
     }
@@ -166,6 +288,7 @@ void compiler::Compiler::compile(std::shared_ptr<AST::Node> node) {
             exit(1);
         }
         auto f_node = std::static_pointer_cast<AST::ContinueStatement>(node);
+        this->_exitArenas(this->enviornment.loop_arena_depth.at(this->enviornment.loop_arena_depth.size() - f_node->loopIdx - 1));
         auto continueInst = this->llvm_ir_builder.CreateBr(this->enviornment.loop_condition_block.at(this->enviornment.loop_condition_block.size() - f_node->loopIdx - 1));
         break;
     }
@@ -186,9 +309,31 @@ void compiler::Compiler::compile(std::shared_ptr<AST::Node> node) {
 };
 
 void compiler::Compiler::_visitProgram(std::shared_ptr<AST::Program> program) {
+    for (auto stmt : program->statements) {
+        if (stmt->type() == AST::NodeType::FunctionStatement) {
+            this->declares_generics = this->declares_generics || !std::static_pointer_cast<AST::FunctionStatement>(stmt)->generics.empty();
+        } else if (stmt->type() == AST::NodeType::StructStatement) {
+            this->declares_generics = this->declares_generics || !std::static_pointer_cast<AST::StructStatement>(stmt)->generics.empty();
+        }
+    }
     for(auto stmt : program->statements) {
+        // one --time-trace scope per top-level declaration
+        llvm::TimeTraceScope scope(*AST::nodeTypeToString(stmt->type()), [&] {
+            switch (stmt->type()) {
+            case AST::NodeType::FunctionStatement:
+                return std::static_pointer_cast<AST::IdentifierLiteral>(std::static_pointer_cast<AST::FunctionStatement>(stmt)->name)->value;
+            case AST::NodeType::StructStatement:
+                return std::static_pointer_cast<AST::IdentifierLiteral>(std::static_pointer_cast<AST::StructStatement>(stmt)->name)->value;
+            case AST::NodeType::ImportStatement:
+                return std::static_pointer_cast<AST::ImportStatement>(stmt)->relativePath;
+            default:
+                return std::string();
+            }
+        });
         this->compile(stmt);
     }
+    this->_stripDeadFunctions();
+    this->_inferFunctionAttributes();
 };
 
 void compiler::Compiler::_visitExpressionStatement(std::shared_ptr<AST::ExpressionStatement> expression_statement) {
@@ -197,6 +342,10 @@ void compiler::Compiler::_visitExpressionStatement(std::shared_ptr<AST::Expressi
 
 void compiler::Compiler::_visitBlockStatement(std::shared_ptr<AST::BlockStatement> block_statement) {
     for(auto stmt : block_statement->statements) {
+        // nothing after a return, break or continue is reachable, and the block it would go into is already terminated
+        if (this->llvm_ir_builder.GetInsertBlock() != nullptr && this->llvm_ir_builder.GetInsertBlock()->getTerminator() != nullptr) {
+            break;
+        }
         this->compile(stmt);
     }
 };
@@ -206,6 +355,15 @@ std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::
     auto op = infixed_expression->op;
     auto left = infixed_expression->left;
     auto right = infixed_expression->right;
+    if (op != token::TokenType::Dot) {
+        auto [constant, constant_type] = this->_resolveConstant(infixed_expression);
+        if (constant != nullptr) {
+            return {{constant}, constant_type};
+        }
+    }
+    if (op == token::TokenType::And || op == token::TokenType::Or) {
+        return this->_emitLogical(infixed_expression);
+    }
     auto [left_value, _left_type] = this->_resolveValue(left);
     if (op == token::TokenType::Dot) {
         if (right->type() == AST::NodeType::IdentifierLiteral) {
@@ -235,16 +393,18 @@ std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::
                     left_value[0],
                     idx
                 );
+                if (type->struct_type->struct_type) {
+                    // nested structs are used in place
+                    return {{gep}, type};
+                }
+                auto left_name = left->type() == AST::NodeType::IdentifierLiteral ? std::static_pointer_cast<AST::IdentifierLiteral>(left)->value : "";
+                bool is_volatile = !left_name.empty() && this->enviornment.is_variable(left_name) && this->enviornment.get_variable(left_name)->is_volatile;
                 llvm::Value* load = this->llvm_ir_builder.CreateLoad(
                     type->struct_type->stand_alone_type,
-                    gep
+                    gep,
+                    is_volatile
                 );
-                return {
-                    {
-                        type->struct_type->struct_type ? gep : load
-                    },
-                    type
-                };
+                return {{load}, type};
             }
             else {
                 std::cerr << "Struct does not have member " + std::static_pointer_cast<AST::IdentifierLiteral>(right)->value << std::endl;
@@ -270,27 +430,26 @@ std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::
                 auto left_type = std::get<std::shared_ptr<enviornment::RecordModule>>(_left_type);
                 if(left_type->is_function(name)) {
                     auto func = left_type->get_function(name);
+                    this->_implicitCastArguments(func, args, params_types, call_expression);
                     if (!this->_checkFunctionParameterType(func, params_types)) {
                         std::cerr << "Method Parameter Type Mismatch for function: " << name << std::endl;
                         exit(1);
                     }
-                    auto returnValue = this->llvm_ir_builder.CreateCall(
-                        func->function, args);
+                    auto returnValue = this->_createCall(func, args);
+                    return {{returnValue}, func->return_inst};
+                }
+                else if (left_type->is_generic_function(name)) {
+                    auto func = this->_inferGenericFunction(left_type->get_generic_function(name), params_types, call_expression);
+                    this->_implicitCastArguments(func, args, params_types, call_expression);
+                    auto returnValue = this->_createCall(func, args);
                     return {{returnValue}, func->return_inst};
                 }
                 else if (left_type->is_struct(name)) {
-                    auto struct_record = this->enviornment.get_struct(name);
-                    auto struct_type = struct_record->struct_type;
-                    auto alloca = this->llvm_ir_builder.CreateAlloca(struct_type, nullptr, name);
-                    for (unsigned int i = 0; i < args.size(); ++i) {
-                        if (!this->_checkType(struct_record->sub_types[struct_record->fields[i]], params_types[i])) {
-                            std::cerr << "Struct Type MissMatch" << std::endl;
-                            exit(1);
-                        }
-                        auto field_ptr = this->llvm_ir_builder.CreateStructGEP(struct_type, alloca, i);
-                        auto storeInst = this->llvm_ir_builder.CreateStore(args[i], field_ptr);
-                    }
-                    return {{alloca}, std::make_shared<enviornment::RecordStructInstance>(struct_record)};
+                    return this->_visitStructConstruction(left_type->get_struct(name), args, params_types);
+                }
+                else if (left_type->is_generic_struct(name)) {
+                    auto struct_record = this->_inferGenericStruct(left_type->get_generic_struct(name), params_types, call_expression);
+                    return this->_visitStructConstruction(struct_record, args, params_types);
                 }
                 else {
                     std::cerr << "Struct Or Function " << name << " Dose Not Exit." << std::endl;
@@ -298,18 +457,21 @@ std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::
                 }
             }
             auto left_type = std::get<std::shared_ptr<enviornment::RecordStructInstance>>(_left_type);
-            if (left_type->struct_type->stand_alone_type == nullptr && left_type->struct_type->methods.contains(std::static_pointer_cast<AST::IdentifierLiteral>(right)->value)) {
-                auto method = left_type->struct_type->methods[name];
+            if (left_type->struct_type->stand_alone_type == nullptr && left_type->struct_type->is_method(name)) {
+                auto method = left_type->struct_type->get_method(name);
+                // the receiver binds to `self`, struct values are already addresses so it is passed like any struct argument
+                args.insert(args.begin(), left_value[0]);
+                params_types.insert(params_types.begin(), left_type);
+                this->_implicitCastArguments(method, args, params_types, call_expression);
                 if (!this->_checkFunctionParameterType(method, params_types)) {
                     std::cerr << "Method Parameter Type Mismatch for function: " << name << std::endl;
                     exit(1);
                 }
-                auto returnValue = this->llvm_ir_builder.CreateCall(
-                    method->function, args);
+                auto returnValue = this->_createCall(method, args);
                 return {{returnValue}, method->return_inst};
             }
             else {
-                std::cerr << "Struct does not have method " + std::static_pointer_cast<AST::IdentifierLiteral>(right)->value << std::endl;
+                std::cerr << "Struct does not have method " + name << std::endl;
                 exit(1);
             }
         }
@@ -327,313 +489,178 @@ std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::
     auto right_val = right_value[0];
     auto left_type = std::get<std::shared_ptr<enviornment::RecordStructInstance>>(_left_type);
     auto right_type = std::get<std::shared_ptr<enviornment::RecordStructInstance>>(_right_type);
+    return this->_emitInfixOperation(infixed_expression, left_val, left_type, right_val, right_type);
+};
+
+// Operands already evaluated, compound assignments come here with the value loaded from the target
+std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::RecordStructInstance>, std::shared_ptr<enviornment::RecordModule>>> compiler::Compiler::_emitInfixOperation(
+    std::shared_ptr<AST::InfixExpression> infixed_expression, llvm::Value* left_val, std::shared_ptr<enviornment::RecordStructInstance> left_type, llvm::Value* right_val,
+    std::shared_ptr<enviornment::RecordStructInstance> right_type) {
+    auto op = infixed_expression->op;
+    if (this->_isVector(left_type) || this->_isVector(right_type)) {
+        return this->_emitVectorOperation(infixed_expression, left_val, left_type, right_val, right_type);
+    }
     if (left_type->struct_type->struct_type != nullptr || right_type->struct_type->struct_type != nullptr) {
         if(!this->_checkType(left_type, right_type)) {
             std::cerr << "Infix Expression Type mismatch" << std::endl;
             exit(1);
         }
-        switch(op) {
-            case token::TokenType::Plus : {
-                if (left_type->struct_type->methods.contains("__add__")) {
-                    auto func_record = left_type->struct_type->methods.at("__add__");
-                    if (!this->_checkFunctionParameterType(func_record, {left_type, right_type})) {
-                        std::cerr << "Function Parameter Type Mismatch" << std::endl;
-                        exit(1);
-                    }
-                    auto returnValue = this->llvm_ir_builder.CreateCall(
-                        func_record->function, {left_value[0], right_value[0]});
-                    return {{returnValue}, func_record->return_inst};
-                }
-                else {
-                    std::cerr << "Cant Add 2 Struct" << std::endl;
-                    exit(1);
-                }
-            }
-            case token::TokenType::Dash: {
-                if (left_type->struct_type->methods.contains("__sub__")) {
-                    auto func_record = left_type->struct_type->methods.at("__sub__");
-                    if (!this->_checkFunctionParameterType(func_record, {left_type, right_type})) {
-                        std::cerr << "Function Parameter Type Mismatch" << std::endl;
-                        exit(1);
-                    }
-                    auto returnValue = this->llvm_ir_builder.CreateCall(
-                        func_record->function, {left_value[0], right_value[0]});
-                    return {{returnValue}, func_record->return_inst};
-                }
-                else {
-                    std::cerr << "Cant Sub 2 Struct" << std::endl;
-                    exit(1);
-                }
-            }
-            case token::TokenType::Asterisk: {
-                if (left_type->struct_type->methods.contains("__mul__")) {
-                    auto func_record = left_type->struct_type->methods.at("__mul__");
-                    if (!this->_checkFunctionParameterType(func_record, {left_type, right_type})) {
-                        std::cerr << "Function Parameter Type Mismatch" << std::endl;
-                        exit(1);
-                    }
-                    auto returnValue = this->llvm_ir_builder.CreateCall(
-                        func_record->function, {left_value[0], right_value[0]});
-                    return {{returnValue}, func_record->return_inst};
-                }
-                else {
-                    std::cerr << "Cant Mul 2 Struct" << std::endl;
-                    exit(1);
-                }
-            }
-            case token::TokenType::ForwardSlash: {
-                if (left_type->struct_type->methods.contains("__div__")) {
-                    auto func_record = left_type->struct_type->methods.at("__div__");
-                    if (!this->_checkFunctionParameterType(func_record, {left_type, right_type})) {
-                        std::cerr << "Function Parameter Type Mismatch" << std::endl;
-                        exit(1);
-                    }
-                    auto returnValue = this->llvm_ir_builder.CreateCall(
-                        func_record->function, {left_value[0], right_value[0]});
-                    return {{returnValue}, func_record->return_inst};
-                }
-                else {
-                    std::cerr << "Cant Divide 2 Struct" << std::endl;
-                    exit(1);
-                }
-            }
-            case token::TokenType::Percent: {
-                if (left_type->struct_type->methods.contains("__mod__")) {
-                    auto func_record = left_type->struct_type->methods.at("__mod__");
-                    if (!this->_checkFunctionParameterType(func_record, {left_type, right_type})) {
-                        std::cerr << "Function Parameter Type Mismatch" << std::endl;
-                        exit(1);
-                    }
-                    auto returnValue = this->llvm_ir_builder.CreateCall(
-                        func_record->function, {left_value[0], right_value[0]});
-                    return {{returnValue}, func_record->return_inst};
-                }
-                else {
-                    std::cerr << "Cant Modulate 2 Struct" << std::endl;
-                    exit(1);
-                }
-            }
-            case token::TokenType::EqualEqual: {
-                if (left_type->struct_type->methods.contains("__eq__")) {
-                    auto func_record = left_type->struct_type->methods.at("__eq__");
-                    if (!this->_checkFunctionParameterType(func_record, {left_type, right_type})) {
-                        std::cerr << "Function Parameter Type Mismatch" << std::endl;
-                        exit(1);
-                    }
-                    auto returnValue = this->llvm_ir_builder.CreateCall(
-                        func_record->function, {left_value[0], right_value[0]});
-                    return {{returnValue}, func_record->return_inst};
-                }
-                else {
-                    std::cerr << "Cant Compare 2 Struct" << std::endl;
-                    exit(1);
-                }
-            }
-            case token::TokenType::NotEquals: {
-                if (left_type->struct_type->methods.contains("__neq__")) {
-                    auto func_record = left_type->struct_type->methods.at("__neq__");
-                    if (!this->_checkFunctionParameterType(func_record, {left_type, right_type})) {
-                        std::cerr << "Function Parameter Type Mismatch" << std::endl;
-                        exit(1);
-                    }
-                    auto returnValue = this->llvm_ir_builder.CreateCall(
-                        func_record->function, {left_value[0], right_value[0]});
-                    return {{returnValue}, func_record->return_inst};
-                }
-                else {
-                    std::cerr << "Cant Compare 2 Struct" << std::endl;
-                    exit(1);
-                }
-            }
-            case token::TokenType::LessThan: {
-                if (left_type->struct_type->methods.contains("__lt__")) {
-                    auto func_record = left_type->struct_type->methods.at("__lt__");
-                    if (!this->_checkFunctionParameterType(func_record, {left_type, right_type})) {
-                        std::cerr << "Function Parameter Type Mismatch" << std::endl;
-                        exit(1);
-                    }
-                    auto returnValue = this->llvm_ir_builder.CreateCall(
-                        func_record->function, {left_value[0], right_value[0]});
-                    return {{returnValue}, func_record->return_inst};
-                }
-                else {
-                    std::cerr << "Cant Compare 2 Struct" << std::endl;
-                    exit(1);
-                }
-            }
-            case token::TokenType::GreaterThan: {
-                if (left_type->struct_type->methods.contains("__gt__")) {
-                    auto func_record = left_type->struct_type->methods.at("__gt__");
-                    if (!this->_checkFunctionParameterType(func_record, {left_type, right_type})) {
-                        std::cerr << "Function Parameter Type Mismatch" << std::endl;
-                        exit(1);
-                    }
-                    auto returnValue = this->llvm_ir_builder.CreateCall(
-                        func_record->function, {left_value[0], right_value[0]});
-                    return {{returnValue}, func_record->return_inst};
-                }
-                else {
-                    std::cerr << "Cant Compare 2 Struct" << std::endl;
-                    exit(1);
-                }
-            }
-            case token::TokenType::LessThanOrEqual: {
-                if (left_type->struct_type->methods.contains("__lte__")) {
-                    auto func_record = left_type->struct_type->methods.at("__lte__");
-                    if (!this->_checkFunctionParameterType(func_record, {left_type, right_type})) {
-                        std::cerr << "Function Parameter Type Mismatch" << std::endl;
-                        exit(1);
-                    }
-                    auto returnValue = this->llvm_ir_builder.CreateCall(
-                        func_record->function, {left_value[0], right_value[0]});
-                    return {{returnValue}, func_record->return_inst};
-                }
-                else {
-                    std::cerr << "Cant Compare 2 Struct" << std::endl;
-                    exit(1);
-                }
-            }
-            case token::TokenType::GreaterThanOrEqual: {
-                if (left_type->struct_type->methods.contains("__gte__")) {
-                    auto func_record = left_type->struct_type->methods.at("__gte__");
-                    if (!this->_checkFunctionParameterType(func_record, {left_type, right_type})) {
-                        std::cerr << "Function Parameter Type Mismatch" << std::endl;
-                        exit(1);
-                    }
-                    auto returnValue = this->llvm_ir_builder.CreateCall(func_record->function, {left_value[0], right_value[0]});
-                    return {{returnValue}, func_record->return_inst};
-                }
-                else {
-                    std::cerr << "Cant Compare 2 Struct" << std::endl;
-                    exit(1);
-                }
-            }
-            case token::TokenType::AsteriskAsterisk: {
-                if (left_type->struct_type->methods.contains("__pow__")) {
-                    auto func_record = left_type->struct_type->methods.at("__pow__");
-                    if (!this->_checkFunctionParameterType(func_record, {left_type, right_type})) {
-                        std::cerr << "Function Parameter Type Mismatch" << std::endl;
-                        exit(1);
-                    }
-                    auto returnValue = this->llvm_ir_builder.CreateCall(func_record->function, {left_value[0], right_value[0]});
-                    return {{returnValue}, func_record->return_inst};
-                }
-                else {
-                    std::cerr << "Cant Compare 2 Struct" << std::endl;
-                    exit(1);
-                }
-            }
-            default: {
-                std::cerr << "Unknown Operator: " << *token::tokenTypeString(op) << std::endl;
-                exit(1);
-            }
+        if (!enviornment::operator_slot_tokens.contains(op)) {
+            std::cerr << "Unknown Operator: " << *token::tokenTypeString(op) << std::endl;
+            exit(1);
+        }
+        auto func_record = left_type->struct_type->get_operator(enviornment::operator_slot_tokens.at(op));
+        if (func_record == nullptr) {
+            std::cerr << "Struct " << left_type->struct_type->name << " does not overload " << *token::tokenTypeString(op) << std::endl;
+            exit(1);
         }
+        if (!this->_checkFunctionParameterType(func_record, {left_type, right_type})) {
+            std::cerr << "Function Parameter Type Mismatch" << std::endl;
+            exit(1);
+        }
+        auto returnValue = this->_createCall(func_record, {left_val, right_val});
+        return {{returnValue}, func_record->return_inst};
     }
 
+    if (op == token::TokenType::AsteriskAsterisk) {
+        return this->_emitPower(infixed_expression, left_val, left_type, right_val, right_type);
+    }
+    // a literal takes the type of the other operand, `x + 1` keeps the width of x
+    std::tie(left_val, left_type) = this->_implicitCast(left_val, left_type, right_type, infixed_expression);
+    std::tie(right_val, right_type) = this->_implicitCast(right_val, right_type, left_type, infixed_expression);
     if(!this->_checkType(left_type, right_type)) {
         std::cerr << "Type mismatch" << std::endl;
         exit(1);
     }
+    if (left_type->struct_type == this->enviornment.get_struct("str")) {
+        if (op != token::TokenType::Plus) {
+            errors::CompletionError("Invalid operator", this->source, infixed_expression->meta_data.st_line_no, infixed_expression->meta_data.end_line_no,
+                                    "Strings only support `+`")
+                .raise();
+        }
+        return {{this->_emitStringConcat(left_val, right_val)}, left_type};
+    }
     if(left_type->struct_type->stand_alone_type->isIntegerTy() && right_type->struct_type->stand_alone_type->isIntegerTy()) {
+        // results keep the operands' width, unsigned types divide, compare and shift right without the sign
+        bool is_unsigned = left_type->struct_type->is_unsigned;
+        auto _bool = std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("bool"));
         switch (op) {
             case (token::TokenType::Plus): {
                 auto inst = this->llvm_ir_builder.CreateAdd(left_val, right_val);
-                return {{inst}, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("int"))};
+                return {{inst}, left_type};
             }
             case(token::TokenType::Dash): {
                 auto inst = this->llvm_ir_builder.CreateSub(left_val, right_val);
-                return {{inst}, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("int"))};
+                return {{inst}, left_type};
             }
             case(token::TokenType::Asterisk): {
                 auto inst = this->llvm_ir_builder.CreateMul(left_val, right_val);
-                return {{inst}, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("int"))};
+                return {{inst}, left_type};
             }
             case(token::TokenType::ForwardSlash): {
-                auto inst = this->llvm_ir_builder.CreateSDiv(left_val, right_val);
-                return {{inst}, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("int"))};
+                auto inst = is_unsigned ? this->llvm_ir_builder.CreateUDiv(left_val, right_val) : this->llvm_ir_builder.CreateSDiv(left_val, right_val);
+                return {{inst}, left_type};
             }
             case(token::TokenType::Percent): {
-                auto inst = this->llvm_ir_builder.CreateSRem(left_val, right_val);
-                return {{inst}, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("int"))};
+                auto inst = is_unsigned ? this->llvm_ir_builder.CreateURem(left_val, right_val) : this->llvm_ir_builder.CreateSRem(left_val, right_val);
+                return {{inst}, left_type};
+            }
+            case(token::TokenType::LeftShift):
+            case(token::TokenType::RightShift): {
+                // the count is taken modulo the width like the hardware does, an oversized shift is not poison
+                auto width = left_val->getType()->getIntegerBitWidth();
+                auto count = this->llvm_ir_builder.CreateAnd(right_val, llvm::ConstantInt::get(right_val->getType(), width - 1));
+                llvm::Value* inst = nullptr;
+                if (op == token::TokenType::LeftShift) {
+                    inst = this->llvm_ir_builder.CreateShl(left_val, count);
+                } else {
+                    inst = is_unsigned ? this->llvm_ir_builder.CreateLShr(left_val, count) : this->llvm_ir_builder.CreateAShr(left_val, count);
+                }
+                return {{inst}, left_type};
+            }
+            case(token::TokenType::BitwiseAnd): {
+                auto inst = this->llvm_ir_builder.CreateAnd(left_val, right_val);
+                return {{inst}, left_type};
+            }
+            case(token::TokenType::BitwiseOr): {
+                auto inst = this->llvm_ir_builder.CreateOr(left_val, right_val);
+                return {{inst}, left_type};
+            }
+            case(token::TokenType::BitwiseXor): {
+                auto inst = this->llvm_ir_builder.CreateXor(left_val, right_val);
+                return {{inst}, left_type};
             }
             case(token::TokenType::EqualEqual): {
                 auto inst = this->llvm_ir_builder.CreateICmpEQ(left_val, right_val);
-                return {{inst}, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("bool"))};
+                return {{inst}, _bool};
             }
             case(token::TokenType::NotEquals): {
                 auto inst = this->llvm_ir_builder.CreateICmpNE(left_val, right_val);
-                return {{inst}, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("bool"))};
+                return {{inst}, _bool};
             }
             case(token::TokenType::LessThan): {
-                auto inst = this->llvm_ir_builder.CreateICmpSLT(left_val, right_val);
-                return {{inst}, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("bool"))};
+                auto inst = this->llvm_ir_builder.CreateICmp(is_unsigned ? llvm::CmpInst::ICMP_ULT : llvm::CmpInst::ICMP_SLT, left_val, right_val);
+                return {{inst}, _bool};
             }
             case(token::TokenType::GreaterThan): {
-                auto inst = this->llvm_ir_builder.CreateICmpSGT(left_val, right_val);
-                return {{inst}, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("bool"))};
+                auto inst = this->llvm_ir_builder.CreateICmp(is_unsigned ? llvm::CmpInst::ICMP_UGT : llvm::CmpInst::ICMP_SGT, left_val, right_val);
+                return {{inst}, _bool};
             }
             case(token::TokenType::LessThanOrEqual): {
-                auto inst = this->llvm_ir_builder.CreateICmpSLE(left_val, right_val);
-                return {{inst}, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("bool"))};
+                auto inst = this->llvm_ir_builder.CreateICmp(is_unsigned ? llvm::CmpInst::ICMP_ULE : llvm::CmpInst::ICMP_SLE, left_val, right_val);
+                return {{inst}, _bool};
             }
             case(token::TokenType::GreaterThanOrEqual): {
-                auto inst = this->llvm_ir_builder.CreateICmpSGE(left_val, right_val);
-                return {{inst}, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("bool"))};
-            }
-            case(token::TokenType::AsteriskAsterisk): {
-                std::cerr << "Power operator not supported for int" << std::endl;
-                exit(1);
+                auto inst = this->llvm_ir_builder.CreateICmp(is_unsigned ? llvm::CmpInst::ICMP_UGE : llvm::CmpInst::ICMP_SGE, left_val, right_val);
+                return {{inst}, _bool};
             }
             default: {
                 std::cerr << "Unknown operator: " << *token::tokenTypeString(op) << std::endl;
                 exit(1);
             }
         }
-    } else if(left_type->struct_type->stand_alone_type->isDoubleTy() && right_type->struct_type->stand_alone_type->isDoubleTy()) {
+    } else if(left_type->struct_type->stand_alone_type->isFloatingPointTy() && right_type->struct_type->stand_alone_type->isFloatingPointTy()) {
+        auto _bool = std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("bool"));
         switch (op) {
             case (token::TokenType::Plus): {
                 auto inst = this->llvm_ir_builder.CreateFAdd(left_val, right_val);
-                return {{inst}, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("float"))};
+                return {{inst}, left_type};
             }
             case (token::TokenType::Dash): {
                 auto inst = this->llvm_ir_builder.CreateFSub(left_val, right_val);
-                return {{inst}, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("float"))};
+                return {{inst}, left_type};
             }
             case (token::TokenType::Asterisk): {
                 auto inst = this->llvm_ir_builder.CreateFMul(left_val, right_val);
-                return {{inst}, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("float"))};
+                return {{inst}, left_type};
             }
             case (token::TokenType::ForwardSlash): {
                 auto inst = this->llvm_ir_builder.CreateFDiv(left_val, right_val);
-                return {{inst}, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("float"))};
+                return {{inst}, left_type};
             }
             case (token::TokenType::EqualEqual): {
                 auto inst = this->llvm_ir_builder.CreateFCmpOEQ(left_val, right_val);
-                return {{inst}, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("bool"))};
+                return {{inst}, _bool};
             }
             case (token::TokenType::NotEquals): {
                 auto inst = this->llvm_ir_builder.CreateFCmpONE(left_val, right_val);
-                return {{inst}, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("bool"))};
+                return {{inst}, _bool};
             }
             case (token::TokenType::LessThan): {
                 auto inst = this->llvm_ir_builder.CreateFCmpOLT(left_val, right_val);
-                return {{inst}, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("bool"))};
+                return {{inst}, _bool};
             }
             case (token::TokenType::GreaterThan): {
                 auto inst = this->llvm_ir_builder.CreateFCmpOGT(left_val, right_val);
-                return {{inst}, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("bool"))};
+                return {{inst}, _bool};
             }
             case (token::TokenType::LessThanOrEqual): {
                 auto inst = this->llvm_ir_builder.CreateFCmpOLE(left_val, right_val);
-                return {{inst}, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("bool"))};
+                return {{inst}, _bool};
             }
             case (token::TokenType::GreaterThanOrEqual): {
                 auto inst = this->llvm_ir_builder.CreateFCmpOGE(left_val, right_val);
-                return {{inst}, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("bool"))};
-            }
-            case (token::TokenType::AsteriskAsterisk): {
-                std::cerr << "Power operator not supported for float" << std::endl;
-                exit(1);
+                return {{inst}, _bool};
             }
             default: {
                 std::cerr << "Unknown operator: " << *token::tokenTypeString(op) << std::endl;
@@ -646,6 +673,251 @@ std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::
     }
 };
 
+std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::RecordStructInstance>, std::shared_ptr<enviornment::RecordModule>>> compiler::Compiler::_visitPrefixExpression(
+    std::shared_ptr<AST::PrefixExpression> prefixed_expression) {
+    auto [constant, constant_type] = this->_resolveConstant(prefixed_expression);
+    if (constant != nullptr) {
+        return {{constant}, constant_type};
+    }
+    auto [value, _type] = this->_resolveValue(prefixed_expression->right);
+    if (value.empty() || std::get<std::shared_ptr<enviornment::RecordStructInstance>>(_type)->struct_type != this->enviornment.get_struct("bool")) {
+        errors::CompletionError("Type mismatch", this->source, prefixed_expression->meta_data.st_line_no, prefixed_expression->meta_data.end_line_no,
+                                "`not` needs a bool operand")
+            .raise();
+    }
+    return {{this->llvm_ir_builder.CreateNot(value[0])}, _type};
+}
+
+// `a and b`, `a or b`: b only runs when a does not decide the result. A cheap b that cannot trap or have side effects is
+// evaluated unconditionally and combined with a plain and/or instead, a branch on a hard to predict condition costs more.
+std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::RecordStructInstance>, std::shared_ptr<enviornment::RecordModule>>> compiler::Compiler::_emitLogical(
+    std::shared_ptr<AST::InfixExpression> infixed_expression) {
+    bool is_and = infixed_expression->op == token::TokenType::And;
+    auto _bool = this->enviornment.get_struct("bool");
+    auto operand_error = [&]() {
+        errors::CompletionError("Type mismatch", this->source, infixed_expression->meta_data.st_line_no, infixed_expression->meta_data.end_line_no,
+                                "`and` and `or` need bool operands")
+            .raise();
+    };
+    auto [left_value, _left_type] = this->_resolveValue(infixed_expression->left);
+    if (left_value.empty()) {
+        operand_error();
+    }
+    auto left_type = std::get<std::shared_ptr<enviornment::RecordStructInstance>>(_left_type);
+    if (this->_isVector(left_type)) {
+        // masks combine lane by lane, there is nothing to skip
+        auto [right_value, _right_type] = this->_resolveValue(infixed_expression->right);
+        if (right_value.empty()) {
+            operand_error();
+        }
+        return this->_emitVectorOperation(infixed_expression, left_value[0], left_type, right_value[0], std::get<std::shared_ptr<enviornment::RecordStructInstance>>(_right_type));
+    }
+    if (left_type->struct_type != _bool) {
+        operand_error();
+    }
+    if (auto constant = llvm::dyn_cast<llvm::ConstantInt>(left_value[0]); constant != nullptr && constant->isOne() != is_and) {
+        // `False and b`, `True or b`: b is never evaluated
+        return {{constant}, left_type};
+    }
+    int budget = 8;
+    if (this->_isSpeculatable(infixed_expression->right, budget)) {
+        auto [right_value, _right_type] = this->_resolveValue(infixed_expression->right);
+        if (right_value.empty() || std::get<std::shared_ptr<enviornment::RecordStructInstance>>(_right_type)->struct_type != _bool) {
+            operand_error();
+        }
+        auto inst = is_and ? this->llvm_ir_builder.CreateAnd(left_value[0], right_value[0]) : this->llvm_ir_builder.CreateOr(left_value[0], right_value[0]);
+        return {{inst}, left_type};
+    }
+    auto func = this->llvm_ir_builder.GetInsertBlock()->getParent();
+    auto LeftBB = this->llvm_ir_builder.GetInsertBlock();
+    llvm::BasicBlock* RightBB = llvm::BasicBlock::Create(llvm_context, is_and ? "and.rhs" : "or.rhs", func);
+    llvm::BasicBlock* EndBB = llvm::BasicBlock::Create(llvm_context, is_and ? "and.end" : "or.end", func);
+    if (is_and) {
+        this->llvm_ir_builder.CreateCondBr(left_value[0], RightBB, EndBB);
+    } else {
+        this->llvm_ir_builder.CreateCondBr(left_value[0], EndBB, RightBB);
+    }
+    this->llvm_ir_builder.SetInsertPoint(RightBB);
+    // checks proven while evaluating b do not hold on the path that skips it
+    auto checked_indices = this->enviornment.checked_indices;
+    auto array_min_lengths = this->enviornment.array_min_lengths;
+    auto [right_value, _right_type] = this->_resolveValue(infixed_expression->right);
+    this->enviornment.checked_indices = checked_indices;
+    this->enviornment.array_min_lengths = array_min_lengths;
+    if (right_value.empty() || std::get<std::shared_ptr<enviornment::RecordStructInstance>>(_right_type)->struct_type != _bool) {
+        operand_error();
+    }
+    auto RightEndBB = this->llvm_ir_builder.GetInsertBlock();
+    this->llvm_ir_builder.CreateBr(EndBB);
+    this->llvm_ir_builder.SetInsertPoint(EndBB);
+    auto phi = this->llvm_ir_builder.CreatePHI(this->llvm_ir_builder.getInt1Ty(), 2, is_and ? "and" : "or");
+    phi->addIncoming(this->llvm_ir_builder.getInt1(!is_and), LeftBB);
+    phi->addIncoming(right_value[0], RightEndBB);
+    return {{phi}, left_type};
+}
+
+// True when `node` is a small expression over scalar variables that can run even when its result is not needed: no
+// calls, indexing, division or operator overloads. Every variable and operator spends one unit of `budget`.
+bool compiler::Compiler::_isSpeculatable(std::shared_ptr<AST::Node> node, int& budget) {
+    if (--budget < 0) {
+        return false;
+    }
+    auto is_scalar = [](std::shared_ptr<enviornment::RecordStructInstance> type) {
+        auto llvm_type = type->struct_type->stand_alone_type;
+        return llvm_type != nullptr && (llvm_type->isIntegerTy() || llvm_type->isFloatingPointTy());
+    };
+    switch (node->type()) {
+    case AST::NodeType::IntegerLiteral:
+    case AST::NodeType::FloatLiteral:
+    case AST::NodeType::BooleanLiteral:
+        return true;
+    case AST::NodeType::IdentifierLiteral: {
+        auto name = std::static_pointer_cast<AST::IdentifierLiteral>(node)->value;
+        return this->enviornment.is_variable(name) && !this->enviornment.get_variable(name)->is_volatile && is_scalar(this->enviornment.get_variable(name)->variableType);
+    }
+    case AST::NodeType::PrefixedExpression:
+        return this->_isSpeculatable(std::static_pointer_cast<AST::PrefixExpression>(node)->right, budget);
+    case AST::NodeType::InfixedExpression: {
+        auto infix = std::static_pointer_cast<AST::InfixExpression>(node);
+        switch (infix->op) {
+        case token::TokenType::ForwardSlash:
+        case token::TokenType::Percent:
+        case token::TokenType::AsteriskAsterisk:
+            return false;
+        case token::TokenType::Dot: {
+            // a scalar field of a struct variable is a load from memory the variable owns
+            if (infix->left->type() != AST::NodeType::IdentifierLiteral || infix->right->type() != AST::NodeType::IdentifierLiteral) {
+                return false;
+            }
+            auto name = std::static_pointer_cast<AST::IdentifierLiteral>(infix->left)->value;
+            auto field = std::static_pointer_cast<AST::IdentifierLiteral>(infix->right)->value;
+            if (!this->enviornment.is_variable(name) || this->enviornment.get_variable(name)->is_volatile) {
+                return false;
+            }
+            auto struct_type = this->enviornment.get_variable(name)->variableType->struct_type;
+            return struct_type->struct_type != nullptr && struct_type->sub_types.contains(field) && is_scalar(struct_type->sub_types[field]);
+        }
+        default:
+            return this->_isSpeculatable(infix->left, budget) && this->_isSpeculatable(infix->right, budget);
+        }
+    }
+    default:
+        return false;
+    }
+}
+
+// `**` on numbers. An integer base needs an integer exponent and is raised by squaring, a float base takes llvm.powi for
+// integer exponents of up to 32 bits and llvm.pow otherwise. Constant integer exponents up to 64 become plain multiplies.
+// A negative integer exponent of an integer base truncates 1 / x ** n: 1 for x == 1, +-1 for x == -1 and 0 for everything else.
+std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::RecordStructInstance>, std::shared_ptr<enviornment::RecordModule>>> compiler::Compiler::_emitPower(
+    std::shared_ptr<AST::InfixExpression> infixed_expression, llvm::Value* base, std::shared_ptr<enviornment::RecordStructInstance> base_type, llvm::Value* exponent,
+    std::shared_ptr<enviornment::RecordStructInstance> exponent_type) {
+    auto type = base->getType();
+    if (base_type->struct_type->stand_alone_type == nullptr || exponent_type->struct_type->stand_alone_type == nullptr || !(type->isIntegerTy() || type->isFloatingPointTy()) ||
+        type->isIntegerTy(1) || base_type->struct_type == this->enviornment.get_struct("char")) {
+        errors::CompletionError("Invalid operator", this->source, infixed_expression->meta_data.st_line_no, infixed_expression->meta_data.end_line_no,
+                                "`**` needs a number on the left, or a struct that defines __pow__")
+            .raise();
+    }
+    if (exponent->getType()->isFloatingPointTy() && type->isFloatingPointTy()) {
+        std::tie(exponent, exponent_type) = this->_implicitCast(exponent, exponent_type, base_type, infixed_expression);
+        if (!this->_checkType(base_type, exponent_type)) {
+            errors::CompletionError("Type mismatch", this->source, infixed_expression->meta_data.st_line_no, infixed_expression->meta_data.end_line_no,
+                                    "The base and a float exponent must have the same type, use an explicit cast")
+                .raise();
+        }
+        return {{this->llvm_ir_builder.CreateBinaryIntrinsic(llvm::Intrinsic::pow, base, exponent)}, base_type};
+    }
+    if (!exponent->getType()->isIntegerTy() || exponent->getType()->isIntegerTy(1) || exponent_type->struct_type == this->enviornment.get_struct("char")) {
+        errors::CompletionError("Type mismatch", this->source, infixed_expression->meta_data.st_line_no, infixed_expression->meta_data.end_line_no,
+                                type->isIntegerTy() ? "An integer base needs an integer exponent, cast the base to float" : "The exponent must be a number")
+            .raise();
+    }
+    bool is_float = type->isFloatingPointTy();
+    bool signed_exponent = !exponent_type->struct_type->is_unsigned;
+    auto multiply = [&](llvm::Value* a, llvm::Value* b) { return is_float ? this->llvm_ir_builder.CreateFMul(a, b) : this->llvm_ir_builder.CreateMul(a, b); };
+    auto one = is_float ? llvm::ConstantFP::get(type, 1.0) : llvm::ConstantInt::get(type, 1);
+    auto reciprocal = [&](llvm::Value* odd) -> llvm::Value* {
+        // truncated 1 / x ** n for a negative n, only 1 and -1 do not round to 0
+        llvm::Value* unit = this->llvm_ir_builder.CreateICmpEQ(base, one);
+        if (!base_type->struct_type->is_unsigned) {
+            unit = this->llvm_ir_builder.CreateOr(unit, this->llvm_ir_builder.CreateICmpEQ(base, llvm::ConstantInt::getSigned(type, -1)));
+        }
+        return this->llvm_ir_builder.CreateSelect(unit, this->llvm_ir_builder.CreateSelect(odd, base, one), llvm::ConstantInt::get(type, 0));
+    };
+
+    if (auto constant = llvm::dyn_cast<llvm::ConstantInt>(exponent)) {
+        auto value = constant->getValue();
+        bool negative = signed_exponent && value.isNegative();
+        auto magnitude = negative ? value.abs() : value;
+        if (magnitude.ule(64)) {
+            // square-and-multiply unrolled at compile time, x ** 5 is x * (x * x) * (x * x)
+            llvm::Value* result = nullptr;
+            llvm::Value* square = base;
+            for (uint64_t bits = magnitude.getZExtValue(); bits != 0; bits >>= 1) {
+                if (bits & 1) {
+                    result = result ? multiply(result, square) : square;
+                }
+                if (bits > 1) {
+                    square = multiply(square, square);
+                }
+            }
+            result = result ? result : one;
+            if (negative) {
+                if (is_float) {
+                    result = this->llvm_ir_builder.CreateFDiv(one, result);
+                } else {
+                    result = reciprocal(this->llvm_ir_builder.getInt1(value[0]));
+                }
+            }
+            return {{result}, base_type};
+        }
+    }
+
+    if (is_float) {
+        auto width = exponent->getType()->getIntegerBitWidth();
+        if (width < 32 || (width == 32 && signed_exponent)) {
+            auto i32 = this->llvm_ir_builder.getInt32Ty();
+            auto count = signed_exponent ? this->llvm_ir_builder.CreateSExt(exponent, i32) : this->llvm_ir_builder.CreateZExt(exponent, i32);
+            return {{this->llvm_ir_builder.CreateIntrinsic(llvm::Intrinsic::powi, {type, i32}, {base, count})}, base_type};
+        }
+        // powi only takes 32 bit exponents, truncating a wider one would change the result
+        auto power = signed_exponent ? this->llvm_ir_builder.CreateSIToFP(exponent, type) : this->llvm_ir_builder.CreateUIToFP(exponent, type);
+        return {{this->llvm_ir_builder.CreateBinaryIntrinsic(llvm::Intrinsic::pow, base, power)}, base_type};
+    }
+
+    // Exponentiation by squaring: one multiply per exponent bit plus one per set bit, the loop runs at most width times
+    auto func = this->llvm_ir_builder.GetInsertBlock()->getParent();
+    auto zero = llvm::ConstantInt::get(exponent->getType(), 0);
+    auto negative = signed_exponent ? this->llvm_ir_builder.CreateICmpSLT(exponent, zero) : nullptr;
+    auto count = signed_exponent ? this->llvm_ir_builder.CreateSelect(negative, zero, exponent) : exponent;
+    auto PreheaderBB = this->llvm_ir_builder.GetInsertBlock();
+    llvm::BasicBlock* LoopBB = llvm::BasicBlock::Create(llvm_context, "pow.loop", func);
+    llvm::BasicBlock* BodyBB = llvm::BasicBlock::Create(llvm_context, "pow.body", func);
+    llvm::BasicBlock* EndBB = llvm::BasicBlock::Create(llvm_context, "pow.end", func);
+    this->llvm_ir_builder.CreateBr(LoopBB);
+    this->llvm_ir_builder.SetInsertPoint(LoopBB);
+    auto result = this->llvm_ir_builder.CreatePHI(type, 2, "pow.result");
+    auto square = this->llvm_ir_builder.CreatePHI(type, 2, "pow.square");
+    auto bits = this->llvm_ir_builder.CreatePHI(exponent->getType(), 2, "pow.bits");
+    result->addIncoming(one, PreheaderBB);
+    square->addIncoming(base, PreheaderBB);
+    bits->addIncoming(count, PreheaderBB);
+    this->llvm_ir_builder.CreateCondBr(this->llvm_ir_builder.CreateICmpNE(bits, zero), BodyBB, EndBB);
+    this->llvm_ir_builder.SetInsertPoint(BodyBB);
+    auto odd = this->llvm_ir_builder.CreateTrunc(bits, this->llvm_ir_builder.getInt1Ty());
+    result->addIncoming(this->llvm_ir_builder.CreateSelect(odd, multiply(result, square), result), BodyBB);
+    square->addIncoming(multiply(square, square), BodyBB);
+    bits->addIncoming(this->llvm_ir_builder.CreateLShr(bits, 1), BodyBB);
+    this->llvm_ir_builder.CreateBr(LoopBB);
+    this->llvm_ir_builder.SetInsertPoint(EndBB);
+    llvm::Value* power = result;
+    if (signed_exponent) {
+        power = this->llvm_ir_builder.CreateSelect(negative, reciprocal(this->llvm_ir_builder.CreateTrunc(exponent, this->llvm_ir_builder.getInt1Ty())), result);
+    }
+    return {{power}, base_type};
+}
+
 std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::RecordStructInstance>, std::shared_ptr<enviornment::RecordModule>>> compiler::Compiler::_visitIndexExpression(std::shared_ptr<AST::IndexExpression> index_expression) {
     auto [left, _left_generic] = this->_resolveValue(index_expression->left);
     if (left.empty()) {
@@ -659,6 +931,38 @@ std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::
         exit(1);
     }
     auto index_generic = std::get<std::shared_ptr<enviornment::RecordStructInstance>>(_index_generic);
+    if (left_generic->struct_type == this->enviornment.get_struct("str")) {
+        if (index_expression->end == nullptr) {
+            errors::CompletionError("Invalid index", this->source, index_expression->meta_data.st_line_no, index_expression->meta_data.end_line_no,
+                                    "Strings can only be sliced, use s[start:end]")
+                .raise();
+        }
+        auto [end, _end_generic] = this->_resolveValue(index_expression->end);
+        if (end.empty() || !this->_checkType(index_generic, this->enviornment.get_struct("int")) ||
+            !this->_checkType(std::get<std::shared_ptr<enviornment::RecordStructInstance>>(_end_generic), this->enviornment.get_struct("int"))) {
+            std::cerr << "Error: Slice bounds must be int" << std::endl;
+            exit(1);
+        }
+        return {{this->_emitStringSlice(left[0], index[0], end[0])}, left_generic};
+    }
+    if (this->_isVector(left_generic)) {
+        if (index_expression->end != nullptr || !this->_checkType(index_generic, this->enviornment.get_struct("int"))) {
+            errors::CompletionError("Invalid index", this->source, index_expression->meta_data.st_line_no, index_expression->meta_data.end_line_no,
+                                    "Vector lanes are read with v[lane], lane being an int")
+                .raise();
+        }
+        auto lanes = this->llvm_ir_builder.getInt64(llvm::cast<llvm::FixedVectorType>(left[0]->getType())->getNumElements());
+        if (auto constant_index = llvm::dyn_cast<llvm::ConstantInt>(index[0])) {
+            if (constant_index->getValue().uge(lanes->getValue())) {
+                errors::CompletionError("Invalid index", this->source, index_expression->meta_data.st_line_no, index_expression->meta_data.end_line_no,
+                                        "Lane " + std::to_string(constant_index->getSExtValue()) + " is out of range")
+                    .raise();
+            }
+        } else if (this->bounds_checks) {
+            this->_emitBoundsBranch(this->llvm_ir_builder.CreateICmpULT(index[0], lanes, "inbounds"), index[0], lanes);
+        }
+        return {{this->llvm_ir_builder.CreateExtractElement(left[0], index[0], "lane")}, left_generic->struct_type->generic_arguments[0]};
+    }
     if(!this->_checkType(left_generic, this->enviornment.get_struct("array"))) {
         std::cerr << "Error: Left type is not an array. Left type: " << left_generic->struct_type->name << std::endl;
         exit(1);
@@ -667,64 +971,89 @@ std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::
         std::cerr << "Error: Index type is not an int. Index type: " << index_generic->struct_type->name << std::endl;
         exit(1);
     }
-    auto element = this->llvm_ir_builder.CreateGEP(left_generic->generic[0]->struct_type->stand_alone_type ? left_generic->generic[0]->struct_type->stand_alone_type : left_generic->generic[0]->struct_type->struct_type, left[0], index[0], "element");
+    if (left_generic->generic.empty()) {
+        std::cerr << "Error: Element type of the array is not known, declare it as array[T]" << std::endl;
+        exit(1);
+    }
+    auto element_type = left_generic->generic[0]->struct_type->stand_alone_type ? left_generic->generic[0]->struct_type->stand_alone_type : left_generic->generic[0]->struct_type->struct_type;
+    if (index_expression->end != nullptr) {
+        auto [end, _end_generic] = this->_resolveValue(index_expression->end);
+        if (end.empty() || !this->_checkType(std::get<std::shared_ptr<enviornment::RecordStructInstance>>(_end_generic), this->enviornment.get_struct("int"))) {
+            std::cerr << "Error: Slice end must be an int" << std::endl;
+            exit(1);
+        }
+        auto slice = this->llvm_ir_builder.CreateCall(this->llvm_module->getFunction("gigly_array_slice"), {left[0], llvm::ConstantExpr::getSizeOf(element_type), index[0], end[0]}, "slice");
+        return {{this->_gcRootTemp(slice, left_generic)}, left_generic};
+    }
+    this->_emitBoundsCheck(left[0], index[0], index_expression);
+    auto element = this->llvm_ir_builder.CreateInBoundsGEP(element_type, this->_arrayData(left[0]), index[0], "element");
     auto load = left_generic->generic[0]->struct_type->stand_alone_type ? this->llvm_ir_builder.CreateLoad(left_generic->generic[0]->struct_type->stand_alone_type, element) : element;
     return {{load}, left_generic->generic[0]};
 };
 
 void compiler::Compiler::_visitVariableDeclarationStatement(std::shared_ptr<AST::VariableDeclarationStatement> variable_declaration_statement) {
-    std::cerr << "Entering _visitVariableDeclarationStatement" << std::endl;
     auto var_name = std::static_pointer_cast<AST::IdentifierLiteral>(variable_declaration_statement->name);
-    std::cerr << "Variable name: " << var_name->value << std::endl;
+    GIGLY_TRACE(Codegen, Debug, "Declaring variable " << var_name->value);
     auto var_value = variable_declaration_statement->value;
-    std::cerr << "Resolving variable type" << std::endl;
-    if(!this->enviornment.is_struct(std::static_pointer_cast<AST::IdentifierLiteral>(variable_declaration_statement->value_type->name)->value)) {
-        std::cerr << "Variable type not defined" << std::endl;
-        exit(1);
-    }
-    auto var_type = this->enviornment.get_struct(std::static_pointer_cast<AST::IdentifierLiteral>(variable_declaration_statement->value_type->name)->value);
-    std::cerr << "Variable type: " << var_type->name << std::endl;
+    auto var_type_inst = this->_parseType(variable_declaration_statement->value_type);
+    auto var_type = var_type_inst->struct_type;
+    GIGLY_TRACE(Codegen, Trace, "Variable " << var_name->value << " has type " << var_type->name);
     auto [var_value_resolved, _var_generic] = this->_resolveValue(var_value);
-    std::cerr << "Resolved variable value" << std::endl;
     if (var_value_resolved.empty()) {
         std::cerr << "Cant Assign Modult to Variable" << std::endl;
         exit(1);
     }
     auto var_generic = std::get<std::shared_ptr<enviornment::RecordStructInstance>>(_var_generic);
-    if (!this->_checkType(var_generic, this->_parseType(variable_declaration_statement->value_type))) {
+    std::tie(var_value_resolved[0], var_generic) = this->_implicitCast(var_value_resolved[0], var_generic, var_type_inst, variable_declaration_statement);
+    if (!this->_checkType(var_generic, var_type_inst)) {
         std::cerr << "Cannot assign missmatch type" << std::endl;
         exit(1);
     }
+    if (var_generic->generic.empty() && !var_type_inst->generic.empty()) {
+        // `[]` has no elements to infer from, the declared type supplies them
+        var_generic = var_type_inst;
+    }
+    this->_invalidateBoundsFacts(variable_declaration_statement);
+    this->_recordArrayLength(var_name->value, var_value);
     if(var_value_resolved.size() == 1) {
         if (var_type->struct_type == nullptr) {
-            std::cerr << "Allocating standalone type" << std::endl;
-            auto alloca = this->llvm_ir_builder.CreateAlloca(var_type->stand_alone_type);
+            GIGLY_TRACE(Codegen, Trace, "Allocating standalone type for " << var_name->value);
+            auto alloca = this->_createEntryBlockAlloca(var_type->stand_alone_type);
+            this->_gcRoot(alloca, var_generic);
             auto store = this->llvm_ir_builder.CreateStore(var_value_resolved[0], alloca, variable_declaration_statement->is_volatile);
             auto var =
                 std::make_shared<enviornment::RecordVariable>(var_name->value, var_value_resolved[0], alloca, var_generic);
+            var->is_volatile = variable_declaration_statement->is_volatile;
             this->enviornment.add(var);
         }
         else {
-            std::cerr << "Allocating struct type" << std::endl;
-            auto alloca = this->llvm_ir_builder.CreateAlloca(var_type->struct_type, nullptr);
-            if (var_type->struct_type->isPointerTy()) {
-                std::cerr << "Loading pointer type" << std::endl;
-                auto load = this->llvm_ir_builder.CreateLoad(var_type->struct_type, var_value_resolved[0]);
-                auto store = this->llvm_ir_builder.CreateStore(load, alloca, variable_declaration_statement->is_volatile);
+            GIGLY_TRACE(Codegen, Trace, "Allocating struct type for " << var_name->value);
+            llvm::Value* alloca = nullptr;
+            if (llvm::isa<llvm::AllocaInst>(var_value_resolved[0]) && var_value->type() != AST::NodeType::IdentifierLiteral && !variable_declaration_statement->is_volatile) {
+                // constructors and sret calls already produced a fresh temporary, the variable takes it over
+                alloca = var_value_resolved[0];
+            } else if (var_value_resolved[0]->getType()->isPointerTy()) {
+                alloca = this->_createEntryBlockAlloca(var_type->struct_type, nullptr);
+                this->_gcRoot(alloca, var_generic);
+                GIGLY_TRACE(Codegen, Trace, "Copying pointer type into " << var_name->value);
+                this->llvm_ir_builder.CreateMemCpy(alloca, llvm::MaybeAlign(), var_value_resolved[0], llvm::MaybeAlign(), llvm::ConstantExpr::getSizeOf(var_type->struct_type),
+                                                   variable_declaration_statement->is_volatile);
             } else {
-                std::cerr << "Storing non-pointer type" << std::endl;
+                GIGLY_TRACE(Codegen, Trace, "Storing non-pointer type into " << var_name->value);
+                alloca = this->_createEntryBlockAlloca(var_type->struct_type, nullptr);
+                this->_gcRoot(alloca, var_generic);
                 auto store = this->llvm_ir_builder.CreateStore(var_value_resolved[0], alloca, variable_declaration_statement->is_volatile);
             }
             auto var =
                 std::make_shared<enviornment::RecordVariable>(var_name->value, var_value_resolved[0], alloca, var_generic);
             var->variableType = var_generic;
+            var->is_volatile = variable_declaration_statement->is_volatile;
             this->enviornment.add(var);
         }
     } else {
         std::cerr << "Variable declaration with multiple values" << std::endl;
         exit(1);
     }
-    std::cerr << "Exiting _visitVariableDeclarationStatement" << std::endl;
 }
 
 std::vector<std::string> splitString(const std::string& input) {
@@ -741,6 +1070,49 @@ std::vector<std::string> splitString(const std::string& input) {
 }
 
 void compiler::Compiler::_visitVariableAssignmentStatement(std::shared_ptr<AST::VariableAssignmentStatement> variable_assignment_statement) {
+    if (variable_assignment_statement->is_compound) {
+        // `x op= e`: the address is computed once, then load, op and store through it. e goes first, a call in it may grow the array being indexed
+        auto infix = std::static_pointer_cast<AST::InfixExpression>(variable_assignment_statement->value);
+        auto [right, _right_type] = this->_resolveValue(infix->right);
+        if (right.size() != 1) {
+            std::cerr << "Infix Expression Value Error" << std::endl;
+            exit(1);
+        }
+        auto [address, target_type, is_volatile] = this->_resolveAddress(variable_assignment_statement->name);
+        auto stand_alone_type = target_type->struct_type->stand_alone_type;
+        llvm::Value* current = stand_alone_type ? this->llvm_ir_builder.CreateLoad(stand_alone_type, address, is_volatile) : address;
+        auto [result, _result_type] = this->_emitInfixOperation(infix, current, target_type, right[0], std::get<std::shared_ptr<enviornment::RecordStructInstance>>(_right_type));
+        auto result_type = std::get<std::shared_ptr<enviornment::RecordStructInstance>>(_result_type);
+        if (!this->_checkType(result_type, target_type)) {
+            std::cerr << "Cannot assign missmatch type" << std::endl;
+            exit(1);
+        }
+        if (variable_assignment_statement->name->type() == AST::NodeType::IdentifierLiteral) {
+            // element and field stores never change the length of an array variable
+            this->_invalidateBoundsFacts(variable_assignment_statement);
+        }
+        this->_checkArenaEscape(variable_assignment_statement->name, target_type, variable_assignment_statement);
+        this->_emitStore(address, target_type, result[0], is_volatile);
+        return;
+    }
+    if (variable_assignment_statement->name->type() != AST::NodeType::IdentifierLiteral) {
+        // `s.field = e`, `a[i] = e`: one store into the field or element, the rest of the aggregate is left alone
+        auto [value, _value_type] = this->_resolveValue(variable_assignment_statement->value);
+        if (value.size() != 1) {
+            std::cerr << "Cant Assign Modult to Variable" << std::endl;
+            exit(1);
+        }
+        auto value_type = std::get<std::shared_ptr<enviornment::RecordStructInstance>>(_value_type);
+        auto [address, target_type, is_volatile] = this->_resolveAddress(variable_assignment_statement->name);
+        std::tie(value[0], value_type) = this->_implicitCast(value[0], value_type, target_type, variable_assignment_statement);
+        if (!this->_checkType(value_type, target_type)) {
+            std::cerr << "Cannot assign missmatch type" << std::endl;
+            exit(1);
+        }
+        this->_checkArenaEscape(variable_assignment_statement->name, target_type, variable_assignment_statement);
+        this->_emitStore(address, target_type, value[0], is_volatile);
+        return;
+    }
     auto var_name = std::static_pointer_cast<AST::IdentifierLiteral>(variable_assignment_statement->name);
     auto var_value = variable_assignment_statement->value;
     auto [value, _assignmentType] = this->_resolveValue(var_value);
@@ -760,17 +1132,20 @@ void compiler::Compiler::_visitVariableAssignmentStatement(std::shared_ptr<AST::
             return;
         }
         currentStructType = this->enviornment.get_variable(name)->variableType;
+        std::tie(value[0], assignmentType) = this->_implicitCast(value[0], assignmentType, currentStructType, variable_assignment_statement);
         if (!this->_checkType(assignmentType, currentStructType)) {
             std::cerr << "Cannot assign missmatch type" << std::endl;
             exit(1);
         }
+        this->_checkArenaEscape(var_name, currentStructType, variable_assignment_statement);
         alloca = this->enviornment.get_variable(name)->allocainst;
-        if(value.size() == 1) {
-            auto storeInst = this->llvm_ir_builder.CreateStore(value[0], alloca);
-        } else {
+        this->_invalidateBoundsFacts(variable_assignment_statement);
+        this->_recordArrayLength(name, var_value);
+        if(value.size() != 1) {
             std::cerr << "Variable assignment with multiple values" << value.size() << std::endl;
             exit(1);
         }
+        this->_emitStore(alloca, currentStructType, value[0], this->enviornment.get_variable(name)->is_volatile);
     } else {
         errors::CompletionError("Variable not defined", this->source, var_name->meta_data.st_line_no, var_name->meta_data.end_line_no,
                                 "Variable `" + var_name->value + "` not defined")
@@ -778,31 +1153,103 @@ void compiler::Compiler::_visitVariableAssignmentStatement(std::shared_ptr<AST::
     }
 };
 
-std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::RecordStructInstance>, std::shared_ptr<enviornment::RecordModule>>> compiler::Compiler::_resolveValue(
-    std::shared_ptr<AST::Node> node) {
-    switch(node->type()) {
-    case AST::NodeType::IntegerLiteral: {
-        auto integer_literal = std::static_pointer_cast<AST::IntegerLiteral>(node);
-        auto value = llvm::ConstantInt::get(llvm_context, llvm::APInt(64, integer_literal->value));
-        return {{value}, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("int"))};
+// Scalars are stored, structs are copied into the target's memory
+void compiler::Compiler::_emitStore(llvm::Value* address, std::shared_ptr<enviornment::RecordStructInstance> type, llvm::Value* value, bool is_volatile) {
+    if (type->struct_type->stand_alone_type == nullptr && value->getType()->isPointerTy()) {
+        this->llvm_ir_builder.CreateMemCpy(address, llvm::MaybeAlign(), value, llvm::MaybeAlign(), llvm::ConstantExpr::getSizeOf(type->struct_type->struct_type), is_volatile);
+    } else {
+        this->llvm_ir_builder.CreateStore(value, address, is_volatile);
     }
-    case AST::NodeType::FloatLiteral: {
-        auto float_literal = std::static_pointer_cast<AST::FloatLiteral>(node);
-        auto value = llvm::ConstantFP::get(llvm_context, llvm::APFloat(float_literal->value));
-        return {{value}, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("float"))};
+};
+
+// Address of an assignment target (variable, struct field or array element) and whether it is volatile
+std::tuple<llvm::Value*, std::shared_ptr<enviornment::RecordStructInstance>, bool> compiler::Compiler::_resolveAddress(std::shared_ptr<AST::Expression> node) {
+    switch (node->type()) {
+    case AST::NodeType::IdentifierLiteral: {
+        auto identifier = std::static_pointer_cast<AST::IdentifierLiteral>(node);
+        if (!this->enviornment.is_variable(identifier->value)) {
+            errors::CompletionError("Variable not defined", this->source, identifier->meta_data.st_line_no, identifier->meta_data.end_line_no,
+                                    "Variable `" + identifier->value + "` not defined")
+                .raise();
+        }
+        auto variable = this->enviornment.get_variable(identifier->value);
+        return {variable->allocainst, variable->variableType, variable->is_volatile};
     }
-    case AST::NodeType::StringLiteral: {
-        auto string_literal = std::static_pointer_cast<AST::StringLiteral>(node);
-        auto value = this->llvm_ir_builder.CreateGlobalStringPtr(string_literal->value);
-        return {{value}, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("str"))};
+    case AST::NodeType::InfixedExpression: {
+        auto infix = std::static_pointer_cast<AST::InfixExpression>(node);
+        if (infix->op != token::TokenType::Dot || infix->right->type() != AST::NodeType::IdentifierLiteral) {
+            break;
+        }
+        auto field = std::static_pointer_cast<AST::IdentifierLiteral>(infix->right)->value;
+        auto [base, base_type, is_volatile] = this->_resolveAddress(infix->left);
+        auto struct_record = base_type->struct_type;
+        if (struct_record->struct_type == nullptr || !struct_record->sub_types.contains(field)) {
+            std::cerr << "Struct does not have member " + field << std::endl;
+            exit(1);
+        }
+        unsigned idx = std::find(struct_record->fields.begin(), struct_record->fields.end(), field) - struct_record->fields.begin();
+        return {this->llvm_ir_builder.CreateStructGEP(struct_record->struct_type, base, idx), struct_record->sub_types[field], is_volatile};
     }
-    case AST::NodeType::IdentifierLiteral: {
-        auto identifier_literal = std::static_pointer_cast<AST::IdentifierLiteral>(node);
-        std::shared_ptr<enviornment::RecordStructInstance> currentStructType = nullptr;
-        if (this->enviornment.is_variable(identifier_literal->value)) {
+    case AST::NodeType::IndexExpression: {
+        auto index_expression = std::static_pointer_cast<AST::IndexExpression>(node);
+        if (index_expression->end != nullptr) {
+            break;
+        }
+        auto [array, _array_type] = this->_resolveValue(index_expression->left);
+        auto [index, _index_type] = this->_resolveValue(index_expression->index);
+        if (array.empty() || index.empty()) {
+            std::cerr << "Cant index Module" << std::endl;
+            exit(1);
+        }
+        auto array_type = std::get<std::shared_ptr<enviornment::RecordStructInstance>>(_array_type);
+        if (!this->_checkType(array_type, this->enviornment.get_struct("array")) || array_type->generic.empty()) {
+            errors::CompletionError("Invalid assignment", this->source, index_expression->meta_data.st_line_no, index_expression->meta_data.end_line_no,
+                                    "Only elements of arrays with a known element type can be assigned")
+                .raise();
+        }
+        if (!this->_checkType(std::get<std::shared_ptr<enviornment::RecordStructInstance>>(_index_type), this->enviornment.get_struct("int"))) {
+            std::cerr << "Error: Index type is not an int" << std::endl;
+            exit(1);
+        }
+        auto element_record = array_type->generic[0]->struct_type;
+        auto element_type = element_record->stand_alone_type ? element_record->stand_alone_type : element_record->struct_type;
+        this->_emitBoundsCheck(array[0], index[0], index_expression);
+        return {this->llvm_ir_builder.CreateInBoundsGEP(element_type, this->_arrayData(array[0]), index[0], "element"), array_type->generic[0], false};
+    }
+    default:
+        break;
+    }
+    errors::CompletionError("Invalid assignment", this->source, node->meta_data.st_line_no, node->meta_data.end_line_no,
+                            "Only variables, struct fields and array elements can be assigned")
+        .raise();
+    return {nullptr, nullptr, false};
+};
+
+std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::RecordStructInstance>, std::shared_ptr<enviornment::RecordModule>>> compiler::Compiler::_resolveValue(
+    std::shared_ptr<AST::Node> node) {
+    switch(node->type()) {
+    case AST::NodeType::IntegerLiteral: {
+        auto integer_literal = std::static_pointer_cast<AST::IntegerLiteral>(node);
+        auto value = llvm::ConstantInt::get(llvm_context, llvm::APInt(64, integer_literal->value));
+        return {{value}, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct(integer_literal->is_unsigned ? "u64" : "int"))};
+    }
+    case AST::NodeType::FloatLiteral: {
+        auto float_literal = std::static_pointer_cast<AST::FloatLiteral>(node);
+        auto value = llvm::ConstantFP::get(llvm_context, llvm::APFloat(float_literal->value));
+        return {{value}, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("float"))};
+    }
+    case AST::NodeType::StringLiteral: {
+        auto string_literal = std::static_pointer_cast<AST::StringLiteral>(node);
+        return {{this->_stringLiteral(string_literal->value)}, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("str"))};
+    }
+    case AST::NodeType::IdentifierLiteral: {
+        auto identifier_literal = std::static_pointer_cast<AST::IdentifierLiteral>(node);
+        std::shared_ptr<enviornment::RecordStructInstance> currentStructType = nullptr;
+        if (this->enviornment.is_variable(identifier_literal->value)) {
             currentStructType = this->enviornment.get_variable(identifier_literal->value)->variableType;
             if (currentStructType->struct_type->stand_alone_type) {
-                auto loadInst = this->llvm_ir_builder.CreateLoad(currentStructType->struct_type->stand_alone_type, this->enviornment.get_variable(identifier_literal->value)->allocainst);
+                auto variable = this->enviornment.get_variable(identifier_literal->value);
+                auto loadInst = this->llvm_ir_builder.CreateLoad(currentStructType->struct_type->stand_alone_type, variable->allocainst, variable->is_volatile);
                 return {{loadInst}, currentStructType};
             }
             else {
@@ -818,6 +1265,9 @@ std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::
     case AST::NodeType::InfixedExpression: {
         return this->_visitInfixExpression(std::static_pointer_cast<AST::InfixExpression>(node));
     }
+    case AST::NodeType::PrefixedExpression: {
+        return this->_visitPrefixExpression(std::static_pointer_cast<AST::PrefixExpression>(node));
+    }
     case AST::NodeType::IndexExpression: {
         return this->_visitIndexExpression(std::static_pointer_cast<AST::IndexExpression>(node));
     }
@@ -826,10 +1276,7 @@ std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::
     }
     case AST::NodeType::BooleanLiteral: {
         auto boolean_literal = std::static_pointer_cast<AST::BooleanLiteral>(node);
-        auto value = boolean_literal->value ? this->enviornment.get_variable("True")->value : this->enviornment.get_variable("False")->value;
-        if (llvm::isa<llvm::Instruction>(value)) {
-        }
-        return {{value}, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("bool"))};
+        return {{this->llvm_ir_builder.getInt1(boolean_literal->value)}, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("bool"))};
     }
     case AST::NodeType::ArrayLiteral: {
         return this->_visitArrayLiteral(std::static_pointer_cast<AST::ArrayLiteral>(node));
@@ -842,13 +1289,216 @@ std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::
     }
 };
 
+// Evaluates `node` at compile time. Returns {nullptr, nullptr} when the node is not a constant expression,
+// in which case the caller falls back to emitting instructions.
+std::tuple<llvm::Constant*, std::shared_ptr<enviornment::RecordStructInstance>> compiler::Compiler::_resolveConstant(std::shared_ptr<AST::Node> node) {
+    switch(node->type()) {
+    case AST::NodeType::IntegerLiteral: {
+        auto integer_literal = std::static_pointer_cast<AST::IntegerLiteral>(node);
+        // literals above INT64_MAX only fit u64 and take that type
+        return {llvm::ConstantInt::get(llvm_context, llvm::APInt(64, integer_literal->value)),
+                std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct(integer_literal->is_unsigned ? "u64" : "int"))};
+    }
+    case AST::NodeType::FloatLiteral: {
+        auto float_literal = std::static_pointer_cast<AST::FloatLiteral>(node);
+        return {llvm::ConstantFP::get(llvm_context, llvm::APFloat(float_literal->value)),
+                std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("float"))};
+    }
+    case AST::NodeType::BooleanLiteral: {
+        auto boolean_literal = std::static_pointer_cast<AST::BooleanLiteral>(node);
+        return {llvm::ConstantInt::getBool(llvm_context, boolean_literal->value),
+                std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("bool"))};
+    }
+    case AST::NodeType::InfixedExpression: {
+        auto infix_expression = std::static_pointer_cast<AST::InfixExpression>(node);
+        if (infix_expression->op == token::TokenType::Dot) {
+            return {nullptr, nullptr};
+        }
+        auto [left, left_type] = this->_resolveConstant(infix_expression->left);
+        if (left == nullptr) {
+            return {nullptr, nullptr};
+        }
+        auto [right, right_type] = this->_resolveConstant(infix_expression->right);
+        if (right == nullptr || left->getType() != right->getType() || !this->_checkType(left_type, right_type)) {
+            return {nullptr, nullptr};
+        }
+        auto& data_layout = this->llvm_module->getDataLayout();
+        auto _bool = std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("bool"));
+        if (left->getType()->isIntegerTy(1)) {
+            switch(infix_expression->op) {
+                case token::TokenType::And:
+                    return {llvm::ConstantFoldBinaryOpOperands(llvm::Instruction::And, left, right, data_layout), _bool};
+                case token::TokenType::Or:
+                    return {llvm::ConstantFoldBinaryOpOperands(llvm::Instruction::Or, left, right, data_layout), _bool};
+                case token::TokenType::EqualEqual:
+                    return {llvm::ConstantFoldCompareInstOperands(llvm::CmpInst::ICMP_EQ, left, right, data_layout), _bool};
+                case token::TokenType::NotEquals:
+                    return {llvm::ConstantFoldCompareInstOperands(llvm::CmpInst::ICMP_NE, left, right, data_layout), _bool};
+                default:
+                    return {nullptr, nullptr};
+            }
+        }
+        if (left->getType()->isIntegerTy()) {
+            auto rhs = llvm::cast<llvm::ConstantInt>(right)->getValue();
+            auto lhs = llvm::cast<llvm::ConstantInt>(left)->getValue();
+            switch(infix_expression->op) {
+                case token::TokenType::Plus:
+                    return {llvm::ConstantFoldBinaryOpOperands(llvm::Instruction::Add, left, right, data_layout), left_type};
+                case token::TokenType::Dash:
+                    return {llvm::ConstantFoldBinaryOpOperands(llvm::Instruction::Sub, left, right, data_layout), left_type};
+                case token::TokenType::Asterisk:
+                    return {llvm::ConstantFoldBinaryOpOperands(llvm::Instruction::Mul, left, right, data_layout), left_type};
+                case token::TokenType::ForwardSlash:
+                case token::TokenType::Percent: {
+                    // Leave division by zero and INT_MIN / -1 to the runtime, folding them would produce poison
+                    if (rhs.isZero() || (lhs.isMinSignedValue() && rhs.isAllOnes())) {
+                        return {nullptr, nullptr};
+                    }
+                    auto opcode = infix_expression->op == token::TokenType::ForwardSlash ? llvm::Instruction::SDiv : llvm::Instruction::SRem;
+                    return {llvm::ConstantFoldBinaryOpOperands(opcode, left, right, data_layout), left_type};
+                }
+                case token::TokenType::AsteriskAsterisk: {
+                    // same wrapping and negative exponent rules as _emitPower
+                    if (rhs.isNegative()) {
+                        bool unit = lhs.isOne() || lhs.isAllOnes();
+                        return {llvm::ConstantInt::get(left->getType(), unit ? (rhs[0] ? lhs : llvm::APInt(lhs.getBitWidth(), 1)) : llvm::APInt(lhs.getBitWidth(), 0)), left_type};
+                    }
+                    llvm::APInt power(lhs.getBitWidth(), 1);
+                    for (auto bits = rhs; !bits.isZero(); bits.lshrInPlace(1)) {
+                        if (bits[0]) {
+                            power *= lhs;
+                        }
+                        lhs *= lhs;
+                    }
+                    return {llvm::ConstantInt::get(left->getType(), power), left_type};
+                }
+                case token::TokenType::EqualEqual:
+                    return {llvm::ConstantFoldCompareInstOperands(llvm::CmpInst::ICMP_EQ, left, right, data_layout), _bool};
+                case token::TokenType::NotEquals:
+                    return {llvm::ConstantFoldCompareInstOperands(llvm::CmpInst::ICMP_NE, left, right, data_layout), _bool};
+                case token::TokenType::LessThan:
+                    return {llvm::ConstantFoldCompareInstOperands(llvm::CmpInst::ICMP_SLT, left, right, data_layout), _bool};
+                case token::TokenType::GreaterThan:
+                    return {llvm::ConstantFoldCompareInstOperands(llvm::CmpInst::ICMP_SGT, left, right, data_layout), _bool};
+                case token::TokenType::LessThanOrEqual:
+                    return {llvm::ConstantFoldCompareInstOperands(llvm::CmpInst::ICMP_SLE, left, right, data_layout), _bool};
+                case token::TokenType::GreaterThanOrEqual:
+                    return {llvm::ConstantFoldCompareInstOperands(llvm::CmpInst::ICMP_SGE, left, right, data_layout), _bool};
+                default:
+                    return {nullptr, nullptr};
+            }
+        }
+        if (left->getType()->isDoubleTy()) {
+            switch(infix_expression->op) {
+                case token::TokenType::Plus:
+                    return {llvm::ConstantFoldBinaryOpOperands(llvm::Instruction::FAdd, left, right, data_layout), left_type};
+                case token::TokenType::Dash:
+                    return {llvm::ConstantFoldBinaryOpOperands(llvm::Instruction::FSub, left, right, data_layout), left_type};
+                case token::TokenType::Asterisk:
+                    return {llvm::ConstantFoldBinaryOpOperands(llvm::Instruction::FMul, left, right, data_layout), left_type};
+                case token::TokenType::ForwardSlash:
+                    return {llvm::ConstantFoldBinaryOpOperands(llvm::Instruction::FDiv, left, right, data_layout), left_type};
+                case token::TokenType::EqualEqual:
+                    return {llvm::ConstantFoldCompareInstOperands(llvm::CmpInst::FCMP_OEQ, left, right, data_layout), _bool};
+                case token::TokenType::NotEquals:
+                    return {llvm::ConstantFoldCompareInstOperands(llvm::CmpInst::FCMP_ONE, left, right, data_layout), _bool};
+                case token::TokenType::LessThan:
+                    return {llvm::ConstantFoldCompareInstOperands(llvm::CmpInst::FCMP_OLT, left, right, data_layout), _bool};
+                case token::TokenType::GreaterThan:
+                    return {llvm::ConstantFoldCompareInstOperands(llvm::CmpInst::FCMP_OGT, left, right, data_layout), _bool};
+                case token::TokenType::LessThanOrEqual:
+                    return {llvm::ConstantFoldCompareInstOperands(llvm::CmpInst::FCMP_OLE, left, right, data_layout), _bool};
+                case token::TokenType::GreaterThanOrEqual:
+                    return {llvm::ConstantFoldCompareInstOperands(llvm::CmpInst::FCMP_OGE, left, right, data_layout), _bool};
+                default:
+                    return {nullptr, nullptr};
+            }
+        }
+        return {nullptr, nullptr};
+    }
+    case AST::NodeType::PrefixedExpression: {
+        auto prefix_expression = std::static_pointer_cast<AST::PrefixExpression>(node);
+        auto [right, right_type] = this->_resolveConstant(prefix_expression->right);
+        if (right == nullptr || prefix_expression->op != token::TokenType::Not || !right->getType()->isIntegerTy(1)) {
+            return {nullptr, nullptr};
+        }
+        return {llvm::ConstantExpr::getNot(right), right_type};
+    }
+    case AST::NodeType::ArrayLiteral: {
+        auto array_literal = std::static_pointer_cast<AST::ArrayLiteral>(node);
+        if (array_literal->elements.empty()) {
+            return {nullptr, nullptr};
+        }
+        std::vector<llvm::Constant*> elements;
+        std::shared_ptr<enviornment::RecordStructInstance> first_generic = nullptr;
+        for (auto element : array_literal->elements) {
+            auto [value, generic] = this->_resolveConstant(element);
+            // Only scalar elements can be folded, nested arrays and structs are stored by pointer
+            if (value == nullptr || generic->struct_type->stand_alone_type == nullptr || value->getType()->isPointerTy() || value->getType()->isAggregateType()) {
+                return {nullptr, nullptr};
+            }
+            if (first_generic == nullptr) {
+                first_generic = generic;
+            }
+            if (!this->_checkType(first_generic, generic)) {
+                return {nullptr, nullptr};
+            }
+            elements.push_back(value);
+        }
+        auto array_type = llvm::ArrayType::get(first_generic->struct_type->stand_alone_type, elements.size());
+        return {llvm::ConstantArray::get(array_type, elements),
+                std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("array"), std::vector<std::shared_ptr<enviornment::RecordStructInstance>>{first_generic})};
+    }
+    case AST::NodeType::CallExpression: {
+        auto call_expression = std::static_pointer_cast<AST::CallExpression>(node);
+        auto name = std::static_pointer_cast<AST::IdentifierLiteral>(call_expression->name)->value;
+        if (!this->enviornment.is_struct(name)) {
+            return {nullptr, nullptr};
+        }
+        auto struct_record = this->enviornment.get_struct(name);
+        if (struct_record->struct_type == nullptr || call_expression->arguments.size() != struct_record->fields.size()) {
+            return {nullptr, nullptr};
+        }
+        std::vector<llvm::Constant*> fields;
+        for (unsigned int i = 0; i < call_expression->arguments.size(); ++i) {
+            auto [value, generic] = this->_resolveConstant(call_expression->arguments[i]);
+            if (value == nullptr || generic->struct_type->stand_alone_type == nullptr || value->getType()->isPointerTy() || value->getType()->isAggregateType()) {
+                return {nullptr, nullptr};
+            }
+            if (!this->_checkType(struct_record->sub_types[struct_record->fields[i]], generic)) {
+                return {nullptr, nullptr};
+            }
+            fields.push_back(value);
+        }
+        return {llvm::ConstantStruct::get(struct_record->struct_type, fields), std::make_shared<enviornment::RecordStructInstance>(struct_record)};
+    }
+    default:
+        return {nullptr, nullptr};
+    }
+};
+
+// Aggregate constants live in a private global and are copied into a fresh stack slot with a single memcpy,
+// the copy keeps the value mutable while -O builds drop it entirely when the slot is never written.
+llvm::Value* compiler::Compiler::_materializeConstant(llvm::Constant* constant, const std::string& name) {
+    auto global = new llvm::GlobalVariable(*this->llvm_module, constant->getType(), true, llvm::GlobalValue::PrivateLinkage, constant, name + ".const");
+    global->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
+    auto alloca = this->_createEntryBlockAlloca(constant->getType(), nullptr, name);
+    this->llvm_ir_builder.CreateMemCpy(alloca, alloca->getAlign(), global, global->getAlign(), llvm::ConstantExpr::getSizeOf(constant->getType()));
+    return alloca;
+};
+
 std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::RecordStructInstance>, std::shared_ptr<enviornment::RecordModule>>> compiler::Compiler::_visitArrayLiteral(std::shared_ptr<AST::ArrayLiteral> array_literal) {
+    auto [constant, constant_generic] = this->_resolveConstant(array_literal);
     std::vector<llvm::Value*> values;
     std::shared_ptr<enviornment::RecordStructType> struct_type = nullptr;
     std::vector<std::shared_ptr<enviornment::RecordStructInstance>> generics;
     std::shared_ptr<enviornment::RecordStructInstance> first_generic;
 
-    for (auto element : array_literal->elements) {
+    if (constant != nullptr) {
+        generics = constant_generic->generic;
+        struct_type = generics[0]->struct_type;
+    }
+    for (auto element : constant == nullptr ? array_literal->elements : std::vector<std::shared_ptr<AST::Expression>>{}) {
         auto [value, _generic] = this->_resolveValue(element);
         if (value.empty()) {
             std::cerr << "Cant add Module in Array" << std::endl;
@@ -867,22 +1517,42 @@ std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::
             exit(1);
         }
         auto loadInst = struct_type->struct_type == nullptr ? value[0] : this->llvm_ir_builder.CreateLoad(struct_type->struct_type, value[0]);
-        if (llvm::isa<llvm::Instruction>(loadInst)) {
-        }
         values.push_back(loadInst);
     }
-    auto array_type = llvm::ArrayType::get(struct_type->stand_alone_type ? struct_type->stand_alone_type : struct_type->struct_type, values.size());
-    auto array = this->llvm_ir_builder.CreateAlloca(array_type, nullptr);
-    for (int i = 0; i < values.size(); i++) {
-        auto element = this->llvm_ir_builder.CreateGEP(array_type, array, {this->llvm_ir_builder.getInt64(0), this->llvm_ir_builder.getInt64(i)});
-        auto storeInst = this->llvm_ir_builder.CreateStore(values[i], element);
+    // Elements live on the heap so big literals cannot overflow the stack and the array can be returned and grown,
+    // an empty literal takes its element type from the declaration it is assigned to
+    auto size = constant != nullptr ? llvm::cast<llvm::ArrayType>(constant->getType())->getNumElements() : values.size();
+    llvm::Type* element_type = nullptr;
+    if (struct_type != nullptr) {
+        element_type = struct_type->stand_alone_type ? struct_type->stand_alone_type : struct_type->struct_type;
     }
-    return {{array}, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("array"), generics)};
+    auto element_size = element_type ? llvm::ConstantExpr::getSizeOf(element_type) : this->llvm_ir_builder.getInt64(0);
+    auto array_type = std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("array"), generics);
+    llvm::Constant* element_desc = generics.empty() ? nullptr : this->_gcDescriptor(generics[0]);
+    if (element_desc == nullptr) {
+        element_desc = llvm::ConstantPointerNull::get(llvm::PointerType::get(this->llvm_context, 0));
+    }
+    auto array = this->llvm_ir_builder.CreateCall(this->llvm_module->getFunction("gigly_array_new"), {element_size, this->llvm_ir_builder.getInt64(size), element_desc}, "array");
+    if (size != 0) {
+        auto data = this->_arrayData(array);
+        if (constant != nullptr) {
+            // constant elements are copied out of a private global with a single memcpy
+            auto global = new llvm::GlobalVariable(*this->llvm_module, constant->getType(), true, llvm::GlobalValue::PrivateLinkage, constant, "array.const");
+            global->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
+            this->llvm_ir_builder.CreateMemCpy(data, llvm::MaybeAlign(), global, global->getAlign(), llvm::ConstantExpr::getSizeOf(constant->getType()));
+        }
+        for (int i = 0; i < values.size(); i++) {
+            auto element = this->llvm_ir_builder.CreateGEP(element_type, data, this->llvm_ir_builder.getInt64(i));
+            auto storeInst = this->llvm_ir_builder.CreateStore(values[i], element);
+        }
+        this->llvm_ir_builder.CreateStore(this->llvm_ir_builder.getInt64(size), this->llvm_ir_builder.CreateStructGEP(this->array_header, array, 1));
+    }
+    return {{this->_gcRootTemp(array, array_type)}, array_type};
 };
 
 void compiler::Compiler::_visitReturnStatement(std::shared_ptr<AST::ReturnStatement> return_statement) {
     auto value = return_statement->value;
-    auto [return_value, _] = this->_resolveValue(value);
+    auto [return_value, _return_type] = this->_resolveValue(value);
     if(return_value.size() != 1) {
         // errors::InternalCompilationError("Return statement with multiple values", this->source, return_statement->meta_data.st_line_no,
         //                                  return_statement->meta_data.end_line_no, "Return statement with multiple values")
@@ -894,8 +1564,39 @@ void compiler::Compiler::_visitReturnStatement(std::shared_ptr<AST::ReturnStatem
         std::cerr << "Return Outside of function" << std::endl;
         exit(1);
     }
+    if (std::holds_alternative<std::shared_ptr<enviornment::RecordStructInstance>>(_return_type)) {
+        std::tie(return_value[0], std::ignore) = this->_implicitCast(return_value[0], std::get<std::shared_ptr<enviornment::RecordStructInstance>>(_return_type),
+                                                                     this->enviornment.current_function->return_inst, return_statement);
+    }
     llvm::Instruction* retInst = nullptr;
-    if (this->enviornment.current_function->function->getReturnType()->isPointerTy() && return_value[0]->getType()->isPointerTy())
+    auto function = this->enviornment.current_function->function;
+    // the result is already computed, leaving the function frees every arena opened in it
+    if (!this->enviornment.arenas.empty() && std::holds_alternative<std::shared_ptr<enviornment::RecordStructInstance>>(_return_type) &&
+        this->_holdsHeap(std::get<std::shared_ptr<enviornment::RecordStructInstance>>(_return_type))) {
+        errors::CompletionError("Value escapes arena", this->source, return_statement->meta_data.st_line_no, return_statement->meta_data.end_line_no,
+                                "A `" + std::get<std::shared_ptr<enviornment::RecordStructInstance>>(_return_type)->struct_type->name +
+                                    "` returned from inside an arena block would be freed when the block exits")
+            .raise();
+    }
+    this->_exitArenas(0);
+    if (function->hasStructRetAttr()) {
+        if (!return_value[0]->getType()->isPointerTy()) {
+            std::cerr << "Cannot Convert non pointer to Pointer" << std::endl;
+            exit(1);
+        }
+        // struct results are written into the caller's sret slot
+        auto block = this->llvm_ir_builder.GetInsertBlock();
+        auto call = block->empty() ? nullptr : llvm::dyn_cast<llvm::CallInst>(&block->back());
+        if (call != nullptr && call->hasStructRetAttr() && call->getArgOperand(0) == return_value[0]) {
+            // `return g(...)` lets g write straight into our caller's slot, no temporary and no copy
+            call->setArgOperand(0, function->getArg(0));
+        } else {
+            auto struct_type = this->enviornment.current_function->return_inst->struct_type->struct_type;
+            this->llvm_ir_builder.CreateMemCpy(function->getArg(0), llvm::MaybeAlign(), return_value[0], llvm::MaybeAlign(), llvm::ConstantExpr::getSizeOf(struct_type));
+        }
+        retInst = this->llvm_ir_builder.CreateRetVoid();
+    }
+    else if (this->enviornment.current_function->function->getReturnType()->isPointerTy() && return_value[0]->getType()->isPointerTy())
         retInst = this->llvm_ir_builder.CreateRet(return_value[0]);
     else if (this->enviornment.current_function->function->getReturnType()->isPointerTy() && !return_value[0]->getType()->isPointerTy()) {
         std::cerr << "Cannot Convert non pointer to Pointer" << std::endl;
@@ -907,126 +1608,1501 @@ void compiler::Compiler::_visitReturnStatement(std::shared_ptr<AST::ReturnStatem
         retInst = this->llvm_ir_builder.CreateRet(return_value[0]);
 
     if (retInst) {
+        this->_markTailCall(retInst);
     }
 };
 
-std::shared_ptr<enviornment::RecordStructInstance> compiler::Compiler::_parseType(std::shared_ptr<AST::GenericType> type) {
-    auto type_name = std::static_pointer_cast<AST::IdentifierLiteral>(type->name)->value;
-    if (!this->enviornment.is_struct(type_name)) {
-        errors::CompletionError("Type not found", this->source, type->meta_data.st_line_no, type->meta_data.end_line_no, "Type not found: " + type_name)
-            .raise();
+// A call right before the return whose result is returned as is, and whose arguments do not point into this frame, can reuse the frame.
+// With the caller's prototype it becomes musttail, which holds even without optimization, otherwise it gets the `tail` hint
+void compiler::Compiler::_markTailCall(llvm::Instruction* ret_inst) {
+    auto call = llvm::dyn_cast_or_null<llvm::CallInst>(ret_inst->getPrevNode());
+    if (call == nullptr || call->getCalledFunction() == nullptr || call->getCalledFunction()->isIntrinsic()) {
+        return;
     }
-    std::vector<std::shared_ptr<enviornment::RecordStructInstance>> generics = {};
-    for (auto gen : type->generics) {
-        generics.push_back(this->_parseType(gen));
+    if (ret_inst->getNumOperands() == 1 ? ret_inst->getOperand(0) != call : !call->getType()->isVoidTy()) {
+        return;
+    }
+    for (auto& arg : call->args()) {
+        if (arg->getType()->isPointerTy() && llvm::isa<llvm::AllocaInst>(llvm::getUnderlyingObject(arg))) {
+            return;
+        }
+    }
+    auto caller = ret_inst->getFunction();
+    auto callee = call->getCalledFunction();
+    bool same_sret = caller->hasStructRetAttr() == callee->hasStructRetAttr() &&
+                     (!caller->hasStructRetAttr() || caller->getParamStructRetType(0) == callee->getParamStructRetType(0));
+    if (callee->getFunctionType() == caller->getFunctionType() && callee->getCallingConv() == caller->getCallingConv() && same_sret) {
+        call->setTailCallKind(llvm::CallInst::TCK_MustTail);
+    } else {
+        call->setTailCallKind(llvm::CallInst::TCK_Tail);
     }
-    auto x = std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct(type_name), generics);
-    return x;
 };
 
-void compiler::Compiler::_visitFunctionDeclarationStatement(std::shared_ptr<AST::FunctionStatement> function_declaration_statement) {
-    auto name = std::static_pointer_cast<AST::IdentifierLiteral>(function_declaration_statement->name)->value;
-    auto body = function_declaration_statement->body;
-    auto params = function_declaration_statement->parameters;
-    std::vector<std::string> param_name;
+void compiler::Compiler::_checkPure(std::shared_ptr<AST::FunctionStatement> function_declaration_statement, llvm::Function* func) {
+    // `@pure` is trusted by the optimizer, so the compiled body must keep it: stores only to its own stack slots and
+    // only calls to functions that do not write memory either. Allocating a str or an array is a write.
+    if (!func->onlyReadsMemory()) {
+        return;
+    }
+    auto local = [](llvm::Value* pointer) { return llvm::isa<llvm::AllocaInst>(llvm::getUnderlyingObject(pointer)); };
+    for (auto& block : *func) {
+        for (auto& inst : block) {
+            std::string reason = "";
+            if (auto store = llvm::dyn_cast<llvm::StoreInst>(&inst); store && !local(store->getPointerOperand())) {
+                reason = "writes memory it does not own";
+            } else if (auto call = llvm::dyn_cast<llvm::CallInst>(&inst); call && !call->onlyReadsMemory()) {
+                auto callee = call->getCalledFunction();
+                if (auto transfer = llvm::dyn_cast<llvm::AnyMemIntrinsic>(call); transfer && local(transfer->getRawDest())) {
+                    continue;
+                }
+                // a failed bounds check never returns into the function, reporting it is not a side effect of the result
+                if (callee != nullptr && (callee->doesNotReturn() || callee->getIntrinsicID() == llvm::Intrinsic::gcroot ||
+                                          callee->getIntrinsicID() == llvm::Intrinsic::lifetime_start || callee->getIntrinsicID() == llvm::Intrinsic::lifetime_end)) {
+                    continue;
+                }
+                reason = "calls `" + (callee ? callee->getName().str() : std::string("a function pointer")) + "`, which may write memory (mark it `@pure` if it does not)";
+            }
+            if (!reason.empty()) {
+                errors::CompletionError("Not pure", this->source, function_declaration_statement->meta_data.st_line_no, function_declaration_statement->meta_data.end_line_no,
+                                        "`@pure` function " + reason)
+                    .raise();
+            }
+        }
+    }
+};
+
+void compiler::Compiler::_checkTailCalls(std::shared_ptr<AST::FunctionStatement> function_declaration_statement, llvm::Function* func) {
+    std::shared_ptr<AST::CallExpression> tailrec = nullptr;
+    for (auto attribute : function_declaration_statement->attributes) {
+        if (std::static_pointer_cast<AST::IdentifierLiteral>(attribute->name)->value == "tailrec") {
+            tailrec = attribute;
+        }
+    }
+    for (auto& block : *func) {
+        for (auto& inst : block) {
+            auto call = llvm::dyn_cast<llvm::CallInst>(&inst);
+            if (call == nullptr) {
+                continue;
+            }
+            if (call->getTailCallKind() == llvm::CallInst::TCK_Tail && func->hasGC()) {
+                // the shadow stack entry lives in this frame, only musttail unlinks it before jumping
+                call->setTailCallKind(llvm::CallInst::TCK_None);
+            }
+            if (tailrec != nullptr && call->getCalledFunction() == func && !call->isMustTailCall()) {
+                errors::CompletionError("Not tail recursive", this->source, tailrec->meta_data.st_line_no, tailrec->meta_data.end_line_no,
+                                        "`@tailrec` function calls itself outside a guaranteed tail call, the call must be returned directly, outside any arena, "
+                                        "without passing the address of a local")
+                    .raise();
+            }
+        }
+    }
+};
+
+llvm::Function* compiler::Compiler::_createFunction(std::shared_ptr<AST::FunctionStatement> function_declaration_statement, const std::string& symbol_name,
+                                                   llvm::GlobalValue::LinkageTypes linkage, const std::vector<std::shared_ptr<enviornment::RecordStructInstance>>& param_inst_records,
+                                                   std::shared_ptr<enviornment::RecordStructInstance> return_type) {
+    // Structs never travel by value: results go through an sret pointer and arguments are borrowed pointers
+    bool sret = return_type->struct_type->stand_alone_type == nullptr;
     std::vector<llvm::Type*> param_types;
-    std::vector<std::shared_ptr<enviornment::RecordStructInstance>> param_inst_record;
-    for(auto param : params) {
-        param_name.push_back(std::static_pointer_cast<AST::IdentifierLiteral>(param->name)->value);
-        param_inst_record.push_back(this->_parseType(param->value_type));
-        param_types.push_back(param_inst_record.back()->struct_type->stand_alone_type ? param_inst_record.back()->struct_type->stand_alone_type : llvm::PointerType::get(param_inst_record.back()->struct_type->struct_type, 0));
+    if (sret) {
+        param_types.push_back(return_type->struct_type->struct_type->getPointerTo());
     }
-    auto return_type = this->_parseType(function_declaration_statement->return_type);
-    auto llvm_return_type = return_type->struct_type->stand_alone_type ? return_type->struct_type->stand_alone_type : return_type->struct_type->struct_type->getPointerTo();
+    for (auto param_inst_record : param_inst_records) {
+        param_types.push_back(param_inst_record->struct_type->stand_alone_type ? param_inst_record->struct_type->stand_alone_type
+                                                                               : param_inst_record->struct_type->struct_type->getPointerTo());
+    }
+    auto llvm_return_type = sret ? llvm::Type::getVoidTy(this->llvm_context) : return_type->struct_type->stand_alone_type;
     auto func_type = llvm::FunctionType::get(llvm_return_type, param_types, false);
-    auto func = llvm::Function::Create(func_type, llvm::Function::ExternalLinkage, this->fc_st_name_prefix != "main.." ? this->fc_st_name_prefix + name : name, this->llvm_module.get());
-    this->ir_gc_map_json["functions"][name] = func->getName().str();
-    unsigned idx = 0;
-    for(auto& arg : func->args()) {
-        arg.setName(param_name[idx++]);
+    auto func = llvm::Function::Create(func_type, linkage, symbol_name, this->llvm_module.get());
+    unsigned offset = 0;
+    if (sret) {
+        func->addParamAttr(0, llvm::Attribute::getWithStructRetType(this->llvm_context, return_type->struct_type->struct_type));
+        func->addParamAttr(0, llvm::Attribute::NoAlias);
+        func->getArg(0)->setName("sret");
+        offset = 1;
     }
-    auto bb = llvm::BasicBlock::Create(this->llvm_context, "entry", func);
-    this->function_entery_block.push_back(bb);
-    this->llvm_ir_builder.SetInsertPoint(bb);
-    auto prev_env = std::make_shared<enviornment::Enviornment>(this->enviornment);
-    this->enviornment = enviornment::Enviornment(prev_env, {}, name);
-    std::vector<std::tuple<std::string, std::shared_ptr<enviornment::RecordVariable>>> arguments;
-    auto func_record = std::make_shared<enviornment::RecordFunction>(name, func, func_type, arguments, return_type);
-    this->enviornment.current_function = func_record;
-    for(const auto& [arg, param_type_record] : llvm::zip(func->args(), param_inst_record)) {
-        llvm::AllocaInst* alloca = nullptr;
-        if (!arg.getType()->isPointerTy() || this->_checkType(param_type_record, this->enviornment.get_struct("array"))) {
-            alloca = this->llvm_ir_builder.CreateAlloca(arg.getType(), nullptr, arg.getName());
-            auto storeInst = this->llvm_ir_builder.CreateStore(&arg, alloca);
+    for (unsigned idx = 0; idx < param_inst_records.size(); ++idx) {
+        func->getArg(idx + offset)->setName(std::static_pointer_cast<AST::IdentifierLiteral>(function_declaration_statement->parameters[idx]->name)->value);
+        if (param_inst_records[idx]->struct_type->stand_alone_type == nullptr) {
+            // the callee copies a struct before anything could write to it, so the caller's memory is only ever read.
+            // A borrowed struct is noalias as well, the body writes no memory at all while it is in use
+            if (this->_isBorrowed(function_declaration_statement, idx)) {
+                func->addParamAttr(idx + offset, llvm::Attribute::NoAlias);
+            }
+            func->addParamAttr(idx + offset, llvm::Attribute::NoCapture);
+            func->addParamAttr(idx + offset, llvm::Attribute::ReadOnly);
+        }
+    }
+    return func;
+};
+
+void compiler::Compiler::_bindFunctionParameters(std::shared_ptr<AST::FunctionStatement> function_declaration_statement, llvm::Function* func,
+                                                 const std::vector<std::shared_ptr<enviornment::RecordStructInstance>>& param_inst_records,
+                                                 std::vector<std::tuple<std::string, std::shared_ptr<enviornment::RecordVariable>>>& arguments) {
+    unsigned offset = func->hasStructRetAttr() ? 1 : 0;
+    for (unsigned idx = 0; idx < param_inst_records.size(); ++idx) {
+        auto arg = func->getArg(idx + offset);
+        auto param_type_record = param_inst_records[idx];
+        llvm::Value* alloca = nullptr;
+        if (param_type_record->struct_type->stand_alone_type != nullptr) {
+            alloca = this->_createEntryBlockAlloca(arg->getType(), nullptr, arg->getName());
+            this->_gcRoot(alloca, param_type_record);
+            auto storeInst = this->llvm_ir_builder.CreateStore(arg, alloca);
+        }
+        else if (!this->_isBorrowed(function_declaration_statement, idx)) {
+            // copy on write: a parameter the body might write to, directly or through an alias of the caller's memory, gets its own copy
+            auto struct_type = param_type_record->struct_type->struct_type;
+            alloca = this->_createEntryBlockAlloca(struct_type, nullptr, arg->getName());
+            this->_gcRoot(alloca, param_type_record);
+            this->llvm_ir_builder.CreateMemCpy(alloca, llvm::MaybeAlign(), arg, llvm::MaybeAlign(), llvm::ConstantExpr::getSizeOf(struct_type));
         }
         else {
-            alloca = this->llvm_ir_builder.CreateAlloca(param_type_record->struct_type->struct_type, nullptr, arg.getName());
-            auto loaded_arg = this->llvm_ir_builder.CreateLoad(param_type_record->struct_type->struct_type, &arg, arg.getName() + ".load");
-            auto storeInst = this->llvm_ir_builder.CreateStore(loaded_arg, alloca);
+            alloca = arg;
         }
-        auto record = std::make_shared<enviornment::RecordVariable>(std::string(arg.getName()), &arg, alloca, param_type_record);
-        arguments.push_back({std::string(arg.getName()), record});
+        auto record = std::make_shared<enviornment::RecordVariable>(arg->getName().str(), arg, alloca, param_type_record);
+        arguments.push_back({arg->getName().str(), record});
         this->enviornment.add(record);
     }
-    func_record->set_meta_data(function_declaration_statement->meta_data.st_line_no, function_declaration_statement->meta_data.st_col_no,
-                               function_declaration_statement->meta_data.end_line_no, function_declaration_statement->meta_data.end_col_no);
-    func_record->meta_data.more_data["name_line_no"] = function_declaration_statement->name->meta_data.st_line_no;
-    func_record->meta_data.more_data["name_st_col_no"] = function_declaration_statement->name->meta_data.st_col_no;
-    func_record->meta_data.more_data["name_end_col_no"] = function_declaration_statement->name->meta_data.end_col_no;
-    func_record->meta_data.more_data["name_end_line_no"] = function_declaration_statement->name->meta_data.end_line_no;
-    this->enviornment.add(func_record);
-    // adding the alloca for the parameters
-    this->compile(body);
-    this->enviornment = *prev_env;
-    this->function_entery_block.pop_back();
-    if (!this->function_entery_block.empty()) {
-        this->llvm_ir_builder.SetInsertPoint(this->function_entery_block.at(this->function_entery_block.size() - 1));
+};
+
+llvm::Value* compiler::Compiler::_createCall(std::shared_ptr<enviornment::RecordFunction> func_record, std::vector<llvm::Value*> args) {
+    if (func_record->c_abi) {
+        auto string_type = this->enviornment.get_struct("str");
+        for (auto& arg : args) {
+            if (arg->getType() == string_type->stand_alone_type) {
+                auto slot = this->_createEntryBlockAlloca(string_type->stand_alone_type, nullptr, func_record->name + ".arg");
+                this->llvm_ir_builder.CreateStore(arg, slot);
+                arg = slot;
+            }
+        }
+        if (func_record->return_inst->struct_type == string_type) {
+            auto result = this->_createEntryBlockAlloca(string_type->stand_alone_type, nullptr, func_record->name + ".result");
+            this->_gcRoot(result, func_record->return_inst);
+            args.insert(args.begin(), result);
+            this->llvm_ir_builder.CreateCall(func_record->function, args);
+            return this->llvm_ir_builder.CreateLoad(string_type->stand_alone_type, result);
+        }
+    }
+    if (!func_record->function->hasStructRetAttr()) {
+        return this->_gcRootTemp(this->llvm_ir_builder.CreateCall(func_record->function, args), func_record->return_inst);
+    }
+    auto struct_type = func_record->return_inst->struct_type->struct_type;
+    auto result = this->_createEntryBlockAlloca(struct_type, nullptr, func_record->name + ".result");
+    this->_gcRoot(result, func_record->return_inst);
+    args.insert(args.begin(), result);
+    auto call = this->llvm_ir_builder.CreateCall(func_record->function, args);
+    call->addParamAttr(0, llvm::Attribute::getWithStructRetType(this->llvm_context, struct_type));
+    return result;
+};
+
+std::shared_ptr<enviornment::RecordFunction> compiler::Compiler::_declareExternFunction(std::shared_ptr<AST::FunctionStatement> function_declaration_statement) {
+    // extern "C" binds straight to the C symbol. Scalars travel as their C types, str as const gigly_str*, arrays as
+    // gigly_array* and structs by pointer; a str or struct result is written through a leading out pointer
+    auto name = std::static_pointer_cast<AST::IdentifierLiteral>(function_declaration_statement->name)->value;
+    if (function_declaration_statement->extern_abi != "C") {
+        errors::CompletionError("Unsupported ABI", this->source, function_declaration_statement->meta_data.st_line_no, function_declaration_statement->meta_data.end_line_no,
+                                "Only extern \"C\" is supported")
+            .raise();
+    }
+    if (!function_declaration_statement->generics.empty()) {
+        errors::CompletionError("Invalid extern", this->source, function_declaration_statement->meta_data.st_line_no, function_declaration_statement->meta_data.end_line_no,
+                                "extern functions cannot be generic")
+            .raise();
+    }
+    auto string_type = this->enviornment.get_struct("str");
+    auto ptr_type = llvm::PointerType::get(this->llvm_context, 0);
+    std::vector<std::shared_ptr<enviornment::RecordStructInstance>> param_inst_records;
+    for (auto param : function_declaration_statement->parameters) {
+        param_inst_records.push_back(this->_parseType(param->value_type));
+    }
+    auto return_type = this->_parseType(function_declaration_statement->return_type);
+    bool string_result = return_type->struct_type == string_type;
+    bool sret = return_type->struct_type->stand_alone_type == nullptr;
+    auto func = this->llvm_module->getFunction(name);
+    if (func == nullptr) {
+        std::vector<llvm::Type*> param_types;
+        if (string_result || sret) {
+            param_types.push_back(ptr_type);
+        }
+        for (auto param_inst_record : param_inst_records) {
+            param_types.push_back(param_inst_record->struct_type == string_type || param_inst_record->struct_type->stand_alone_type == nullptr ? ptr_type
+                                                                                                                                                : param_inst_record->struct_type->stand_alone_type);
+        }
+        auto llvm_return_type = string_result || sret ? llvm::Type::getVoidTy(this->llvm_context) : return_type->struct_type->stand_alone_type;
+        // not nounwind unless declared `@nounwind`, a C++ source behind the declaration may throw through its callers
+        func = llvm::Function::Create(llvm::FunctionType::get(llvm_return_type, param_types, false), llvm::Function::ExternalLinkage, name, this->llvm_module.get());
+        unsigned offset = string_result || sret ? 1 : 0;
+        if (sret) {
+            func->addParamAttr(0, llvm::Attribute::getWithStructRetType(this->llvm_context, return_type->struct_type->struct_type));
+        }
+        if (offset) {
+            func->addParamAttr(0, llvm::Attribute::NoAlias);
+        }
+        // C passes integers narrower than int extended by their signedness, _Bool zero-extended and char sign-extended
+        auto extension = [&](std::shared_ptr<enviornment::RecordStructInstance> type) {
+            auto llvm_type = type->struct_type->stand_alone_type;
+            if (llvm_type == nullptr || !llvm_type->isIntegerTy() || llvm_type->getIntegerBitWidth() >= 32) {
+                return llvm::Attribute::None;
+            }
+            return type->struct_type->is_unsigned || llvm_type->isIntegerTy(1) ? llvm::Attribute::ZExt : llvm::Attribute::SExt;
+        };
+        for (unsigned idx = 0; idx < param_inst_records.size(); ++idx) {
+            func->getArg(idx + offset)->setName(std::static_pointer_cast<AST::IdentifierLiteral>(function_declaration_statement->parameters[idx]->name)->value);
+            if (extension(param_inst_records[idx]) != llvm::Attribute::None) {
+                func->addParamAttr(idx + offset, extension(param_inst_records[idx]));
+            }
+        }
+        if (!sret && !string_result && extension(return_type) != llvm::Attribute::None) {
+            func->addRetAttr(extension(return_type));
+        }
+        this->_applyFunctionAttributes(function_declaration_statement, func);
+    }
+    // the declared parameters give calls the same implicit casts and checks as calls to GigglyCode functions
+    std::vector<std::tuple<std::string, std::shared_ptr<enviornment::RecordVariable>>> arguments;
+    for (size_t idx = 0; idx < param_inst_records.size(); ++idx) {
+        auto param_name = std::static_pointer_cast<AST::IdentifierLiteral>(function_declaration_statement->parameters[idx]->name)->value;
+        arguments.push_back({param_name, std::make_shared<enviornment::RecordVariable>(param_name, nullptr, nullptr, param_inst_records[idx])});
+    }
+    auto func_record = std::make_shared<enviornment::RecordFunction>(name, func, func->getFunctionType(), arguments, return_type);
+    func_record->c_abi = true;
+    return func_record;
+};
+
+void compiler::Compiler::_applyFunctionAttributes(std::shared_ptr<AST::FunctionStatement> function_declaration_statement, llvm::Function* func) {
+    // `@name` applies to the function, `@name(a, b)` to the named pointer parameters
+    static const std::unordered_map<std::string, llvm::Attribute::AttrKind> function_attributes = {
+        {"noreturn", llvm::Attribute::NoReturn}, {"cold", llvm::Attribute::Cold},         {"hot", llvm::Attribute::Hot},
+        {"willreturn", llvm::Attribute::WillReturn}, {"inline", llvm::Attribute::AlwaysInline}, {"noinline", llvm::Attribute::NoInline},
+        {"nounwind", llvm::Attribute::NoUnwind}};
+    static const std::unordered_map<std::string, llvm::Attribute::AttrKind> parameter_attributes = {
+        {"nocapture", llvm::Attribute::NoCapture}, {"readonly", llvm::Attribute::ReadOnly}, {"writeonly", llvm::Attribute::WriteOnly},
+        {"noalias", llvm::Attribute::NoAlias},     {"nonnull", llvm::Attribute::NonNull}};
+    unsigned offset = func->arg_size() - function_declaration_statement->parameters.size();
+    for (auto attribute : function_declaration_statement->attributes) {
+        auto attribute_name = std::static_pointer_cast<AST::IdentifierLiteral>(attribute->name)->value;
+        if (attribute->arguments.empty() && function_attributes.contains(attribute_name)) {
+            func->addFnAttr(function_attributes.at(attribute_name));
+            continue;
+        }
+        if (attribute->arguments.empty() && attribute_name == "tailrec") {
+            // checked by _checkTailCalls once the body is compiled
+            continue;
+        }
+        if (attribute->arguments.empty() && attribute_name == "pure") {
+            // no side effects: it may read memory but never writes it, and always returns. A result written through an
+            // out pointer is a write, _checkPure verifies the body once it is compiled
+            if (offset > 0) {
+                errors::CompletionError("Invalid attribute", this->source, attribute->meta_data.st_line_no, attribute->meta_data.end_line_no,
+                                        "`@pure` functions cannot return a struct, their result is written to the caller's memory")
+                    .raise();
+            }
+            func->setOnlyReadsMemory();
+            func->setDoesNotThrow();
+            func->addFnAttr(llvm::Attribute::WillReturn);
+            continue;
+        }
+        if (attribute->arguments.empty() || !parameter_attributes.contains(attribute_name)) {
+            errors::CompletionError("Unknown attribute", this->source, attribute->meta_data.st_line_no, attribute->meta_data.end_line_no,
+                                    "`@" + attribute_name + "` is not a known function attribute")
+                .raise();
+        }
+        for (auto argument : attribute->arguments) {
+            auto param_name = argument->type() == AST::NodeType::IdentifierLiteral ? std::static_pointer_cast<AST::IdentifierLiteral>(argument)->value : "";
+            auto params = function_declaration_statement->parameters;
+            auto param = std::find_if(params.begin(), params.end(), [&](auto p) { return std::static_pointer_cast<AST::IdentifierLiteral>(p->name)->value == param_name; });
+            if (param == params.end() || !func->getArg(offset + (param - params.begin()))->getType()->isPointerTy()) {
+                errors::CompletionError("Invalid attribute", this->source, attribute->meta_data.st_line_no, attribute->meta_data.end_line_no,
+                                        "`@" + attribute_name + "` expects pointer parameters (str, arrays or structs) of this function")
+                    .raise();
+            }
+            func->addParamAttr(offset + (param - params.begin()), parameter_attributes.at(attribute_name));
+        }
+    }
+    if ((func->hasFnAttribute(llvm::Attribute::AlwaysInline) && func->hasFnAttribute(llvm::Attribute::NoInline)) ||
+        (func->hasFnAttribute(llvm::Attribute::Hot) && func->hasFnAttribute(llvm::Attribute::Cold))) {
+        errors::CompletionError("Conflicting attributes", this->source, function_declaration_statement->meta_data.st_line_no, function_declaration_statement->meta_data.st_line_no,
+                                "`@inline` with `@noinline` and `@hot` with `@cold` contradict each other")
+            .raise();
+    }
+};
+
+// Only what another module can import keeps external linkage: of the entry module just `main`, elsewhere every method and every
+// top-level function except the ones named `_like_this`. Internal functions can be inlined and dropped by the optimizer.
+llvm::GlobalValue::LinkageTypes compiler::Compiler::_exportLinkage(const std::string& name) {
+    if (this->fc_st_name_prefix == "main..") {
+        return name == "main" ? llvm::Function::ExternalLinkage : llvm::Function::InternalLinkage;
+    }
+    bool method = name.find("::") != std::string::npos;
+    return name.starts_with("_") && !method && !this->declares_generics ? llvm::Function::InternalLinkage : llvm::Function::ExternalLinkage;
+};
+
+// Drops functions nothing refers to once the module is complete, repeating so helpers only called by dropped functions go too
+void compiler::Compiler::_stripDeadFunctions() {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto& func : llvm::make_early_inc_range(this->llvm_module->functions())) {
+            if (!func.isDeclaration() && func.isDiscardableIfUnused() && func.use_empty()) {
+                GIGLY_TRACE(Codegen, Debug, "Dropping unused function " << func.getName().str());
+                func.eraseFromParent();
+                changed = true;
+            }
+        }
+    }
+};
+
+// Attributes LLVM can not infer across modules, every importer only sees declarations.
+// Nothing in GigglyCode unwinds, so a function only unwinds through the calls it makes; a loop-free function whose calls all
+// return also returns; a pointer parameter that is only loaded from, stored through or handed to non-capturing calls never escapes
+void compiler::Compiler::_inferFunctionAttributes() {
+    std::vector<llvm::Function*> functions;
+    for (auto& func : *this->llvm_module) {
+        if (!func.isDeclaration()) {
+            functions.push_back(&func);
+        }
+    }
+    auto all_calls = [](llvm::Function* func, auto predicate) {
+        for (auto& block : *func) {
+            for (auto& inst : block) {
+                auto call = llvm::dyn_cast<llvm::CallBase>(&inst);
+                if (call != nullptr && !predicate(call)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+    // nounwind is optimistic, a function loses it once it calls something that may unwind (an extern without `@nounwind`)
+    for (auto func : functions) {
+        func->setDoesNotThrow();
+    }
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (auto func : functions) {
+            if (func->doesNotThrow() && !all_calls(func, [](llvm::CallBase* call) { return call->doesNotThrow(); })) {
+                func->removeFnAttr(llvm::Attribute::NoUnwind);
+                changed = true;
+            }
+        }
+    }
+    // willreturn is pessimistic, recursion never gets it
+    std::set<llvm::Function*> has_loop;
+    for (auto func : functions) {
+        for (auto scc = llvm::scc_begin(func); !scc.isAtEnd(); ++scc) {
+            if (scc.hasCycle()) {
+                has_loop.insert(func);
+                break;
+            }
+        }
+    }
+    auto returns = [](llvm::CallBase* call) { return call->hasFnAttr(llvm::Attribute::WillReturn) || call->getIntrinsicID() == llvm::Intrinsic::gcroot; };
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (auto func : functions) {
+            if (!func->willReturn() && !has_loop.contains(func) && all_calls(func, returns)) {
+                func->addFnAttr(llvm::Attribute::WillReturn);
+                changed = true;
+            }
+        }
+    }
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (auto func : functions) {
+            for (auto& arg : func->args()) {
+                if (arg.getType()->isPointerTy() && !arg.hasNoCaptureAttr() && !this->_mayCapture(&arg)) {
+                    arg.addAttr(llvm::Attribute::NoCapture);
+                    changed = true;
+                }
+            }
+        }
+    }
+    // importers put the same attributes on their declarations
+    for (auto func : functions) {
+        if (func->hasLocalLinkage()) {
+            continue;
+        }
+        nlohmann::json inferred = {{"function", nlohmann::json::array()}, {"parameters", nlohmann::json::object()}};
+        for (auto kind : {llvm::Attribute::NoUnwind, llvm::Attribute::WillReturn}) {
+            if (func->hasFnAttribute(kind)) {
+                inferred["function"].push_back(llvm::Attribute::getNameFromAttrKind(kind).str());
+            }
+        }
+        for (auto& arg : func->args()) {
+            if (arg.hasNoCaptureAttr()) {
+                inferred["parameters"][std::to_string(arg.getArgNo())].push_back("nocapture");
+            }
+        }
+        this->ir_gc_map_json["attributes"][func->getName().str()] = inferred;
+    }
+};
+
+bool compiler::Compiler::_mayCapture(llvm::Value* pointer) {
+    std::vector<llvm::Value*> worklist = {pointer};
+    std::set<llvm::Value*> seen;
+    while (!worklist.empty()) {
+        auto value = worklist.back();
+        worklist.pop_back();
+        if (!seen.insert(value).second) {
+            continue;
+        }
+        for (auto& use : value->uses()) {
+            auto user = use.getUser();
+            if (llvm::isa<llvm::LoadInst>(user)) {
+                continue;
+            }
+            if (auto store = llvm::dyn_cast<llvm::StoreInst>(user); store != nullptr && use.getOperandNo() == store->getPointerOperandIndex()) {
+                continue;
+            }
+            if (llvm::isa<llvm::GetElementPtrInst>(user)) {
+                worklist.push_back(user);
+                continue;
+            }
+            if (auto call = llvm::dyn_cast<llvm::CallBase>(user); call != nullptr && call->isArgOperand(&use) && call->doesNotCapture(call->getArgOperandNo(&use))) {
+                continue;
+            }
+            return true;
+        }
+    }
+    return false;
+};
+
+void compiler::Compiler::_applyImportedAttributes(llvm::Function* func, nlohmann::json& ir_gc_map_json) {
+    auto symbol = func->getName().str();
+    if (!ir_gc_map_json.contains("attributes") || !ir_gc_map_json["attributes"].contains(symbol)) {
+        return;
+    }
+    auto& inferred = ir_gc_map_json["attributes"][symbol];
+    for (auto& name : inferred["function"]) {
+        func->addFnAttr(llvm::Attribute::getAttrKindFromName(name.get<std::string>()));
+    }
+    for (auto& [index, names] : inferred["parameters"].items()) {
+        for (auto& name : names) {
+            func->addParamAttr(std::stoul(index), llvm::Attribute::getAttrKindFromName(name.get<std::string>()));
+        }
+    }
+};
+
+bool compiler::Compiler::_isBorrowed(std::shared_ptr<AST::FunctionStatement> function_declaration_statement, size_t idx) {
+    // A struct parameter is used in place only when nothing in the body can change it: the name is never written and no
+    // store or call could reach the same memory through another path, like an array element passed next to its array
+    auto name = std::static_pointer_cast<AST::IdentifierLiteral>(function_declaration_statement->parameters[idx]->name)->value;
+    return !this->_isMutated(function_declaration_statement->body, name) && !this->_mayWriteMemory(function_declaration_statement->body);
+};
+
+bool compiler::Compiler::_isMutated(std::shared_ptr<AST::Node> node, const std::string& name) {
+    if (node == nullptr) {
+        return false;
+    }
+    switch (node->type()) {
+    case AST::NodeType::BlockStatement: {
+        for (auto stmt : std::static_pointer_cast<AST::BlockStatement>(node)->statements) {
+            if (this->_isMutated(stmt, name)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    case AST::NodeType::ExpressionStatement:
+        return this->_isMutated(std::static_pointer_cast<AST::ExpressionStatement>(node)->expr, name);
+    case AST::NodeType::VariableDeclarationStatement: {
+        // redeclaring the name rebinds it, which is a write as far as callers are concerned
+        auto declaration = std::static_pointer_cast<AST::VariableDeclarationStatement>(node);
+        if (std::static_pointer_cast<AST::IdentifierLiteral>(declaration->name)->value == name) {
+            return true;
+        }
+        return this->_isMutated(declaration->value, name);
+    }
+    case AST::NodeType::VariableAssignmentStatement: {
+        auto assignment = std::static_pointer_cast<AST::VariableAssignmentStatement>(node);
+        auto target = assignment->name;
+        while (target->type() == AST::NodeType::InfixedExpression || target->type() == AST::NodeType::IndexExpression) {
+            target = target->type() == AST::NodeType::InfixedExpression ? std::static_pointer_cast<AST::InfixExpression>(target)->left
+                                                                         : std::static_pointer_cast<AST::IndexExpression>(target)->left;
+        }
+        if (target->type() == AST::NodeType::IdentifierLiteral && std::static_pointer_cast<AST::IdentifierLiteral>(target)->value == name) {
+            return true;
+        }
+        return this->_isMutated(assignment->value, name);
+    }
+    case AST::NodeType::ReturnStatement:
+        return this->_isMutated(std::static_pointer_cast<AST::ReturnStatement>(node)->value, name);
+    case AST::NodeType::IfElseStatement: {
+        auto if_statement = std::static_pointer_cast<AST::IfElseStatement>(node);
+        return this->_isMutated(if_statement->condition, name) || this->_isMutated(if_statement->consequence, name) || this->_isMutated(if_statement->alternative, name);
+    }
+    case AST::NodeType::WhileStatement: {
+        auto while_statement = std::static_pointer_cast<AST::WhileStatement>(node);
+        return this->_isMutated(while_statement->condition, name) || this->_isMutated(while_statement->body, name);
+    }
+    case AST::NodeType::ForStatement: {
+        auto for_statement = std::static_pointer_cast<AST::ForStatement>(node);
+        return this->_isMutated(for_statement->iterable, name) || this->_isMutated(for_statement->body, name);
+    }
+    case AST::NodeType::ArenaStatement: {
+        auto arena_statement = std::static_pointer_cast<AST::ArenaStatement>(node);
+        return this->_isMutated(arena_statement->chunk_size, name) || this->_isMutated(arena_statement->body, name);
+    }
+    case AST::NodeType::InfixedExpression: {
+        auto infix = std::static_pointer_cast<AST::InfixExpression>(node);
+        return this->_isMutated(infix->left, name) || this->_isMutated(infix->right, name);
+    }
+    case AST::NodeType::PrefixedExpression:
+        return this->_isMutated(std::static_pointer_cast<AST::PrefixExpression>(node)->right, name);
+    case AST::NodeType::IndexExpression: {
+        auto index = std::static_pointer_cast<AST::IndexExpression>(node);
+        return this->_isMutated(index->left, name) || this->_isMutated(index->index, name) || this->_isMutated(index->end, name);
+    }
+    case AST::NodeType::CallExpression: {
+        for (auto arg : std::static_pointer_cast<AST::CallExpression>(node)->arguments) {
+            if (this->_isMutated(arg, name)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    case AST::NodeType::ArrayLiteral: {
+        for (auto element : std::static_pointer_cast<AST::ArrayLiteral>(node)->elements) {
+            // storing the pointer in an array would let it outlive the call
+            if (element->type() == AST::NodeType::IdentifierLiteral && std::static_pointer_cast<AST::IdentifierLiteral>(element)->value == name) {
+                return true;
+            }
+            if (this->_isMutated(element, name)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    default:
+        return false;
+    }
+};
+
+bool compiler::Compiler::_mayWriteMemory(std::shared_ptr<AST::Node> node) {
+    // Whether `node` may write memory it was handed: a field or element store, an append, or a call to anything but a
+    // builtin that only reads its arguments. Struct constructors and casts build new values and never count.
+    if (node == nullptr) {
+        return false;
+    }
+    static const std::unordered_set<std::string> reading_builtins = {"print", "eprint", "flush", "len", "puts", "open", "read", "write", "close", "mmap_file"};
+    switch (node->type()) {
+    case AST::NodeType::BlockStatement: {
+        for (auto stmt : std::static_pointer_cast<AST::BlockStatement>(node)->statements) {
+            if (this->_mayWriteMemory(stmt)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    case AST::NodeType::ExpressionStatement:
+        return this->_mayWriteMemory(std::static_pointer_cast<AST::ExpressionStatement>(node)->expr);
+    case AST::NodeType::VariableDeclarationStatement:
+        return this->_mayWriteMemory(std::static_pointer_cast<AST::VariableDeclarationStatement>(node)->value);
+    case AST::NodeType::VariableAssignmentStatement: {
+        auto assignment = std::static_pointer_cast<AST::VariableAssignmentStatement>(node);
+        return assignment->name->type() != AST::NodeType::IdentifierLiteral || this->_mayWriteMemory(assignment->value);
+    }
+    case AST::NodeType::ReturnStatement:
+        return this->_mayWriteMemory(std::static_pointer_cast<AST::ReturnStatement>(node)->value);
+    case AST::NodeType::IfElseStatement: {
+        auto if_statement = std::static_pointer_cast<AST::IfElseStatement>(node);
+        return this->_mayWriteMemory(if_statement->condition) || this->_mayWriteMemory(if_statement->consequence) || this->_mayWriteMemory(if_statement->alternative);
+    }
+    case AST::NodeType::WhileStatement: {
+        auto while_statement = std::static_pointer_cast<AST::WhileStatement>(node);
+        return this->_mayWriteMemory(while_statement->condition) || this->_mayWriteMemory(while_statement->body);
+    }
+    case AST::NodeType::ForStatement: {
+        auto for_statement = std::static_pointer_cast<AST::ForStatement>(node);
+        return this->_mayWriteMemory(for_statement->iterable) || this->_mayWriteMemory(for_statement->body);
+    }
+    case AST::NodeType::ArenaStatement: {
+        auto arena_statement = std::static_pointer_cast<AST::ArenaStatement>(node);
+        return this->_mayWriteMemory(arena_statement->chunk_size) || this->_mayWriteMemory(arena_statement->body);
+    }
+    case AST::NodeType::InfixedExpression: {
+        auto infix = std::static_pointer_cast<AST::InfixExpression>(node);
+        if (infix->op == token::TokenType::Dot && infix->right->type() == AST::NodeType::CallExpression) {
+            // methods and module functions can write anything they reach
+            return true;
+        }
+        return this->_mayWriteMemory(infix->left) || this->_mayWriteMemory(infix->right);
+    }
+    case AST::NodeType::PrefixedExpression:
+        return this->_mayWriteMemory(std::static_pointer_cast<AST::PrefixExpression>(node)->right);
+    case AST::NodeType::IndexExpression: {
+        auto index = std::static_pointer_cast<AST::IndexExpression>(node);
+        return this->_mayWriteMemory(index->left) || this->_mayWriteMemory(index->index) || this->_mayWriteMemory(index->end);
+    }
+    case AST::NodeType::CallExpression: {
+        auto call_expression = std::static_pointer_cast<AST::CallExpression>(node);
+        auto name = std::static_pointer_cast<AST::IdentifierLiteral>(call_expression->name)->value;
+        if (!reading_builtins.contains(name) && !this->enviornment.is_struct(name) && !this->enviornment.is_generic_struct(name)) {
+            return true;
+        }
+        for (auto arg : call_expression->arguments) {
+            if (this->_mayWriteMemory(arg)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    case AST::NodeType::ArrayLiteral: {
+        for (auto element : std::static_pointer_cast<AST::ArrayLiteral>(node)->elements) {
+            if (this->_mayWriteMemory(element)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    default:
+        return false;
+    }
+};
+
+std::pair<std::string, std::string> compiler::Compiler::_boundsFactKey(std::shared_ptr<AST::IndexExpression> index_expression) {
+    // only `name[name]` and `name[literal]` accesses are tracked, literals get a '#' prefix no identifier can have
+    if (index_expression->left->type() != AST::NodeType::IdentifierLiteral) {
+        return {"", ""};
+    }
+    auto array = std::static_pointer_cast<AST::IdentifierLiteral>(index_expression->left)->value;
+    if (index_expression->index->type() == AST::NodeType::IdentifierLiteral) {
+        return {array, std::static_pointer_cast<AST::IdentifierLiteral>(index_expression->index)->value};
+    }
+    if (index_expression->index->type() == AST::NodeType::IntegerLiteral) {
+        return {array, "#" + std::to_string(std::static_pointer_cast<AST::IntegerLiteral>(index_expression->index)->value)};
+    }
+    return {"", ""};
+};
+
+void compiler::Compiler::_emitBoundsCheck(llvm::Value* array, llvm::Value* index, std::shared_ptr<AST::IndexExpression> index_expression) {
+    if (!this->bounds_checks) {
+        return;
+    }
+    // Arrays never shrink, so a check that dominates this access, a loop range or a literal length proves it
+    auto key = this->_boundsFactKey(index_expression);
+    if (!key.first.empty()) {
+        if (this->enviornment.checked_indices.contains(key)) {
+            return;
+        }
+        if (index_expression->index->type() == AST::NodeType::IntegerLiteral && this->enviornment.array_min_lengths.contains(key.first)) {
+            auto constant_index = std::static_pointer_cast<AST::IntegerLiteral>(index_expression->index)->value;
+            if (constant_index >= 0 && constant_index < this->enviornment.array_min_lengths[key.first]) {
+                return;
+            }
+        }
+    }
+    auto len = this->_arrayLength(array);
+    // one unsigned compare also rejects negative indices
+    this->_emitBoundsBranch(this->llvm_ir_builder.CreateICmpULT(index, len, "inbounds"), index, len);
+    if (!key.first.empty()) {
+        this->enviornment.checked_indices.insert(key);
+    }
+};
+
+void compiler::Compiler::_emitBoundsBranch(llvm::Value* in_bounds, llvm::Value* index, llvm::Value* len) {
+    auto func = this->llvm_ir_builder.GetInsertBlock()->getParent();
+    llvm::BasicBlock* FailBB = llvm::BasicBlock::Create(llvm_context, "bounds.fail", func);
+    llvm::BasicBlock* OkBB = llvm::BasicBlock::Create(llvm_context, "bounds.ok", func);
+    this->llvm_ir_builder.CreateCondBr(in_bounds, OkBB, FailBB, llvm::MDBuilder(this->llvm_context).createBranchWeights(1 << 20, 1));
+    this->llvm_ir_builder.SetInsertPoint(FailBB);
+    this->llvm_ir_builder.CreateCall(this->llvm_module->getFunction("gigly_bounds_fail"), {index, len});
+    this->llvm_ir_builder.CreateUnreachable();
+    this->llvm_ir_builder.SetInsertPoint(OkBB);
+};
+
+void compiler::Compiler::_invalidateBoundsFacts(std::shared_ptr<AST::Node> node) {
+    std::erase_if(this->enviornment.checked_indices, [&](const auto& fact) { return this->_isMutated(node, fact.first) || this->_isMutated(node, fact.second); });
+    std::erase_if(this->enviornment.array_min_lengths, [&](const auto& fact) { return this->_isMutated(node, fact.first); });
+};
+
+void compiler::Compiler::_recordArrayLength(const std::string& name, std::shared_ptr<AST::Node> value) {
+    if (value->type() == AST::NodeType::ArrayLiteral) {
+        this->enviornment.array_min_lengths[name] = std::static_pointer_cast<AST::ArrayLiteral>(value)->elements.size();
+    }
+};
+
+std::shared_ptr<enviornment::RecordStructInstance> compiler::Compiler::_parseType(std::shared_ptr<AST::GenericType> type) {
+    auto type_name = std::static_pointer_cast<AST::IdentifierLiteral>(type->name)->value;
+    if (this->enviornment.is_generic_parameter(type_name)) {
+        return this->enviornment.get_generic_parameter(type_name)->instance;
+    }
+    std::vector<std::shared_ptr<enviornment::RecordStructInstance>> generics = {};
+    for (auto gen : type->generics) {
+        generics.push_back(this->_parseType(gen));
+    }
+    if (this->enviornment.is_generic_struct(type_name)) {
+        auto struct_record = this->_instantiateGenericStruct(this->enviornment.get_generic_struct(type_name), generics);
+        return std::make_shared<enviornment::RecordStructInstance>(struct_record, generics);
+    }
+    if (!this->enviornment.is_struct(type_name)) {
+        errors::CompletionError("Type not found", this->source, type->meta_data.st_line_no, type->meta_data.end_line_no, "Type not found: " + type_name)
+            .raise();
+    }
+    auto x = std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct(type_name), generics);
+    return x;
+};
+
+std::string compiler::Compiler::_mangleGenerics(const std::vector<std::shared_ptr<enviornment::RecordStructInstance>>& generics) {
+    std::string key = "[";
+    for (size_t i = 0; i < generics.size(); ++i) {
+        if (i != 0) {
+            key += ",";
+        }
+        // symbol names keep same-named structs of different modules apart
+        key += generics[i]->struct_type->symbol_name;
+        // monomorphized structs already carry their arguments in the name
+        if (generics[i]->struct_type->generic_arguments.empty() && !generics[i]->generic.empty()) {
+            key += this->_mangleGenerics(generics[i]->generic);
+        }
+    }
+    return key + "]";
+};
+
+enviornment::Enviornment compiler::Compiler::_genericEnviornment(std::shared_ptr<enviornment::Enviornment> prev_env, std::shared_ptr<enviornment::RecordModule> module, const std::string& name) {
+    // Generic bodies are compiled at module scope, not in the scope that happened to trigger the instantiation
+    auto scope = prev_env;
+    while (scope->parent != nullptr && scope->parent->parent != nullptr) {
+        scope = scope->parent;
+    }
+    if (module != nullptr) {
+        scope = std::make_shared<enviornment::Enviornment>(scope->parent != nullptr ? scope->parent : scope, module->record_map, module->name);
+    }
+    return enviornment::Enviornment(scope, {}, name);
+};
+
+std::shared_ptr<enviornment::RecordStructType> compiler::Compiler::_instantiateGenericStruct(std::shared_ptr<enviornment::RecordGenericStructType> generic,
+                                                                                             const std::vector<std::shared_ptr<enviornment::RecordStructInstance>>& generics) {
+    auto key = this->_mangleGenerics(generics);
+    if (generic->instances.contains(key)) {
+        return generic->instances.at(key);
+    }
+    auto declaration = generic->declaration;
+    if (declaration->generics.size() != generics.size()) {
+        errors::CompletionError("Generic Argument Mismatch", this->source, declaration->meta_data.st_line_no, declaration->meta_data.end_line_no,
+                                "Struct `" + generic->name + "` expects " + std::to_string(declaration->generics.size()) + " type arguments")
+            .raise();
+    }
+    llvm::IRBuilderBase::InsertPointGuard insert_point_guard(this->llvm_ir_builder);
+    auto prev_env = std::make_shared<enviornment::Enviornment>(this->enviornment);
+    this->enviornment = this->_genericEnviornment(prev_env, generic->module, generic->name + key);
+    for (const auto& [param, type] : llvm::zip(declaration->generics, generics)) {
+        this->enviornment.add(std::make_shared<enviornment::RecordGenericParameter>(std::static_pointer_cast<AST::IdentifierLiteral>(param)->value, type));
+    }
+    auto struct_record = this->_visitStructStatement(declaration, generic, key);
+    this->enviornment = *prev_env;
+    return struct_record;
+};
+
+std::shared_ptr<enviornment::RecordFunction> compiler::Compiler::_instantiateGenericFunction(std::shared_ptr<enviornment::RecordGenericFunction> generic,
+                                                                                            const std::vector<std::shared_ptr<enviornment::RecordStructInstance>>& generics) {
+    auto key = this->_mangleGenerics(generics);
+    if (generic->instances.contains(key)) {
+        return generic->instances.at(key);
+    }
+    auto declaration = generic->declaration;
+    if (declaration->generics.size() != generics.size()) {
+        errors::CompletionError("Generic Argument Mismatch", this->source, declaration->meta_data.st_line_no, declaration->meta_data.end_line_no,
+                                "Function `" + generic->name + "` expects " + std::to_string(declaration->generics.size()) + " type arguments")
+            .raise();
+    }
+    llvm::IRBuilderBase::InsertPointGuard insert_point_guard(this->llvm_ir_builder);
+    auto prev_env = std::make_shared<enviornment::Enviornment>(this->enviornment);
+    this->enviornment = this->_genericEnviornment(prev_env, generic->module, generic->name + key);
+    for (const auto& [param, type] : llvm::zip(declaration->generics, generics)) {
+        this->enviornment.add(std::make_shared<enviornment::RecordGenericParameter>(std::static_pointer_cast<AST::IdentifierLiteral>(param)->value, type));
+    }
+    auto func_record = this->_visitFunctionDeclarationStatement(declaration, generic, key);
+    this->enviornment = *prev_env;
+    return func_record;
+};
+
+std::shared_ptr<enviornment::RecordStructType> compiler::Compiler::_inferGenericStruct(std::shared_ptr<enviornment::RecordGenericStructType> generic,
+                                                                                       const std::vector<std::shared_ptr<enviornment::RecordStructInstance>>& params_types,
+                                                                                       std::shared_ptr<AST::Node> node) {
+    std::vector<std::shared_ptr<AST::GenericType>> declared_types;
+    for (auto field : generic->declaration->fields) {
+        if (field->type() == AST::NodeType::VariableDeclarationStatement) {
+            declared_types.push_back(std::static_pointer_cast<AST::VariableDeclarationStatement>(field)->value_type);
+        }
+    }
+    return this->_instantiateGenericStruct(generic, this->_inferGenerics(generic->declaration->generics, declared_types, params_types, node));
+};
+
+std::shared_ptr<enviornment::RecordFunction> compiler::Compiler::_inferGenericFunction(std::shared_ptr<enviornment::RecordGenericFunction> generic,
+                                                                                       const std::vector<std::shared_ptr<enviornment::RecordStructInstance>>& params_types,
+                                                                                       std::shared_ptr<AST::Node> node) {
+    std::vector<std::shared_ptr<AST::GenericType>> declared_types;
+    for (auto param : generic->declaration->parameters) {
+        declared_types.push_back(param->value_type);
+    }
+    return this->_instantiateGenericFunction(generic, this->_inferGenerics(generic->declaration->generics, declared_types, params_types, node));
+};
+
+std::vector<std::shared_ptr<enviornment::RecordStructInstance>> compiler::Compiler::_inferGenerics(const std::vector<std::shared_ptr<AST::Expression>>& generic_parameters,
+                                                                                                   const std::vector<std::shared_ptr<AST::GenericType>>& declared_types,
+                                                                                                   const std::vector<std::shared_ptr<enviornment::RecordStructInstance>>& params_types,
+                                                                                                   std::shared_ptr<AST::Node> node) {
+    if (declared_types.size() != params_types.size()) {
+        errors::CompletionError("Generic Argument Mismatch", this->source, node->meta_data.st_line_no, node->meta_data.end_line_no,
+                                "Expected " + std::to_string(declared_types.size()) + " arguments, got " + std::to_string(params_types.size()))
+            .raise();
+    }
+    std::unordered_map<std::string, std::shared_ptr<enviornment::RecordStructInstance>> bindings;
+    for (auto param : generic_parameters) {
+        bindings[std::static_pointer_cast<AST::IdentifierLiteral>(param)->value] = nullptr;
+    }
+    for (const auto& [declared_type, param_type] : llvm::zip(declared_types, params_types)) {
+        if (!this->_bindGeneric(declared_type, param_type, bindings)) {
+            errors::CompletionError("Generic Type Mismatch", this->source, node->meta_data.st_line_no, node->meta_data.end_line_no,
+                                    "Conflicting types for generic parameter")
+                .raise();
+        }
+    }
+    std::vector<std::shared_ptr<enviornment::RecordStructInstance>> generics;
+    for (auto param : generic_parameters) {
+        auto param_name = std::static_pointer_cast<AST::IdentifierLiteral>(param)->value;
+        if (bindings[param_name] == nullptr) {
+            errors::CompletionError("Cannot Infer Generic", this->source, node->meta_data.st_line_no, node->meta_data.end_line_no,
+                                    "Cannot infer generic parameter `" + param_name + "`")
+                .raise();
+        }
+        generics.push_back(bindings[param_name]);
+    }
+    return generics;
+};
+
+bool compiler::Compiler::_bindGeneric(std::shared_ptr<AST::GenericType> declared_type, std::shared_ptr<enviornment::RecordStructInstance> param_type,
+                                      std::unordered_map<std::string, std::shared_ptr<enviornment::RecordStructInstance>>& bindings) {
+    auto type_name = std::static_pointer_cast<AST::IdentifierLiteral>(declared_type->name)->value;
+    if (bindings.contains(type_name)) {
+        if (bindings[type_name] == nullptr) {
+            bindings[type_name] = param_type;
+            return true;
+        }
+        return this->_checkType(bindings[type_name], param_type);
+    }
+    // `Pair[A, B]` only matches a value carrying exactly two type arguments
+    if (declared_type->generics.size() != param_type->generic.size()) {
+        return false;
+    }
+    for (const auto& [declared_generic, param_generic] : llvm::zip(declared_type->generics, param_type->generic)) {
+        if (!this->_bindGeneric(declared_generic, param_generic, bindings)) {
+            return false;
+        }
+    }
+    return true;
+};
+
+std::shared_ptr<enviornment::RecordFunction> compiler::Compiler::_visitFunctionDeclarationStatement(std::shared_ptr<AST::FunctionStatement> function_declaration_statement,
+                                                                                                   std::shared_ptr<enviornment::RecordGenericFunction> generic, const std::string& generic_key) {
+    auto name = std::static_pointer_cast<AST::IdentifierLiteral>(function_declaration_statement->name)->value;
+    if (!function_declaration_statement->extern_abi.empty()) {
+        auto func_record = this->_declareExternFunction(function_declaration_statement);
+        this->enviornment.add(func_record);
+        return func_record;
+    }
+    if (generic == nullptr && !function_declaration_statement->generics.empty()) {
+        // generic functions are only compiled once they are instantiated with concrete types
+        auto symbol_name = this->fc_st_name_prefix != "main.." ? this->fc_st_name_prefix + name : name;
+        this->enviornment.add(std::make_shared<enviornment::RecordGenericFunction>(name, function_declaration_statement, symbol_name));
+        this->ir_gc_map_json["functions"][name] = symbol_name;
+        return nullptr;
+    }
+    GIGLY_TRACE(Codegen, Info, "Compiling function " << name << generic_key);
+    auto body = function_declaration_statement->body;
+    auto params = function_declaration_statement->parameters;
+    std::vector<std::shared_ptr<enviornment::RecordStructInstance>> param_inst_record;
+    for(auto param : params) {
+        param_inst_record.push_back(this->_parseType(param->value_type));
+    }
+    auto return_type = this->_parseType(function_declaration_statement->return_type);
+    llvm::Function* func = nullptr;
+    if (generic != nullptr) {
+        // every module instantiating the same types emits the same body, the linker keeps one
+        func = this->_createFunction(function_declaration_statement, generic->symbol_name + generic_key, llvm::Function::LinkOnceODRLinkage, param_inst_record, return_type);
+    } else {
+        func = this->_createFunction(function_declaration_statement, this->fc_st_name_prefix != "main.." ? this->fc_st_name_prefix + name : name, this->_exportLinkage(name),
+                                     param_inst_record, return_type);
+        if (!func->hasLocalLinkage()) {
+            this->ir_gc_map_json["functions"][name] = func->getName().str();
+        }
+    }
+    this->_applyFunctionAttributes(function_declaration_statement, func);
+    auto func_type = func->getFunctionType();
+    auto bb = llvm::BasicBlock::Create(this->llvm_context, "entry", func);
+    this->function_entery_block.push_back(bb);
+    this->llvm_ir_builder.SetInsertPoint(bb);
+    auto prev_env = std::make_shared<enviornment::Enviornment>(this->enviornment);
+    this->enviornment = enviornment::Enviornment(prev_env, {}, name);
+    auto func_record = std::make_shared<enviornment::RecordFunction>(name, func, func_type, std::vector<std::tuple<std::string, std::shared_ptr<enviornment::RecordVariable>>>{}, return_type);
+    if (generic != nullptr) {
+        generic->instances[generic_key] = func_record;
+    }
+    this->enviornment.current_function = func_record;
+    this->_bindFunctionParameters(function_declaration_statement, func, param_inst_record, func_record->arguments);
+    func_record->set_meta_data(function_declaration_statement->meta_data.st_line_no, function_declaration_statement->meta_data.st_col_no,
+                               function_declaration_statement->meta_data.end_line_no, function_declaration_statement->meta_data.end_col_no);
+    func_record->meta_data.more_data["name_line_no"] = function_declaration_statement->name->meta_data.st_line_no;
+    func_record->meta_data.more_data["name_st_col_no"] = function_declaration_statement->name->meta_data.st_col_no;
+    func_record->meta_data.more_data["name_end_col_no"] = function_declaration_statement->name->meta_data.end_col_no;
+    func_record->meta_data.more_data["name_end_line_no"] = function_declaration_statement->name->meta_data.end_line_no;
+    // instances stay reachable through the generic record so calls with other type arguments still resolve
+    if (generic == nullptr) {
+        this->enviornment.add(func_record);
+    }
+    // adding the alloca for the parameters
+    this->compile(body);
+    this->_checkTailCalls(function_declaration_statement, func);
+    this->_checkPure(function_declaration_statement, func);
+    this->enviornment = *prev_env;
+    this->function_entery_block.pop_back();
+    if (!this->function_entery_block.empty()) {
+        this->llvm_ir_builder.SetInsertPoint(this->function_entery_block.at(this->function_entery_block.size() - 1));
+    }
+    if (generic == nullptr) {
+        this->enviornment.add(func_record);
+    }
+    return func_record;
+};
+
+std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::RecordStructInstance>, std::shared_ptr<enviornment::RecordModule>>> compiler::Compiler::_visitCallExpression(std::shared_ptr<AST::CallExpression> call_expression) {
+    auto name = std::static_pointer_cast<AST::IdentifierLiteral>(call_expression->name)->value;
+    auto param = call_expression->arguments;
+    std::vector<llvm::Value*> args;
+    std::vector<std::shared_ptr<enviornment::RecordStructInstance>> params_types;
+    for(auto arg : param) {
+        auto [value, param_type] = this->_resolveValue(arg);
+        if (value.empty()) {
+            std::cerr << "Cant pass Module to the Function" << std::endl;
+            exit(1);
+        }
+        params_types.push_back(std::get<std::shared_ptr<enviornment::RecordStructInstance>>(param_type));
+        args.push_back(value[0]);
+    }
+    if(this->enviornment.is_function(name)) {
+        auto func_record = this->enviornment.get_function(name);
+        this->_implicitCastArguments(func_record, args, params_types, call_expression);
+        if (!_checkFunctionParameterType(func_record, params_types)) {
+            std::cerr << "Function Parameter Type Mismatch for function: " << name << std::endl;
+            exit(1);
+        }
+        auto returnValue = this->_createCall(func_record, args);
+        return {{returnValue}, func_record->return_inst};
+    }
+    else if (this->enviornment.is_generic_function(name)) {
+        auto func_record = this->_inferGenericFunction(this->enviornment.get_generic_function(name), params_types, call_expression);
+        this->_implicitCastArguments(func_record, args, params_types, call_expression);
+        auto returnValue = this->_createCall(func_record, args);
+        return {{returnValue}, func_record->return_inst};
+    }
+    else if (name == "len" || name == "append") {
+        return this->_visitArrayBuiltin(call_expression, args, params_types);
+    }
+    else if (name == "print" || name == "eprint") {
+        return this->_visitPrintBuiltin(call_expression, args, params_types);
+    }
+    else if (this->enviornment.is_struct(name) && this->enviornment.get_struct(name)->stand_alone_type != nullptr &&
+             (this->enviornment.get_struct(name)->stand_alone_type->isIntegerTy() || this->enviornment.get_struct(name)->stand_alone_type->isFloatingPointTy())) {
+        return this->_visitCastBuiltin(call_expression, args, params_types);
+    }
+    else if (name == "select" || name == "shuffle" || name == "store" || name.starts_with("reduce_") ||
+             (this->enviornment.is_struct(name) && this->_isVector(std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct(name))))) {
+        return this->_visitVectorBuiltin(call_expression, args, params_types);
+    }
+    else if (this->enviornment.is_struct(name)) {
+        auto [constant, constant_type] = this->_resolveConstant(call_expression);
+        if (constant != nullptr) {
+            return {{this->_materializeConstant(constant, name)}, constant_type};
+        }
+        return this->_visitStructConstruction(this->enviornment.get_struct(name), args, params_types);
+    }
+    else if (this->enviornment.is_generic_struct(name)) {
+        auto struct_record = this->_inferGenericStruct(this->enviornment.get_generic_struct(name), params_types, call_expression);
+        return this->_visitStructConstruction(struct_record, args, params_types);
+    }
+    errors::CompletionError("Function not defined", this->source, call_expression->meta_data.st_line_no, call_expression->meta_data.end_line_no,
+                            "Function `" + name + "` not defined")
+        .raise();
+    exit(1);
+};
+
+std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::RecordStructInstance>, std::shared_ptr<enviornment::RecordModule>>> compiler::Compiler::_visitPrintBuiltin(
+    std::shared_ptr<AST::CallExpression> call_expression, const std::vector<llvm::Value*>& args, const std::vector<std::shared_ptr<enviornment::RecordStructInstance>>& params_types) {
+    // print(a, b, ...) writes its arguments separated by spaces and ends the line, eprint does the same on stderr.
+    // Each value goes straight to its typed writer in the runtime's buffer, nothing is parsed at runtime.
+    auto name = std::static_pointer_cast<AST::IdentifierLiteral>(call_expression->name)->value;
+    auto fd = this->llvm_ir_builder.getInt32(name == "eprint" ? 2 : 1);
+    auto write_char = this->llvm_module->getFunction("gigly_io_write_char");
+    for (size_t idx = 0; idx < args.size(); ++idx) {
+        if (idx > 0) {
+            this->llvm_ir_builder.CreateCall(write_char, {fd, this->llvm_ir_builder.getInt32(' ')});
+        }
+        auto struct_type = params_types[idx]->struct_type;
+        if (struct_type == this->enviornment.get_struct("str")) {
+            auto string = this->_createEntryBlockAlloca(struct_type->stand_alone_type, nullptr, "print.str");
+            this->llvm_ir_builder.CreateStore(args[idx], string);
+            this->llvm_ir_builder.CreateCall(this->llvm_module->getFunction("gigly_io_write_str"), {fd, string});
+        } else if (struct_type == this->enviornment.get_struct("bool")) {
+            this->llvm_ir_builder.CreateCall(this->llvm_module->getFunction("gigly_io_write_bool"), {fd, this->llvm_ir_builder.CreateZExt(args[idx], this->llvm_ir_builder.getInt32Ty())});
+        } else if (struct_type == this->enviornment.get_struct("char")) {
+            this->llvm_ir_builder.CreateCall(write_char, {fd, this->llvm_ir_builder.CreateZExt(args[idx], this->llvm_ir_builder.getInt32Ty())});
+        } else if (struct_type->stand_alone_type != nullptr && struct_type->stand_alone_type->isIntegerTy()) {
+            // narrower integers widen to 64 bits with their own signedness, only u64 needs the unsigned writer
+            auto writer = struct_type->is_unsigned && struct_type->stand_alone_type->isIntegerTy(64) ? "gigly_io_write_uint" : "gigly_io_write_int";
+            auto value = this->llvm_ir_builder.CreateIntCast(args[idx], this->llvm_ir_builder.getInt64Ty(), !struct_type->is_unsigned);
+            this->llvm_ir_builder.CreateCall(this->llvm_module->getFunction(writer), {fd, value});
+        } else if (struct_type->stand_alone_type != nullptr && struct_type->stand_alone_type->isFloatTy()) {
+            this->llvm_ir_builder.CreateCall(this->llvm_module->getFunction("gigly_io_write_f32"), {fd, args[idx]});
+        } else if (struct_type->stand_alone_type != nullptr && struct_type->stand_alone_type->isDoubleTy()) {
+            this->llvm_ir_builder.CreateCall(this->llvm_module->getFunction("gigly_io_write_float"), {fd, args[idx]});
+        } else {
+            errors::CompletionError("Invalid arguments", this->source, call_expression->meta_data.st_line_no, call_expression->meta_data.end_line_no,
+                                    name + " expects numbers, bool, char or str values")
+                .raise();
+        }
+    }
+    auto call = this->llvm_ir_builder.CreateCall(write_char, {fd, this->llvm_ir_builder.getInt32('\n')});
+    return {{call}, std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("void"))};
+};
+
+std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::RecordStructInstance>, std::shared_ptr<enviornment::RecordModule>>> compiler::Compiler::_visitArrayBuiltin(
+    std::shared_ptr<AST::CallExpression> call_expression, const std::vector<llvm::Value*>& args, const std::vector<std::shared_ptr<enviornment::RecordStructInstance>>& params_types) {
+    auto name = std::static_pointer_cast<AST::IdentifierLiteral>(call_expression->name)->value;
+    auto int_type = std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("int"));
+    if (name == "len" && args.size() == 1 && params_types[0]->struct_type == this->enviornment.get_struct("str")) {
+        return {{this->_stringLength(args[0])}, int_type};
+    }
+    if (args.size() != (name == "len" ? 1 : 2) || !this->_checkType(params_types[0], this->enviornment.get_struct("array"))) {
+        errors::CompletionError("Invalid arguments", this->source, call_expression->meta_data.st_line_no, call_expression->meta_data.end_line_no,
+                                name == "len" ? "len expects an array or a str" : "append expects an array and an element")
+            .raise();
+    }
+    if (name == "len") {
+        return {{this->_arrayLength(args[0])}, int_type};
+    }
+    if (params_types[0]->generic.empty()) {
+        errors::CompletionError("Type mismatch", this->source, call_expression->meta_data.st_line_no, call_expression->meta_data.end_line_no,
+                                "Element type of the array is not known, declare it as array[T]")
+            .raise();
+    }
+    auto [element_value, element_inst] = this->_implicitCast(args[1], params_types[1], params_types[0]->generic[0], call_expression);
+    if (!this->_checkType(params_types[0]->generic[0], element_inst)) {
+        errors::CompletionError("Type mismatch", this->source, call_expression->meta_data.st_line_no, call_expression->meta_data.end_line_no,
+                                "Element does not match the array element type")
+            .raise();
+    }
+    this->_checkArenaEscape(call_expression->arguments[0], element_inst, call_expression);
+    // Inline fast path stores into spare capacity, the runtime is only called when the array is full
+    auto element_struct = element_inst->struct_type;
+    auto element_type = element_struct->stand_alone_type ? element_struct->stand_alone_type : element_struct->struct_type;
+    auto func = this->llvm_ir_builder.GetInsertBlock()->getParent();
+    auto len = this->_arrayLength(args[0]);
+    auto cap = this->llvm_ir_builder.CreateLoad(this->llvm_ir_builder.getInt64Ty(), this->llvm_ir_builder.CreateStructGEP(this->array_header, args[0], 2), "array.cap");
+    auto new_len = this->llvm_ir_builder.CreateNUWAdd(len, this->llvm_ir_builder.getInt64(1), "array.newlen");
+    llvm::BasicBlock* GrowBB = llvm::BasicBlock::Create(llvm_context, "append.grow", func);
+    llvm::BasicBlock* StoreBB = llvm::BasicBlock::Create(llvm_context, "append.store", func);
+    auto full = this->llvm_ir_builder.CreateICmpUGE(len, cap, "array.full");
+    this->llvm_ir_builder.CreateCondBr(full, GrowBB, StoreBB, llvm::MDBuilder(this->llvm_context).createBranchWeights(1, 64));
+    this->llvm_ir_builder.SetInsertPoint(GrowBB);
+    llvm::Constant* element_desc = this->_gcDescriptor(element_inst);
+    bool holds_heap = element_desc != nullptr;
+    if (element_desc == nullptr) {
+        element_desc = llvm::ConstantPointerNull::get(llvm::PointerType::get(this->llvm_context, 0));
+    }
+    this->llvm_ir_builder.CreateCall(this->llvm_module->getFunction("gigly_array_grow"), {args[0], llvm::ConstantExpr::getSizeOf(element_type), new_len, element_desc});
+    this->llvm_ir_builder.CreateBr(StoreBB);
+    this->llvm_ir_builder.SetInsertPoint(StoreBB);
+    auto element = this->llvm_ir_builder.CreateGEP(element_type, this->_arrayData(args[0]), len, "element");
+    if (element_struct->stand_alone_type == nullptr) {
+        this->llvm_ir_builder.CreateMemCpy(element, llvm::MaybeAlign(), element_value, llvm::MaybeAlign(), llvm::ConstantExpr::getSizeOf(element_type));
+    } else {
+        this->llvm_ir_builder.CreateStore(element_value, element);
+    }
+    if (holds_heap && this->enviornment.arenas.empty()) {
+        // the arena check above only covers arenas of this function, a caller's arena can still be open
+        this->llvm_ir_builder.CreateCall(this->llvm_module->getFunction("gigly_arena_check_escape"), {args[0], element, element_desc});
+    }
+    this->llvm_ir_builder.CreateStore(new_len, this->llvm_ir_builder.CreateStructGEP(this->array_header, args[0], 1));
+    if (call_expression->arguments[0]->type() == AST::NodeType::IdentifierLiteral) {
+        auto array_name = std::static_pointer_cast<AST::IdentifierLiteral>(call_expression->arguments[0])->value;
+        if (this->enviornment.array_min_lengths.contains(array_name)) {
+            this->enviornment.array_min_lengths[array_name]++;
+        }
+    }
+    return {{new_len}, int_type};
+};
+
+std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::RecordStructInstance>, std::shared_ptr<enviornment::RecordModule>>> compiler::Compiler::_visitVectorBuiltin(
+    std::shared_ptr<AST::CallExpression> call_expression, const std::vector<llvm::Value*>& args, const std::vector<std::shared_ptr<enviornment::RecordStructInstance>>& params_types) {
+    auto name = std::static_pointer_cast<AST::IdentifierLiteral>(call_expression->name)->value;
+    auto fail = [&](const std::string& message) {
+        errors::CompletionError("Invalid arguments", this->source, call_expression->meta_data.st_line_no, call_expression->meta_data.end_line_no, message).raise();
+        exit(1);
+    };
+    auto mask_of = [&](llvm::FixedVectorType* vector_type) {
+        return this->_vectorType(std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("bool")), vector_type->getNumElements());
+    };
+    auto is_int = [&](size_t idx) { return idx < params_types.size() && this->_checkType(params_types[idx], this->enviornment.get_struct("int")); };
+    auto data_layout = this->llvm_module->getDataLayout();
+    // vector accesses into array storage only assume the alignment of one element
+    auto element_pointer = [&](std::shared_ptr<enviornment::RecordStructType> vector_record, size_t array_idx) -> std::tuple<llvm::Value*, llvm::Align> {
+        auto vector_type = llvm::cast<llvm::FixedVectorType>(vector_record->stand_alone_type);
+        auto element = vector_type->getElementType();
+        if (!this->_checkType(params_types[array_idx], this->enviornment.get_struct("array")) || params_types[array_idx]->generic.empty() ||
+            !this->_checkType(params_types[array_idx]->generic[0], vector_record->generic_arguments[0]) || !is_int(array_idx + 1)) {
+            fail(name + " expects an array of the vector's lane type and an int offset");
+        }
+        auto mask = args.size() == array_idx + 3 ? args[array_idx + 2] : nullptr;
+        if (mask != nullptr && mask->getType() != mask_of(vector_type)->stand_alone_type) {
+            fail("The mask of " + name + " must have one lane per vector lane");
+        }
+        auto array = args[array_idx];
+        auto index = args[array_idx + 1];
+        if (this->bounds_checks) {
+            auto len = this->_arrayLength(array);
+            llvm::Value* in_bounds = nullptr;
+            llvm::Value* reported = index;
+            if (mask == nullptr) {
+                reported = this->llvm_ir_builder.CreateAdd(index, this->llvm_ir_builder.getInt64(vector_type->getNumElements() - 1));
+                in_bounds = this->llvm_ir_builder.CreateAnd(this->llvm_ir_builder.CreateICmpULT(index, len), this->llvm_ir_builder.CreateICmpULT(reported, len), "inbounds");
+            } else {
+                // only the enabled lanes have to be inside the array, that is what lets a masked access handle the tail of a loop
+                std::vector<llvm::Constant*> steps;
+                for (unsigned lane = 0; lane < vector_type->getNumElements(); ++lane) {
+                    steps.push_back(this->llvm_ir_builder.getInt64(lane));
+                }
+                auto lanes = this->llvm_ir_builder.CreateAdd(this->llvm_ir_builder.CreateVectorSplat(vector_type->getNumElements(), index), llvm::ConstantVector::get(steps));
+                auto outside = this->llvm_ir_builder.CreateICmpUGE(lanes, this->llvm_ir_builder.CreateVectorSplat(vector_type->getNumElements(), len));
+                in_bounds = this->llvm_ir_builder.CreateNot(this->llvm_ir_builder.CreateOrReduce(this->llvm_ir_builder.CreateAnd(mask, outside)), "inbounds");
+            }
+            this->_emitBoundsBranch(in_bounds, reported, len);
+        }
+        auto pointer = this->llvm_ir_builder.CreateGEP(element, this->_arrayData(array), index, "lanes");
+        return {pointer, data_layout.getABITypeAlign(element)};
+    };
+
+    if (this->enviornment.is_struct(name)) {
+        auto vector_record = this->enviornment.get_struct(name);
+        auto vector_type = llvm::cast<llvm::FixedVectorType>(vector_record->stand_alone_type);
+        auto lanes = vector_type->getNumElements();
+        auto vector_inst = std::make_shared<enviornment::RecordStructInstance>(vector_record);
+        if ((args.size() == 2 || args.size() == 3) && this->_checkType(params_types[0], this->enviornment.get_struct("array"))) {
+            // f64x4(xs, i) loads xs[i] to xs[i + 3], f64x4(xs, i, m) only loads the lanes enabled in m and zeroes the others
+            auto [pointer, align] = element_pointer(vector_record, 0);
+            if (args.size() == 3) {
+                return {{this->llvm_ir_builder.CreateMaskedLoad(vector_type, pointer, align, args[2], llvm::Constant::getNullValue(vector_type))}, vector_inst};
+            }
+            return {{this->llvm_ir_builder.CreateAlignedLoad(vector_type, pointer, align)}, vector_inst};
+        }
+        if (args.size() == 1) {
+            return {{this->llvm_ir_builder.CreateVectorSplat(lanes, this->_toVectorLane(args[0], params_types[0], vector_record, call_expression))}, vector_inst};
+        }
+        if (args.size() != lanes) {
+            fail(name + " takes one value per lane, a single value for every lane or an array and an offset");
+        }
+        llvm::Value* vector = llvm::PoisonValue::get(vector_type);
+        for (unsigned lane = 0; lane < lanes; ++lane) {
+            vector = this->llvm_ir_builder.CreateInsertElement(vector, this->_toVectorLane(args[lane], params_types[lane], vector_record, call_expression), lane);
+        }
+        return {{vector}, vector_inst};
+    }
+    if (args.empty() || !this->_isVector(params_types[name == "select" ? 1 : 0])) {
+        fail(name + " expects a vector");
+    }
+    auto vector_type = llvm::cast<llvm::FixedVectorType>(args[name == "select" ? 1 : 0]->getType());
+    auto void_inst = std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("void"));
+    if (name == "store") {
+        // store(v, xs, i) writes every lane to xs[i..], store(v, xs, i, m) only the lanes enabled in m
+        if (args.size() != 3 && args.size() != 4) {
+            fail("store expects a vector, an array, an offset and optionally a mask");
+        }
+        auto [pointer, align] = element_pointer(params_types[0]->struct_type, 1);
+        if (args.size() == 4) {
+            return {{this->llvm_ir_builder.CreateMaskedStore(args[0], pointer, align, args[3])}, void_inst};
+        }
+        return {{this->llvm_ir_builder.CreateAlignedStore(args[0], pointer, align)}, void_inst};
+    }
+    if (name == "select") {
+        // select(m, a, b) takes each lane from a where m is set and from b elsewhere
+        if (args.size() != 3 || args[0]->getType() != mask_of(vector_type)->stand_alone_type || !this->_checkType(params_types[1], params_types[2])) {
+            fail("select expects a mask and two vectors of the same type");
+        }
+        return {{this->llvm_ir_builder.CreateSelect(args[0], args[1], args[2])}, params_types[1]};
+    }
+    if (name == "shuffle") {
+        // shuffle(v, 3, 2, 1, 0) picks lanes of v, shuffle(a, b, ...) numbers the lanes of b after those of a
+        bool two_sources = args.size() > 1 && this->_checkType(params_types[0], params_types[1]);
+        auto source_lanes = vector_type->getNumElements() * (two_sources ? 2 : 1);
+        std::vector<int> lanes;
+        for (size_t idx = two_sources ? 2 : 1; idx < args.size(); ++idx) {
+            auto lane = llvm::dyn_cast<llvm::ConstantInt>(args[idx]);
+            if (lane == nullptr || lane->getValue().uge(source_lanes)) {
+                fail("shuffle lanes must be constants below " + std::to_string(source_lanes));
+            }
+            lanes.push_back(lane->getZExtValue());
+        }
+        auto result_type = this->_vectorType(params_types[0]->struct_type->generic_arguments[0], lanes.size());
+        if (lanes.empty() || result_type == nullptr) {
+            fail("shuffle result of " + std::to_string(lanes.size()) + " lanes is not a vector type");
+        }
+        auto shuffle = this->llvm_ir_builder.CreateShuffleVector(args[0], two_sources ? args[1] : llvm::PoisonValue::get(vector_type), lanes);
+        return {{shuffle}, std::make_shared<enviornment::RecordStructInstance>(result_type)};
+    }
+    // horizontal reductions, floating point sums and products are reassociated into a tree like any hand written SIMD kernel
+    if (args.size() != 1) {
+        fail(name + " expects a single vector");
+    }
+    auto element = vector_type->getElementType();
+    bool is_float = element->isFloatingPointTy();
+    bool is_mask = element->isIntegerTy(1);
+    bool is_unsigned = params_types[0]->struct_type->is_unsigned;
+    llvm::Value* result = nullptr;
+    if (name == "reduce_add" && !is_mask) {
+        result = is_float ? this->llvm_ir_builder.CreateFAddReduce(llvm::ConstantFP::getNegativeZero(element), args[0]) : this->llvm_ir_builder.CreateAddReduce(args[0]);
+    } else if (name == "reduce_mul" && !is_mask) {
+        result = is_float ? this->llvm_ir_builder.CreateFMulReduce(llvm::ConstantFP::get(element, 1.0), args[0]) : this->llvm_ir_builder.CreateMulReduce(args[0]);
+    } else if (name == "reduce_min" && !is_mask) {
+        result = is_float ? this->llvm_ir_builder.CreateFPMinReduce(args[0]) : this->llvm_ir_builder.CreateIntMinReduce(args[0], !is_unsigned);
+    } else if (name == "reduce_max" && !is_mask) {
+        result = is_float ? this->llvm_ir_builder.CreateFPMaxReduce(args[0]) : this->llvm_ir_builder.CreateIntMaxReduce(args[0], !is_unsigned);
+    } else if (name == "reduce_and" && !is_float) {
+        result = this->llvm_ir_builder.CreateAndReduce(args[0]);
+    } else if (name == "reduce_or" && !is_float) {
+        result = this->llvm_ir_builder.CreateOrReduce(args[0]);
+    } else if (name == "reduce_xor" && !is_float) {
+        result = this->llvm_ir_builder.CreateXorReduce(args[0]);
+    } else {
+        fail(name + " is not a reduction of " + params_types[0]->struct_type->name);
+    }
+    if (is_float && (name == "reduce_add" || name == "reduce_mul")) {
+        llvm::cast<llvm::Instruction>(result)->setHasAllowReassoc(true);
+    }
+    return {{result}, params_types[0]->struct_type->generic_arguments[0]};
+};
+
+std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::RecordStructInstance>, std::shared_ptr<enviornment::RecordModule>>> compiler::Compiler::_emitVectorOperation(
+    std::shared_ptr<AST::InfixExpression> infixed_expression, llvm::Value* left_val, std::shared_ptr<enviornment::RecordStructInstance> left_type, llvm::Value* right_val,
+    std::shared_ptr<enviornment::RecordStructInstance> right_type) {
+    auto op = infixed_expression->op;
+    auto vector_inst = this->_isVector(left_type) ? left_type : right_type;
+    auto vector_type = llvm::cast<llvm::FixedVectorType>(vector_inst->struct_type->stand_alone_type);
+    auto element = vector_type->getElementType();
+    // a scalar operand is broadcast to every lane, `v * 0.5` scales the whole vector
+    if (!this->_isVector(left_type)) {
+        left_val = this->llvm_ir_builder.CreateVectorSplat(vector_type->getNumElements(), this->_toVectorLane(left_val, left_type, vector_inst->struct_type, infixed_expression));
+    } else if (!this->_isVector(right_type)) {
+        right_val = this->llvm_ir_builder.CreateVectorSplat(vector_type->getNumElements(), this->_toVectorLane(right_val, right_type, vector_inst->struct_type, infixed_expression));
+    } else if (!this->_checkType(left_type, right_type)) {
+        errors::CompletionError("Type mismatch", this->source, infixed_expression->meta_data.st_line_no, infixed_expression->meta_data.end_line_no,
+                                left_type->struct_type->name + " and " + right_type->struct_type->name + " have different lanes")
+            .raise();
+    }
+    bool is_float = element->isFloatingPointTy();
+    bool is_mask = element->isIntegerTy(1);
+    bool is_unsigned = vector_inst->struct_type->is_unsigned;
+    auto mask_inst = std::make_shared<enviornment::RecordStructInstance>(
+        this->_vectorType(std::make_shared<enviornment::RecordStructInstance>(this->enviornment.get_struct("bool")), vector_type->getNumElements()));
+    std::optional<llvm::Instruction::BinaryOps> opcode;
+    std::optional<llvm::CmpInst::Predicate> predicate;
+    switch (op) {
+        case token::TokenType::Plus:
+            opcode = is_float ? llvm::Instruction::FAdd : llvm::Instruction::Add;
+            break;
+        case token::TokenType::Dash:
+            opcode = is_float ? llvm::Instruction::FSub : llvm::Instruction::Sub;
+            break;
+        case token::TokenType::Asterisk:
+            opcode = is_float ? llvm::Instruction::FMul : llvm::Instruction::Mul;
+            break;
+        case token::TokenType::ForwardSlash:
+            opcode = is_float ? llvm::Instruction::FDiv : is_unsigned ? llvm::Instruction::UDiv : llvm::Instruction::SDiv;
+            break;
+        case token::TokenType::Percent:
+            opcode = is_float ? llvm::Instruction::FRem : is_unsigned ? llvm::Instruction::URem : llvm::Instruction::SRem;
+            break;
+        case token::TokenType::And:
+            opcode = llvm::Instruction::And;
+            break;
+        case token::TokenType::Or:
+            opcode = llvm::Instruction::Or;
+            break;
+        case token::TokenType::BitwiseAnd:
+            opcode = llvm::Instruction::And;
+            break;
+        case token::TokenType::BitwiseOr:
+            opcode = llvm::Instruction::Or;
+            break;
+        case token::TokenType::BitwiseXor:
+            opcode = llvm::Instruction::Xor;
+            break;
+        case token::TokenType::LeftShift:
+            opcode = llvm::Instruction::Shl;
+            break;
+        case token::TokenType::RightShift:
+            opcode = is_unsigned ? llvm::Instruction::LShr : llvm::Instruction::AShr;
+            break;
+        case token::TokenType::EqualEqual:
+            predicate = is_float ? llvm::CmpInst::FCMP_OEQ : llvm::CmpInst::ICMP_EQ;
+            break;
+        case token::TokenType::NotEquals:
+            predicate = is_float ? llvm::CmpInst::FCMP_ONE : llvm::CmpInst::ICMP_NE;
+            break;
+        case token::TokenType::LessThan:
+            predicate = is_float ? llvm::CmpInst::FCMP_OLT : is_unsigned ? llvm::CmpInst::ICMP_ULT : llvm::CmpInst::ICMP_SLT;
+            break;
+        case token::TokenType::GreaterThan:
+            predicate = is_float ? llvm::CmpInst::FCMP_OGT : is_unsigned ? llvm::CmpInst::ICMP_UGT : llvm::CmpInst::ICMP_SGT;
+            break;
+        case token::TokenType::LessThanOrEqual:
+            predicate = is_float ? llvm::CmpInst::FCMP_OLE : is_unsigned ? llvm::CmpInst::ICMP_ULE : llvm::CmpInst::ICMP_SLE;
+            break;
+        case token::TokenType::GreaterThanOrEqual:
+            predicate = is_float ? llvm::CmpInst::FCMP_OGE : is_unsigned ? llvm::CmpInst::ICMP_UGE : llvm::CmpInst::ICMP_SGE;
+            break;
+        default:
+            break;
+    }
+    // masks combine with `and`, `or` and (in)equality, bitwise operators need integer lanes
+    bool mask_op = op == token::TokenType::And || op == token::TokenType::Or;
+    bool bitwise_op = op == token::TokenType::BitwiseAnd || op == token::TokenType::BitwiseOr || op == token::TokenType::BitwiseXor || op == token::TokenType::LeftShift ||
+                      op == token::TokenType::RightShift;
+    if ((!opcode && !predicate) || (is_mask && !mask_op && op != token::TokenType::EqualEqual && op != token::TokenType::NotEquals) || (!is_mask && mask_op) || (is_float && bitwise_op)) {
+        errors::CompletionError("Invalid operator", this->source, infixed_expression->meta_data.st_line_no, infixed_expression->meta_data.end_line_no,
+                                vector_inst->struct_type->name + " does not support " + *token::tokenTypeString(op))
+            .raise();
     }
-    this->enviornment.add(func_record);
+    if (predicate) {
+        return {{this->llvm_ir_builder.CreateCmp(*predicate, left_val, right_val)}, mask_inst};
+    }
+    if (op == token::TokenType::LeftShift || op == token::TokenType::RightShift) {
+        right_val = this->llvm_ir_builder.CreateAnd(right_val, llvm::ConstantInt::get(vector_type, element->getIntegerBitWidth() - 1));
+    }
+    return {{this->llvm_ir_builder.CreateBinOp(*opcode, left_val, right_val)}, vector_inst};
 };
 
-std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::RecordStructInstance>, std::shared_ptr<enviornment::RecordModule>>> compiler::Compiler::_visitCallExpression(std::shared_ptr<AST::CallExpression> call_expression) {
-    auto name = std::static_pointer_cast<AST::IdentifierLiteral>(call_expression->name)->value;
-    auto param = call_expression->arguments;
-    std::vector<llvm::Value*> args;
-    std::vector<std::shared_ptr<enviornment::RecordStructInstance>> params_types;
-    for(auto arg : param) {
-        auto [value, param_type] = this->_resolveValue(arg);
-        if (value.empty()) {
-            std::cerr << "Cant pass Module to the Function" << std::endl;
-            exit(1);
+bool compiler::Compiler::_isVector(std::shared_ptr<enviornment::RecordStructInstance> type) {
+    return type->struct_type->stand_alone_type != nullptr && type->struct_type->stand_alone_type->isVectorTy();
+};
+
+std::shared_ptr<enviornment::RecordStructType> compiler::Compiler::_vectorType(std::shared_ptr<enviornment::RecordStructInstance> lane_type, unsigned lanes) {
+    for (auto vector : this->vector_types) {
+        if (llvm::cast<llvm::FixedVectorType>(vector->stand_alone_type)->getNumElements() == lanes && this->_checkType(vector->generic_arguments[0], lane_type)) {
+            return vector;
         }
-        params_types.push_back(std::get<std::shared_ptr<enviornment::RecordStructInstance>>(param_type));
-        args.push_back(value[0]);
     }
-    if(this->enviornment.is_function(name)) {
-        auto func_record = this->enviornment.get_function(name);
-        if (!_checkFunctionParameterType(func_record, params_types)) {
-            std::cerr << "Function Parameter Type Mismatch for function: " << name << std::endl;
+    return nullptr;
+};
+
+llvm::Value* compiler::Compiler::_toVectorLane(llvm::Value* value, std::shared_ptr<enviornment::RecordStructInstance> type, std::shared_ptr<enviornment::RecordStructType> vector,
+                                              std::shared_ptr<AST::Node> node) {
+    auto lane_type = vector->generic_arguments[0];
+    auto [lane, cast_type] = this->_implicitCast(value, type, lane_type, node);
+    if (!this->_checkType(cast_type, lane_type)) {
+        errors::CompletionError("Type mismatch", this->source, node->meta_data.st_line_no, node->meta_data.end_line_no,
+                                vector->name + " lanes are " + lane_type->struct_type->name + ", not " + type->struct_type->name)
+            .raise();
+    }
+    return lane;
+};
+
+std::tuple<llvm::Value*, std::shared_ptr<enviornment::RecordStructInstance>> compiler::Compiler::_implicitCast(llvm::Value* value, std::shared_ptr<enviornment::RecordStructInstance> type,
+                                                                                                            std::shared_ptr<enviornment::RecordStructInstance> target,
+                                                                                                            std::shared_ptr<AST::Node> node) {
+    // Literals take the type they are used as, `x: u8 = 200` and `f(1)` for an i32 parameter need no cast. Every other
+    // value keeps its type and the caller reports a mismatch.
+    auto target_type = target->struct_type->stand_alone_type;
+    if (target_type == nullptr || this->_isVector(target) || this->_checkType(type, target)) {
+        return {value, type};
+    }
+    if (llvm::isa<llvm::ConstantInt>(value) && type->struct_type == this->enviornment.get_struct("int") && target_type->isIntegerTy() && !target_type->isIntegerTy(1)) {
+        auto literal = llvm::cast<llvm::ConstantInt>(value)->getValue();
+        auto bits = target_type->getIntegerBitWidth();
+        bool fits = target->struct_type->is_unsigned ? literal.isNonNegative() && literal.getActiveBits() <= bits : literal.getMinSignedBits() <= bits;
+        if (!fits && node == nullptr) {
+            std::cerr << literal.getSExtValue() << " does not fit in " << target->struct_type->name << std::endl;
             exit(1);
         }
-        auto returnValue = this->llvm_ir_builder.CreateCall(
-            func_record->function, args);
-        return {{returnValue}, func_record->return_inst};
+        if (!fits) {
+            errors::CompletionError("Literal out of range", this->source, node->meta_data.st_line_no, node->meta_data.end_line_no,
+                                    std::to_string(literal.getSExtValue()) + " does not fit in " + target->struct_type->name)
+                .raise();
+        }
+        return {llvm::ConstantInt::get(target_type, literal.trunc(bits)), target};
     }
-    else if (this->enviornment.is_struct(name)) {
-        auto struct_record = this->enviornment.get_struct(name);
-        auto struct_type = struct_record->struct_type;
-        auto alloca = this->llvm_ir_builder.CreateAlloca(struct_type, nullptr, name);
-        for (unsigned int i = 0; i < args.size(); ++i) {
-            if (!this->_checkType(struct_record->sub_types[struct_record->fields[i]], params_types[i])) {
-                std::cerr << "Struct Type MissMatch" << std::endl;
-                exit(1);
+    if (llvm::isa<llvm::ConstantFP>(value) && type->struct_type == this->enviornment.get_struct("float") && target_type->isFloatTy()) {
+        return {llvm::ConstantFP::get(target_type, llvm::cast<llvm::ConstantFP>(value)->getValueAPF().convertToDouble()), target};
+    }
+    return {value, type};
+};
+
+void compiler::Compiler::_implicitCastArguments(std::shared_ptr<enviornment::RecordFunction> func_record, std::vector<llvm::Value*>& args,
+                                                std::vector<std::shared_ptr<enviornment::RecordStructInstance>>& params_types, std::shared_ptr<AST::Node> node) {
+    if (func_record->c_abi && args.size() != func_record->arguments.size()) {
+        // a C function reads whatever registers hold its parameters, a missing or extra argument is never caught later
+        errors::CompletionError("Argument count mismatch", this->source, node->meta_data.st_line_no, node->meta_data.end_line_no,
+                                "Function `" + func_record->name + "` expects " + std::to_string(func_record->arguments.size()) + " arguments but got " +
+                                    std::to_string(args.size()))
+            .raise();
+    }
+    for (size_t idx = 0; idx < args.size() && idx < func_record->arguments.size(); ++idx) {
+        auto param = std::get<1>(func_record->arguments[idx]);
+        if (param != nullptr && param->variableType != nullptr) {
+            auto param_type = param->variableType->struct_type->stand_alone_type;
+            if (func_record->c_abi && llvm::isa<llvm::ConstantInt>(args[idx]) && params_types[idx]->struct_type == this->enviornment.get_struct("int") &&
+                param_type != nullptr && param_type->isFloatingPointTy()) {
+                // C converts `sqrt(16)` to sqrt(16.0), extern calls do the same for integer literals
+                args[idx] = llvm::ConstantFP::get(param_type, static_cast<double>(llvm::cast<llvm::ConstantInt>(args[idx])->getSExtValue()));
+                params_types[idx] = param->variableType;
+            }
+            std::tie(args[idx], params_types[idx]) = this->_implicitCast(args[idx], params_types[idx], param->variableType, node);
+            // only literals convert implicitly, a non-literal of another scalar type would reach the call with the wrong LLVM type
+            auto expected = param->variableType->struct_type->stand_alone_type;
+            auto passed = args[idx]->getType();
+            if (expected != nullptr && passed != expected && !(expected->isPointerTy() && passed->isPointerTy())) {
+                errors::CompletionError("Function Parameter Type Mismatch", this->source, node->meta_data.st_line_no, node->meta_data.end_line_no,
+                                        "Argument `" + std::get<0>(func_record->arguments[idx]) + "` expects " + param->variableType->struct_type->name + " but got " +
+                                            params_types[idx]->struct_type->name + ", convert it with " + param->variableType->struct_type->name + "(...)")
+                    .raise();
             }
-            auto field_ptr = this->llvm_ir_builder.CreateStructGEP(struct_type, alloca, i);
-            auto storeInst = this->llvm_ir_builder.CreateStore(args[i], field_ptr);
         }
-        return {{alloca}, std::make_shared<enviornment::RecordStructInstance>(struct_record)};
     }
-    errors::CompletionError("Function not defined", this->source, call_expression->meta_data.st_line_no, call_expression->meta_data.end_line_no,
-                            "Function `" + name + "` not defined")
-        .raise();
-    exit(1);
+};
+
+std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::RecordStructInstance>, std::shared_ptr<enviornment::RecordModule>>> compiler::Compiler::_visitCastBuiltin(
+    std::shared_ptr<AST::CallExpression> call_expression, const std::vector<llvm::Value*>& args, const std::vector<std::shared_ptr<enviornment::RecordStructInstance>>& params_types) {
+    // T(x) converts between the numeric types, bool and char. Integers widen by the signedness of the source, floats
+    // convert to integers with saturation (NaN becomes 0) so an out of range value is never poison.
+    auto name = std::static_pointer_cast<AST::IdentifierLiteral>(call_expression->name)->value;
+    auto target = this->enviornment.get_struct(name);
+    auto target_inst = std::make_shared<enviornment::RecordStructInstance>(target);
+    auto to = target->stand_alone_type;
+    if (args.size() != 1 || params_types[0]->struct_type->stand_alone_type == nullptr || this->_isVector(params_types[0]) ||
+        !(params_types[0]->struct_type->stand_alone_type->isIntegerTy() || params_types[0]->struct_type->stand_alone_type->isFloatingPointTy())) {
+        errors::CompletionError("Invalid arguments", this->source, call_expression->meta_data.st_line_no, call_expression->meta_data.end_line_no,
+                                name + "(x) converts a single number, bool or char")
+            .raise();
+    }
+    auto value = args[0];
+    auto from = value->getType();
+    bool from_unsigned = params_types[0]->struct_type->is_unsigned || from->isIntegerTy(1);
+    if (from == to) {
+        return {{value}, target_inst};
+    }
+    if (to->isIntegerTy(1)) {
+        auto zero = llvm::Constant::getNullValue(from);
+        return {{from->isFloatingPointTy() ? this->llvm_ir_builder.CreateFCmpUNE(value, zero) : this->llvm_ir_builder.CreateICmpNE(value, zero)}, target_inst};
+    }
+    if (from->isIntegerTy() && to->isIntegerTy()) {
+        return {{this->llvm_ir_builder.CreateIntCast(value, to, !from_unsigned)}, target_inst};
+    }
+    if (from->isIntegerTy()) {
+        return {{from_unsigned ? this->llvm_ir_builder.CreateUIToFP(value, to) : this->llvm_ir_builder.CreateSIToFP(value, to)}, target_inst};
+    }
+    if (to->isFloatingPointTy()) {
+        return {{this->llvm_ir_builder.CreateFPCast(value, to)}, target_inst};
+    }
+    auto saturate = target->is_unsigned ? llvm::Intrinsic::fptoui_sat : llvm::Intrinsic::fptosi_sat;
+    return {{this->llvm_ir_builder.CreateIntrinsic(saturate, {to, from}, {value})}, target_inst};
 };
 
 void compiler::Compiler::_visitIfElseStatement(std::shared_ptr<AST::IfElseStatement> if_statement) {
@@ -1043,29 +3119,53 @@ void compiler::Compiler::_visitIfElseStatement(std::shared_ptr<AST::IfElseStatem
         std::cerr << "Condition type Must be Bool" << std::endl;
         exit(1);
     }
+    // facts learned inside a branch do not hold after the merge
+    auto checked_indices = this->enviornment.checked_indices;
+    auto array_min_lengths = this->enviornment.array_min_lengths;
     if(alternative == nullptr) {
         auto func = this->llvm_ir_builder.GetInsertBlock()->getParent();
         llvm::BasicBlock* ThenBB = llvm::BasicBlock::Create(llvm_context, "then", func);
         llvm::BasicBlock* ContBB = llvm::BasicBlock::Create(llvm_context, "cont", func);
-        auto condBr = this->llvm_ir_builder.CreateCondBr(condition_val[0], ThenBB, ContBB);
+        this->_emitCondBr(condition_val[0], ThenBB, ContBB);
         this->llvm_ir_builder.SetInsertPoint(ThenBB);
         this->compile(consequence);
-        auto brThen = this->llvm_ir_builder.CreateBr(ContBB);
+        if (this->llvm_ir_builder.GetInsertBlock()->getTerminator() == nullptr) {
+            this->llvm_ir_builder.CreateBr(ContBB);
+        }
         this->llvm_ir_builder.SetInsertPoint(ContBB);
     } else {
         auto func = this->llvm_ir_builder.GetInsertBlock()->getParent();
         llvm::BasicBlock* ThenBB = llvm::BasicBlock::Create(llvm_context, "then", func);
         llvm::BasicBlock* ElseBB = llvm::BasicBlock::Create(llvm_context, "else", func);
         llvm::BasicBlock* ContBB = llvm::BasicBlock::Create(llvm_context, "cont", func);
-        auto condBr = this->llvm_ir_builder.CreateCondBr(condition_val[0], ThenBB, ElseBB);
+        this->_emitCondBr(condition_val[0], ThenBB, ElseBB);
         this->llvm_ir_builder.SetInsertPoint(ThenBB);
         this->compile(consequence);
-        auto brThen = this->llvm_ir_builder.CreateBr(ContBB);
+        if (this->llvm_ir_builder.GetInsertBlock()->getTerminator() == nullptr) {
+            this->llvm_ir_builder.CreateBr(ContBB);
+        }
+        this->enviornment.checked_indices = checked_indices;
+        this->enviornment.array_min_lengths = array_min_lengths;
         this->llvm_ir_builder.SetInsertPoint(ElseBB);
         this->compile(alternative);
-        auto brElse = this->llvm_ir_builder.CreateBr(ContBB);
+        if (this->llvm_ir_builder.GetInsertBlock()->getTerminator() == nullptr) {
+            this->llvm_ir_builder.CreateBr(ContBB);
+        }
         this->llvm_ir_builder.SetInsertPoint(ContBB);
     }
+    this->enviornment.checked_indices = checked_indices;
+    this->enviornment.array_min_lengths = array_min_lengths;
+    this->_invalidateBoundsFacts(if_statement);
+};
+
+// A constant condition (`True`, `1 < 2`) becomes an unconditional branch, the block that never runs is left without
+// predecessors and dropped by LLVM, so `while True` loops have no condition check at all.
+void compiler::Compiler::_emitCondBr(llvm::Value* condition, llvm::BasicBlock* true_block, llvm::BasicBlock* false_block) {
+    if (auto constant = llvm::dyn_cast<llvm::ConstantInt>(condition)) {
+        this->llvm_ir_builder.CreateBr(constant->isOne() ? true_block : false_block);
+        return;
+    }
+    this->llvm_ir_builder.CreateCondBr(condition, true_block, false_block);
 };
 
 void compiler::Compiler::_visitWhileStatement(std::shared_ptr<AST::WhileStatement> while_statement) {
@@ -1075,6 +3175,10 @@ void compiler::Compiler::_visitWhileStatement(std::shared_ptr<AST::WhileStatemen
     llvm::BasicBlock* CondBB = llvm::BasicBlock::Create(llvm_context, "cond", func);
     llvm::BasicBlock* BodyBB = llvm::BasicBlock::Create(llvm_context, "body", func);
     llvm::BasicBlock* ContBB = llvm::BasicBlock::Create(llvm_context, "cont", func);
+    // only facts the loop never invalidates hold on every iteration and after it
+    this->_invalidateBoundsFacts(while_statement);
+    auto checked_indices = this->enviornment.checked_indices;
+    auto array_min_lengths = this->enviornment.array_min_lengths;
     auto brToCond = this->llvm_ir_builder.CreateBr(CondBB);
     this->llvm_ir_builder.SetInsertPoint(CondBB);
     auto [condition_val, _condition] = this->_resolveValue(condition);
@@ -1087,25 +3191,628 @@ void compiler::Compiler::_visitWhileStatement(std::shared_ptr<AST::WhileStatemen
         std::cerr << "Condition type Must be Bool" << std::endl;
         exit(1);
     }
-    auto condBr = this->llvm_ir_builder.CreateCondBr(condition_val[0], BodyBB, ContBB);
+    this->_emitCondBr(condition_val[0], BodyBB, ContBB);
     this->enviornment.loop_body_block.push_back(BodyBB);
     this->enviornment.loop_end_block.push_back(ContBB);
     this->enviornment.loop_condition_block.push_back(CondBB);
+    this->enviornment.loop_arena_depth.push_back(this->enviornment.arenas.size());
     this->llvm_ir_builder.SetInsertPoint(BodyBB);
     this->compile(body);
     this->enviornment.loop_body_block.pop_back();
     this->enviornment.loop_end_block.pop_back();
     this->enviornment.loop_condition_block.pop_back();
-    auto brToCondAgain = this->llvm_ir_builder.CreateBr(CondBB);
+    this->enviornment.loop_arena_depth.pop_back();
+    this->enviornment.checked_indices = checked_indices;
+    this->enviornment.array_min_lengths = array_min_lengths;
+    if (this->llvm_ir_builder.GetInsertBlock()->getTerminator() == nullptr) {
+        this->llvm_ir_builder.CreateBr(CondBB);
+    }
+    this->llvm_ir_builder.SetInsertPoint(ContBB);
+};
+
+void compiler::Compiler::_visitForStatement(std::shared_ptr<AST::ForStatement> for_statement) {
+    auto variable_name = std::static_pointer_cast<AST::IdentifierLiteral>(for_statement->variable)->value;
+    auto iterable = for_statement->iterable;
+    if (iterable->type() == AST::NodeType::CallExpression && std::static_pointer_cast<AST::IdentifierLiteral>(std::static_pointer_cast<AST::CallExpression>(iterable)->name)->value == "lines" &&
+        !this->enviornment.is_function("lines")) {
+        return this->_visitLinesLoop(for_statement, std::static_pointer_cast<AST::CallExpression>(iterable));
+    }
+    auto int_type = this->enviornment.get_struct("int");
+    auto func = this->llvm_ir_builder.GetInsertBlock()->getParent();
+    // Both forms lower to one counted loop: iv runs from start towards end by step
+    llvm::Value* start = this->llvm_ir_builder.getInt64(0);
+    llvm::Value* end = nullptr;
+    llvm::Value* step = this->llvm_ir_builder.getInt64(1);
+    llvm::Value* array = nullptr;
+    std::shared_ptr<enviornment::RecordStructInstance> element_type = nullptr;
+    std::vector<std::shared_ptr<AST::Expression>> range_arguments = {};
+    if (iterable->type() == AST::NodeType::CallExpression && std::static_pointer_cast<AST::IdentifierLiteral>(std::static_pointer_cast<AST::CallExpression>(iterable)->name)->value == "range" &&
+        !this->enviornment.is_function("range")) {
+        auto arguments = std::static_pointer_cast<AST::CallExpression>(iterable)->arguments;
+        range_arguments = arguments;
+        if (arguments.empty() || arguments.size() > 3) {
+            errors::CompletionError("Invalid range", this->source, iterable->meta_data.st_line_no, iterable->meta_data.end_line_no, "range expects 1 to 3 arguments").raise();
+        }
+        std::vector<llvm::Value*> bounds;
+        for (auto argument : arguments) {
+            auto [value, _value_type] = this->_resolveValue(argument);
+            if (value.empty() || !this->_checkType(std::get<std::shared_ptr<enviornment::RecordStructInstance>>(_value_type), int_type)) {
+                errors::CompletionError("Invalid range", this->source, argument->meta_data.st_line_no, argument->meta_data.end_line_no, "range arguments must be int").raise();
+            }
+            bounds.push_back(value[0]);
+        }
+        if (bounds.size() == 1) {
+            end = bounds[0];
+        } else {
+            start = bounds[0];
+            end = bounds[1];
+        }
+        if (bounds.size() == 3) {
+            step = bounds[2];
+        }
+        element_type = std::make_shared<enviornment::RecordStructInstance>(int_type);
+    } else {
+        auto [value, _value_type] = this->_resolveValue(iterable);
+        if (value.empty()) {
+            std::cerr << "Cant iterate over Module" << std::endl;
+            exit(1);
+        }
+        auto array_type = std::get<std::shared_ptr<enviornment::RecordStructInstance>>(_value_type);
+        if (!this->_checkType(array_type, this->enviornment.get_struct("array")) || array_type->generic.empty()) {
+            errors::CompletionError("Not iterable", this->source, iterable->meta_data.st_line_no, iterable->meta_data.end_line_no,
+                                    "Type `" + array_type->struct_type->name + "` is not iterable")
+                .raise();
+        }
+        // rooted so the loop keeps the array alive even if the body reassigns the variable it came from
+        array = this->_gcRootTemp(value[0], array_type);
+        end = this->_arrayLength(array);
+        element_type = array_type->generic[0];
+    }
+    if (auto constant_step = llvm::dyn_cast<llvm::ConstantInt>(step); constant_step && constant_step->isZero()) {
+        errors::CompletionError("Invalid range", this->source, iterable->meta_data.st_line_no, iterable->meta_data.end_line_no, "range step cannot be zero").raise();
+    }
+    if (!llvm::isa<llvm::ConstantInt>(step)) {
+        // a step that is only known at runtime would never move the variable if it were zero
+        llvm::BasicBlock* FailBB = llvm::BasicBlock::Create(llvm_context, "range.fail", func);
+        llvm::BasicBlock* OkBB = llvm::BasicBlock::Create(llvm_context, "range.ok", func);
+        this->llvm_ir_builder.CreateCondBr(this->llvm_ir_builder.CreateICmpNE(step, this->llvm_ir_builder.getInt64(0), "step.nonzero"), OkBB, FailBB,
+                                          llvm::MDBuilder(this->llvm_context).createBranchWeights(1 << 20, 1));
+        this->llvm_ir_builder.SetInsertPoint(FailBB);
+        this->llvm_ir_builder.CreateCall(this->llvm_module->getFunction("gigly_range_step_fail"));
+        this->llvm_ir_builder.CreateUnreachable();
+        this->llvm_ir_builder.SetInsertPoint(OkBB);
+    }
+    this->_invalidateBoundsFacts(for_statement->body);
+    auto induction = this->_createEntryBlockAlloca(int_type->stand_alone_type, nullptr, variable_name + ".iv");
+    this->llvm_ir_builder.CreateStore(start, induction);
+    llvm::BasicBlock* CondBB = llvm::BasicBlock::Create(llvm_context, "for.cond", func);
+    llvm::BasicBlock* BodyBB = llvm::BasicBlock::Create(llvm_context, "for.body", func);
+    llvm::BasicBlock* LatchBB = llvm::BasicBlock::Create(llvm_context, "for.latch", func);
+    llvm::BasicBlock* ContBB = llvm::BasicBlock::Create(llvm_context, "for.end", func);
+    this->llvm_ir_builder.CreateBr(CondBB);
+    this->llvm_ir_builder.SetInsertPoint(CondBB);
+    auto index = this->llvm_ir_builder.CreateLoad(int_type->stand_alone_type, induction, variable_name + ".index");
+    llvm::Value* condition = nullptr;
+    if (auto constant_step = llvm::dyn_cast<llvm::ConstantInt>(step)) {
+        condition = constant_step->isNegative() ? this->llvm_ir_builder.CreateICmpSGT(index, end) : this->llvm_ir_builder.CreateICmpSLT(index, end);
+    } else {
+        condition = this->llvm_ir_builder.CreateSelect(this->llvm_ir_builder.CreateICmpSGT(step, this->llvm_ir_builder.getInt64(0)), this->llvm_ir_builder.CreateICmpSLT(index, end),
+                                                       this->llvm_ir_builder.CreateICmpSGT(index, end));
+    }
+    this->llvm_ir_builder.CreateCondBr(condition, BodyBB, ContBB);
+    this->llvm_ir_builder.SetInsertPoint(BodyBB);
+    auto prev_env = std::make_shared<enviornment::Enviornment>(this->enviornment);
+    this->enviornment = enviornment::Enviornment(prev_env, {}, "for");
+    this->enviornment.current_function = prev_env->current_function;
+    this->enviornment.loop_body_block = prev_env->loop_body_block;
+    this->enviornment.loop_end_block = prev_env->loop_end_block;
+    this->enviornment.loop_condition_block = prev_env->loop_condition_block;
+    this->enviornment.loop_arena_depth = prev_env->loop_arena_depth;
+    this->enviornment.arenas = prev_env->arenas;
+    this->enviornment.checked_indices = prev_env->checked_indices;
+    this->enviornment.array_min_lengths = prev_env->array_min_lengths;
+    // the loop variable shadows anything facts were recorded about under its name
+    std::erase_if(this->enviornment.checked_indices, [&](const auto& fact) { return fact.first == variable_name || fact.second == variable_name; });
+    this->enviornment.array_min_lengths.erase(variable_name);
+    auto constant_start = llvm::dyn_cast<llvm::ConstantInt>(start);
+    auto constant_step = llvm::dyn_cast<llvm::ConstantInt>(step);
+    if (array == nullptr && constant_start && !constant_start->isNegative() && constant_step && constant_step->getSExtValue() > 0 &&
+        !this->_isMutated(for_statement->body, variable_name)) {
+        // counting up from a non-negative start keeps the variable in [start, end), which proves `a[i]` for every array at least end long
+        auto end_node = range_arguments.size() == 1 ? range_arguments[0] : range_arguments[1];
+        auto end_call = std::dynamic_pointer_cast<AST::CallExpression>(end_node);
+        if (end_call && std::static_pointer_cast<AST::IdentifierLiteral>(end_call->name)->value == "len" && !this->enviornment.is_function("len") && end_call->arguments.size() == 1 &&
+            end_call->arguments[0]->type() == AST::NodeType::IdentifierLiteral) {
+            auto array_name = std::static_pointer_cast<AST::IdentifierLiteral>(end_call->arguments[0])->value;
+            if (!this->_isMutated(for_statement->body, array_name)) {
+                this->enviornment.checked_indices.insert({array_name, variable_name});
+            }
+        } else if (auto constant_end = llvm::dyn_cast<llvm::ConstantInt>(end)) {
+            for (const auto& [array_name, length] : this->enviornment.array_min_lengths) {
+                if (constant_end->getSExtValue() <= length) {
+                    this->enviornment.checked_indices.insert({array_name, variable_name});
+                }
+            }
+        }
+    }
+    llvm::Value* variable = nullptr;
+    if (array == nullptr) {
+        variable = this->_createEntryBlockAlloca(int_type->stand_alone_type, nullptr, variable_name);
+        this->llvm_ir_builder.CreateStore(index, variable);
+    } else if (element_type->struct_type->stand_alone_type != nullptr) {
+        auto element = this->llvm_ir_builder.CreateGEP(element_type->struct_type->stand_alone_type, this->_arrayData(array), index, "element");
+        variable = this->_createEntryBlockAlloca(element_type->struct_type->stand_alone_type, nullptr, variable_name);
+        this->_gcRoot(variable, element_type);
+        this->llvm_ir_builder.CreateStore(this->llvm_ir_builder.CreateLoad(element_type->struct_type->stand_alone_type, element), variable);
+    } else {
+        // struct elements are borrowed in place only while the body writes no memory, an append could move the buffer
+        // and a store or call could change the element through the array
+        auto struct_type = element_type->struct_type->struct_type;
+        variable = this->llvm_ir_builder.CreateGEP(struct_type, this->_arrayData(array), index, "element");
+        if (this->_isMutated(for_statement->body, variable_name) || this->_mayWriteMemory(for_statement->body)) {
+            auto copy = this->_createEntryBlockAlloca(struct_type, nullptr, variable_name);
+            this->_gcRoot(copy, element_type);
+            this->llvm_ir_builder.CreateMemCpy(copy, llvm::MaybeAlign(), variable, llvm::MaybeAlign(), llvm::ConstantExpr::getSizeOf(struct_type));
+            variable = copy;
+        }
+    }
+    this->enviornment.add(std::make_shared<enviornment::RecordVariable>(variable_name, variable, variable, element_type));
+    this->enviornment.loop_body_block.push_back(BodyBB);
+    this->enviornment.loop_end_block.push_back(ContBB);
+    this->enviornment.loop_condition_block.push_back(LatchBB);
+    this->enviornment.loop_arena_depth.push_back(this->enviornment.arenas.size());
+    this->compile(for_statement->body);
+    this->enviornment = *prev_env;
+    if (this->llvm_ir_builder.GetInsertBlock()->getTerminator() == nullptr) {
+        this->llvm_ir_builder.CreateBr(LatchBB);
+    }
+    this->llvm_ir_builder.SetInsertPoint(LatchBB);
+    auto current = this->llvm_ir_builder.CreateLoad(int_type->stand_alone_type, induction);
+    llvm::Value* next = nullptr;
+    if (constant_step && constant_step->getValue().abs().isOne()) {
+        // the variable is strictly inside (end, start] or [start, end) here, so one more step cannot wrap
+        next = this->llvm_ir_builder.CreateNSWAdd(current, step, variable_name + ".next");
+    } else {
+        // a larger step can jump past the int range, which ends the loop instead of wrapping around
+        auto add = this->llvm_ir_builder.CreateBinaryIntrinsic(llvm::Intrinsic::sadd_with_overflow, current, step);
+        next = this->llvm_ir_builder.CreateExtractValue(add, 0, variable_name + ".next");
+        llvm::BasicBlock* StepBB = llvm::BasicBlock::Create(llvm_context, "for.step", func, ContBB);
+        this->llvm_ir_builder.CreateCondBr(this->llvm_ir_builder.CreateExtractValue(add, 1), ContBB, StepBB, llvm::MDBuilder(this->llvm_context).createBranchWeights(1, 1 << 20));
+        this->llvm_ir_builder.SetInsertPoint(StepBB);
+    }
+    this->llvm_ir_builder.CreateStore(next, induction);
+    auto backedge = this->llvm_ir_builder.CreateBr(CondBB);
+    backedge->setMetadata(llvm::LLVMContext::MD_loop, this->_loopMetadata());
+    this->llvm_ir_builder.SetInsertPoint(ContBB);
+};
+
+void compiler::Compiler::_visitLinesLoop(std::shared_ptr<AST::ForStatement> for_statement, std::shared_ptr<AST::CallExpression> lines_call) {
+    // `for line in lines(text)` splits a str, `for line in lines(fd)` or `lines(fd, buffer_size)` streams a file.
+    // Every line is a slice of the text or of the reader's current buffer, nothing is copied.
+    auto variable_name = std::static_pointer_cast<AST::IdentifierLiteral>(for_statement->variable)->value;
+    auto string_type = this->enviornment.get_struct("str");
+    auto int_type = this->enviornment.get_struct("int");
+    auto ptr_type = llvm::PointerType::get(this->llvm_context, 0);
+    auto func = this->llvm_ir_builder.GetInsertBlock()->getParent();
+    std::vector<llvm::Value*> arguments;
+    std::vector<std::shared_ptr<enviornment::RecordStructInstance>> argument_types;
+    for (auto argument : lines_call->arguments) {
+        auto [value, _value_type] = this->_resolveValue(argument);
+        if (value.empty()) {
+            std::cerr << "Cant iterate over Module" << std::endl;
+            exit(1);
+        }
+        arguments.push_back(value[0]);
+        argument_types.push_back(std::get<std::shared_ptr<enviornment::RecordStructInstance>>(_value_type));
+    }
+    bool over_string = arguments.size() == 1 && argument_types[0]->struct_type == string_type;
+    bool over_file = !arguments.empty() && arguments.size() <= 2 && argument_types[0]->struct_type == int_type &&
+                     (arguments.size() == 1 || argument_types[1]->struct_type == int_type);
+    if (!over_string && !over_file) {
+        errors::CompletionError("Invalid lines", this->source, lines_call->meta_data.st_line_no, lines_call->meta_data.end_line_no,
+                                "lines expects a str, or a file descriptor and an optional buffer size")
+            .raise();
+    }
+    auto reader = this->_createEntryBlockAlloca(this->line_reader->struct_type, nullptr, variable_name + ".reader");
+    this->_gcRoot(reader, std::make_shared<enviornment::RecordStructInstance>(this->line_reader));
+    llvm::Value* text = llvm::ConstantPointerNull::get(ptr_type);
+    if (over_string) {
+        text = this->_createEntryBlockAlloca(string_type->stand_alone_type, nullptr, variable_name + ".text");
+        this->llvm_ir_builder.CreateStore(arguments[0], text);
+    }
+    this->llvm_ir_builder.CreateCall(this->llvm_module->getFunction("gigly_lines_open"),
+                                     {reader, text, over_file ? arguments[0] : this->llvm_ir_builder.getInt64(-1),
+                                      arguments.size() == 2 ? arguments[1] : this->llvm_ir_builder.getInt64(0)});
+    auto line = this->_createEntryBlockAlloca(string_type->stand_alone_type, nullptr, variable_name);
+    this->_gcRoot(line, std::make_shared<enviornment::RecordStructInstance>(string_type));
+    this->_invalidateBoundsFacts(for_statement->body);
+    llvm::BasicBlock* CondBB = llvm::BasicBlock::Create(llvm_context, "lines.next", func);
+    llvm::BasicBlock* BodyBB = llvm::BasicBlock::Create(llvm_context, "lines.body", func);
+    llvm::BasicBlock* ContBB = llvm::BasicBlock::Create(llvm_context, "lines.end", func);
+    this->llvm_ir_builder.CreateBr(CondBB);
+    this->llvm_ir_builder.SetInsertPoint(CondBB);
+    auto more = this->llvm_ir_builder.CreateCall(this->llvm_module->getFunction("gigly_lines_next"), {reader, line});
+    this->llvm_ir_builder.CreateCondBr(this->llvm_ir_builder.CreateICmpNE(more, this->llvm_ir_builder.getInt32(0)), BodyBB, ContBB);
+    this->llvm_ir_builder.SetInsertPoint(BodyBB);
+    auto prev_env = std::make_shared<enviornment::Enviornment>(this->enviornment);
+    this->enviornment = enviornment::Enviornment(prev_env, {}, "for");
+    this->enviornment.current_function = prev_env->current_function;
+    this->enviornment.loop_body_block = prev_env->loop_body_block;
+    this->enviornment.loop_end_block = prev_env->loop_end_block;
+    this->enviornment.loop_condition_block = prev_env->loop_condition_block;
+    this->enviornment.loop_arena_depth = prev_env->loop_arena_depth;
+    this->enviornment.arenas = prev_env->arenas;
+    this->enviornment.checked_indices = prev_env->checked_indices;
+    this->enviornment.array_min_lengths = prev_env->array_min_lengths;
+    std::erase_if(this->enviornment.checked_indices, [&](const auto& fact) { return fact.first == variable_name || fact.second == variable_name; });
+    this->enviornment.array_min_lengths.erase(variable_name);
+    this->enviornment.add(std::make_shared<enviornment::RecordVariable>(variable_name, line, line, std::make_shared<enviornment::RecordStructInstance>(string_type)));
+    this->enviornment.loop_body_block.push_back(BodyBB);
+    this->enviornment.loop_end_block.push_back(ContBB);
+    this->enviornment.loop_condition_block.push_back(CondBB);
+    this->enviornment.loop_arena_depth.push_back(this->enviornment.arenas.size());
+    this->compile(for_statement->body);
+    this->enviornment = *prev_env;
+    if (this->llvm_ir_builder.GetInsertBlock()->getTerminator() == nullptr) {
+        this->llvm_ir_builder.CreateBr(CondBB);
+    }
     this->llvm_ir_builder.SetInsertPoint(ContBB);
 };
 
-void compiler::Compiler::_visitStructStatement(std::shared_ptr<AST::StructStatement> struct_statement) {
+void compiler::Compiler::_visitArenaStatement(std::shared_ptr<AST::ArenaStatement> arena_statement) {
+    llvm::Value* chunk_size = this->llvm_ir_builder.getInt64(0); // runtime default
+    if (arena_statement->chunk_size != nullptr) {
+        auto [value, _value_type] = this->_resolveValue(arena_statement->chunk_size);
+        if (value.empty() || !this->_checkType(std::get<std::shared_ptr<enviornment::RecordStructInstance>>(_value_type), this->enviornment.get_struct("int"))) {
+            errors::CompletionError("Invalid arena", this->source, arena_statement->meta_data.st_line_no, arena_statement->meta_data.end_line_no, "Arena chunk size must be an int")
+                .raise();
+        }
+        chunk_size = value[0];
+    }
+    // everything the block allocates, including in callees, comes from the arena and is freed at once on exit
+    auto arena = this->llvm_ir_builder.CreateCall(this->llvm_module->getFunction("gigly_arena_enter"), {chunk_size}, "arena");
+    this->enviornment.arenas.push_back(arena);
+    this->compile(arena_statement->body);
+    this->enviornment.arenas.pop_back();
+    if (this->llvm_ir_builder.GetInsertBlock()->getTerminator() == nullptr) {
+        this->llvm_ir_builder.CreateCall(this->llvm_module->getFunction("gigly_arena_exit"), {arena});
+    }
+};
+
+void compiler::Compiler::_exitArenas(size_t depth) {
+    // break, continue and return leave every arena opened since the target was entered, innermost first
+    for (size_t i = this->enviornment.arenas.size(); i > depth; --i) {
+        this->llvm_ir_builder.CreateCall(this->llvm_module->getFunction("gigly_arena_exit"), {this->enviornment.arenas[i - 1]});
+    }
+};
+
+bool compiler::Compiler::_holdsHeap(std::shared_ptr<enviornment::RecordStructInstance> type) {
+    auto struct_record = type->struct_type;
+    return struct_record == this->enviornment.get_struct("array") || struct_record == this->enviornment.get_struct("str") ||
+           (struct_record->struct_type != nullptr && (!struct_record->pointer_fields.empty() || !struct_record->string_fields.empty()));
+};
+
+void compiler::Compiler::_checkArenaEscape(std::shared_ptr<AST::Expression> target, std::shared_ptr<enviornment::RecordStructInstance> value_type,
+                                          std::shared_ptr<AST::Node> node) {
+    // A value allocated inside an arena is freed when the block exits, storing it into anything declared outside would
+    // leave a dangling pointer. Only values holding heap memory are checked, numbers can always leave.
+    if (this->enviornment.arenas.empty()) {
+        return;
+    }
+    if (!this->_holdsHeap(value_type)) {
+        return;
+    }
+    // `a.b[i].c` stores into whatever `a` refers to
+    while (target->type() == AST::NodeType::InfixedExpression || target->type() == AST::NodeType::IndexExpression) {
+        target = target->type() == AST::NodeType::InfixedExpression ? std::static_pointer_cast<AST::InfixExpression>(target)->left
+                                                                     : std::static_pointer_cast<AST::IndexExpression>(target)->left;
+    }
+    if (target->type() != AST::NodeType::IdentifierLiteral) {
+        return;
+    }
+    auto name = std::static_pointer_cast<AST::IdentifierLiteral>(target)->value;
+    if (this->enviornment.is_variable(name) && this->enviornment.get_variable(name)->arena_depth < this->enviornment.arenas.size()) {
+        errors::CompletionError("Value escapes arena", this->source, node->meta_data.st_line_no, node->meta_data.end_line_no,
+                                "`" + name + "` is declared outside the arena block, a `" + value_type->struct_type->name + "` value stored into it would be freed when the block exits")
+            .raise();
+    }
+};
+
+llvm::MDNode* compiler::Compiler::_loopMetadata() {
+    // distinct self-referencing loop id carrying the vectorizer hints
+    auto temp = llvm::MDNode::getTemporary(this->llvm_context, {});
+    llvm::SmallVector<llvm::Metadata*, 4> operands = {temp.get()};
+    operands.push_back(llvm::MDNode::get(this->llvm_context, {llvm::MDString::get(this->llvm_context, "llvm.loop.mustprogress")}));
+    operands.push_back(llvm::MDNode::get(this->llvm_context, {llvm::MDString::get(this->llvm_context, "llvm.loop.vectorize.enable"),
+                                                              llvm::ConstantAsMetadata::get(this->llvm_ir_builder.getTrue())}));
+    auto loop_id = llvm::MDNode::getDistinct(this->llvm_context, operands);
+    loop_id->replaceOperandWith(0, loop_id);
+    return loop_id;
+};
+
+llvm::Value* compiler::Compiler::_arrayLength(llvm::Value* array) {
+    return this->llvm_ir_builder.CreateLoad(this->llvm_ir_builder.getInt64Ty(), this->llvm_ir_builder.CreateStructGEP(this->array_header, array, 1), "array.len");
+};
+
+llvm::Value* compiler::Compiler::_arrayData(llvm::Value* array) {
+    // reloaded on every use, an append in between may have moved the elements
+    return this->llvm_ir_builder.CreateLoad(this->array_header->getElementType(0), this->llvm_ir_builder.CreateStructGEP(this->array_header, array, 0), "array.data");
+};
+
+void compiler::Compiler::_declareRuntimeBuiltin(const std::string& name, const std::string& symbol, std::shared_ptr<enviornment::RecordStructType> return_type,
+                                                const std::vector<std::shared_ptr<enviornment::RecordStructType>>& param_types) {
+    // The runtime takes and returns str through pointers, the builtin is a small always-inline wrapper with the by-value signature
+    auto string_type = this->enviornment.parent->get_struct("str");
+    auto ptr_type = llvm::PointerType::get(this->llvm_context, 0);
+    bool returns_string = return_type == string_type;
+    std::vector<llvm::Type*> runtime_params;
+    std::vector<llvm::Type*> params;
+    if (returns_string) {
+        runtime_params.push_back(ptr_type);
+    }
+    for (auto param : param_types) {
+        params.push_back(param->stand_alone_type);
+        runtime_params.push_back(param == string_type ? ptr_type : param->stand_alone_type);
+    }
+    auto runtime_function = llvm::Function::Create(llvm::FunctionType::get(returns_string ? llvm::Type::getVoidTy(this->llvm_context) : return_type->stand_alone_type, runtime_params, false),
+                                                   llvm::Function::ExternalLinkage, symbol, this->llvm_module.get());
+    runtime_function->addFnAttr(llvm::Attribute::NoUnwind);
+    auto function_type = llvm::FunctionType::get(return_type->stand_alone_type, params, false);
+    auto function = llvm::Function::Create(function_type, llvm::Function::InternalLinkage, "gigly." + name, this->llvm_module.get());
+    function->addFnAttr(llvm::Attribute::AlwaysInline);
+    llvm::IRBuilder<> builder(llvm::BasicBlock::Create(this->llvm_context, "entry", function));
+    std::vector<llvm::Value*> args;
+    llvm::Value* out = nullptr;
+    if (returns_string) {
+        out = builder.CreateAlloca(string_type->stand_alone_type);
+        args.push_back(out);
+    }
+    for (unsigned idx = 0; idx < param_types.size(); ++idx) {
+        if (param_types[idx] == string_type) {
+            auto slot = builder.CreateAlloca(string_type->stand_alone_type);
+            builder.CreateStore(function->getArg(idx), slot);
+            args.push_back(slot);
+        } else {
+            args.push_back(function->getArg(idx));
+        }
+    }
+    auto result = builder.CreateCall(runtime_function, args);
+    if (returns_string) {
+        builder.CreateRet(builder.CreateLoad(string_type->stand_alone_type, out));
+    } else if (return_type->stand_alone_type->isVoidTy()) {
+        builder.CreateRetVoid();
+    } else {
+        builder.CreateRet(result);
+    }
+    std::vector<std::tuple<std::string, std::shared_ptr<enviornment::RecordVariable>>> arguments;
+    for (auto param : param_types) {
+        arguments.push_back({param->name, nullptr});
+    }
+    this->enviornment.parent->add(std::make_shared<enviornment::RecordFunction>(name, function, function_type, arguments, std::make_shared<enviornment::RecordStructInstance>(return_type)));
+};
+
+llvm::Constant* compiler::Compiler::_stringLiteral(const std::string& value) {
+    // identical literals share one NUL terminated constant per module, a literal is a constant {ptr, len}
+    if (auto literal = this->string_literals.find(value); literal != this->string_literals.end()) {
+        return literal->second;
+    }
+    auto chars = llvm::ConstantDataArray::getString(this->llvm_context, value, true);
+    auto global = new llvm::GlobalVariable(*this->llvm_module, chars->getType(), true, llvm::GlobalValue::PrivateLinkage, chars, ".str");
+    global->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
+    global->setAlignment(llvm::Align(1));
+    auto string_type = llvm::cast<llvm::StructType>(this->enviornment.get_struct("str")->stand_alone_type);
+    auto literal = llvm::ConstantStruct::get(string_type, {global, this->llvm_ir_builder.getInt64(value.size())});
+    this->string_literals[value] = literal;
+    return literal;
+};
+
+llvm::Value* compiler::Compiler::_stringLength(llvm::Value* string) {
+    // inline strings keep their length in the top byte of len, see gigly_str
+    auto len = this->llvm_ir_builder.CreateExtractValue(string, 1, "str.len");
+    auto inline_len = this->llvm_ir_builder.CreateAnd(this->llvm_ir_builder.CreateLShr(len, 56), 0x7f);
+    return this->llvm_ir_builder.CreateSelect(this->llvm_ir_builder.CreateICmpSLT(len, this->llvm_ir_builder.getInt64(0)), inline_len, len, "str.length");
+};
+
+llvm::Value* compiler::Compiler::_emitStringConcat(llvm::Value* left, llvm::Value* right) {
+    // `a + b + c` is one runtime call that sizes the buffer once, an inner concatenation nothing else uses is
+    // dropped and its parts are folded into the outer one
+    std::vector<llvm::Value*> parts;
+    for (auto operand : {left, right}) {
+        auto pending = this->string_concats.find(operand);
+        if (pending != this->string_concats.end() && operand->use_empty()) {
+            auto [call, inner_parts] = pending->second;
+            parts.insert(parts.end(), inner_parts.begin(), inner_parts.end());
+            auto parts_array = llvm::cast<llvm::AllocaInst>(call->getArgOperand(1));
+            llvm::cast<llvm::Instruction>(operand)->eraseFromParent();
+            call->eraseFromParent();
+            while (!parts_array->use_empty()) {
+                auto element = llvm::cast<llvm::Instruction>(parts_array->user_back());
+                while (!element->use_empty()) {
+                    llvm::cast<llvm::Instruction>(element->user_back())->eraseFromParent();
+                }
+                element->eraseFromParent();
+            }
+            parts_array->eraseFromParent();
+            this->string_concats.erase(pending);
+        } else {
+            parts.push_back(operand);
+        }
+    }
+    std::string folded;
+    for (auto part : parts) {
+        llvm::StringRef text;
+        auto literal = llvm::dyn_cast<llvm::ConstantStruct>(part);
+        if (literal == nullptr || !llvm::getConstantStringInfo(literal->getOperand(0), text) ||
+            text.size() != llvm::cast<llvm::ConstantInt>(literal->getOperand(1))->getZExtValue()) {
+            folded.clear();
+            break;
+        }
+        folded += text.str();
+        if (part == parts.back()) {
+            return this->_stringLiteral(folded);
+        }
+    }
+    auto string_type = this->enviornment.get_struct("str");
+    auto parts_array = this->_createEntryBlockAlloca(llvm::ArrayType::get(string_type->stand_alone_type, parts.size()), nullptr, "concat.parts");
+    for (unsigned idx = 0; idx < parts.size(); ++idx) {
+        this->llvm_ir_builder.CreateStore(parts[idx], this->llvm_ir_builder.CreateConstInBoundsGEP2_32(parts_array->getAllocatedType(), parts_array, 0, idx));
+    }
+    auto out = this->_createEntryBlockAlloca(string_type->stand_alone_type, nullptr, "concat");
+    this->_gcRoot(out, std::make_shared<enviornment::RecordStructInstance>(string_type));
+    auto call = this->llvm_ir_builder.CreateCall(this->llvm_module->getFunction("gigly_str_concat"), {out, parts_array, this->llvm_ir_builder.getInt64(parts.size())});
+    auto result = this->llvm_ir_builder.CreateLoad(string_type->stand_alone_type, out, "concat.result");
+    this->string_concats[result] = {call, parts};
+    return result;
+};
+
+llvm::Value* compiler::Compiler::_emitStringSlice(llvm::Value* string, llvm::Value* start, llvm::Value* end) {
+    auto string_type = this->enviornment.get_struct("str");
+    auto source = this->_createEntryBlockAlloca(string_type->stand_alone_type, nullptr, "slice.source");
+    this->llvm_ir_builder.CreateStore(string, source);
+    auto out = this->_createEntryBlockAlloca(string_type->stand_alone_type, nullptr, "slice");
+    this->_gcRoot(out, std::make_shared<enviornment::RecordStructInstance>(string_type));
+    this->llvm_ir_builder.CreateCall(this->llvm_module->getFunction("gigly_str_slice"), {out, source, start, end});
+    return this->llvm_ir_builder.CreateLoad(string_type->stand_alone_type, out, "slice.result");
+};
+
+llvm::AllocaInst* compiler::Compiler::_createEntryBlockAlloca(llvm::Type* type, llvm::Value* array_size, const llvm::Twine& name) {
+    // Allocas live in the entry block so loops never grow the stack and mem2reg can promote them
+    auto& entry = this->llvm_ir_builder.GetInsertBlock()->getParent()->getEntryBlock();
+    llvm::IRBuilder<> entry_builder(&entry, entry.begin());
+    return entry_builder.CreateAlloca(type, array_size, name);
+};
+
+void compiler::Compiler::_recordPointerFields(std::shared_ptr<enviornment::RecordStructType> struct_record) {
+    // Arrays and strings reference the heap, nested structs contribute theirs under the field's index
+    for (unsigned idx = 0; idx < struct_record->fields.size(); ++idx) {
+        auto field_type = struct_record->sub_types[struct_record->fields[idx]];
+        if (field_type->struct_type == this->enviornment.get_struct("array")) {
+            struct_record->pointer_fields.push_back({idx});
+        } else if (field_type->struct_type == this->enviornment.get_struct("str")) {
+            struct_record->string_fields.push_back({idx});
+        } else if (field_type->struct_type->struct_type != nullptr) {
+            for (auto path : field_type->struct_type->pointer_fields) {
+                path.insert(path.begin(), idx);
+                struct_record->pointer_fields.push_back(path);
+            }
+            for (auto path : field_type->struct_type->string_fields) {
+                path.insert(path.begin(), idx);
+                struct_record->string_fields.push_back(path);
+            }
+        }
+    }
+};
+
+llvm::Constant* compiler::Compiler::_gcDescriptor(std::shared_ptr<enviornment::RecordStructInstance> type) {
+    // gigly_gc_desc for one value of `type`, null when it holds no heap pointers. Offsets stay constant
+    // expressions so they follow the target's data layout.
+    auto struct_record = type->struct_type;
+    bool is_array = type->struct_type == this->enviornment.get_struct("array");
+    bool is_string = type->struct_type == this->enviornment.get_struct("str");
+    if (!is_array && !is_string && (struct_record->struct_type == nullptr || (struct_record->pointer_fields.empty() && struct_record->string_fields.empty()))) {
+        return nullptr;
+    }
+    llvm::Type* llvm_type = is_array || is_string ? struct_record->stand_alone_type : struct_record->struct_type;
+    std::string name = "gc.desc." + (is_array || is_string ? struct_record->name : struct_record->struct_type->getName().str());
+    if (auto global = this->llvm_module->getNamedGlobal(name)) {
+        return global;
+    }
+    auto i64 = this->llvm_ir_builder.getInt64Ty();
+    std::vector<llvm::Constant*> offsets;
+    auto add_offsets = [&](const std::vector<std::vector<unsigned>>& paths) {
+        for (const auto& path : paths) {
+            std::vector<llvm::Constant*> indices = {this->llvm_ir_builder.getInt32(0)};
+            for (auto idx : path) {
+                indices.push_back(this->llvm_ir_builder.getInt32(idx));
+            }
+            auto field = llvm::ConstantExpr::getGetElementPtr(llvm_type, llvm::ConstantPointerNull::get(llvm::PointerType::get(this->llvm_context, 0)), indices);
+            offsets.push_back(llvm::ConstantExpr::getPtrToInt(field, i64));
+        }
+    };
+    size_t pointers = 0, strings = 0;
+    if (is_array || is_string) {
+        offsets.push_back(llvm::ConstantInt::get(i64, 0));
+        (is_array ? pointers : strings) = 1;
+    } else {
+        add_offsets(struct_record->pointer_fields);
+        add_offsets(struct_record->string_fields);
+        pointers = struct_record->pointer_fields.size();
+        strings = struct_record->string_fields.size();
+    }
+    auto descriptor = llvm::ConstantStruct::getAnon({llvm::ConstantExpr::getSizeOf(llvm_type), llvm::ConstantInt::get(i64, pointers), llvm::ConstantInt::get(i64, strings),
+                                                     llvm::ConstantArray::get(llvm::ArrayType::get(i64, offsets.size()), offsets)});
+    auto global = new llvm::GlobalVariable(*this->llvm_module, descriptor->getType(), true, llvm::GlobalValue::PrivateLinkage, descriptor, name);
+    global->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
+    return global;
+};
+
+void compiler::Compiler::_gcRoot(llvm::Value* slot, std::shared_ptr<enviornment::RecordStructInstance> type) {
+    // Registers a stack slot with the shadow stack so the collector sees it, borrowed parameters are rooted by the caller
+    auto alloca = llvm::dyn_cast<llvm::AllocaInst>(slot);
+    if (alloca == nullptr) {
+        return;
+    }
+    bool is_array = type->struct_type == this->enviornment.get_struct("array");
+    auto descriptor = is_array ? nullptr : this->_gcDescriptor(type);
+    if (!is_array && descriptor == nullptr) {
+        return;
+    }
+    auto ptr_type = llvm::PointerType::get(this->llvm_context, 0);
+    alloca->getFunction()->setGC("shadow-stack");
+    llvm::IRBuilder<> entry_builder(alloca->getParent(), std::next(alloca->getIterator()));
+    // roots are scanned from function entry on, they must never hold garbage
+    entry_builder.CreateStore(llvm::Constant::getNullValue(alloca->getAllocatedType()), alloca);
+    llvm::Value* root = alloca;
+    if (!is_array) {
+        // the shadow stack holds pointers, a struct is rooted through a slot with its address and its descriptor as metadata
+        root = entry_builder.CreateAlloca(ptr_type, nullptr, alloca->getName() + ".root");
+        entry_builder.CreateStore(alloca, root);
+    }
+    entry_builder.CreateCall(llvm::Intrinsic::getDeclaration(this->llvm_module.get(), llvm::Intrinsic::gcroot),
+                             {root, descriptor ? descriptor : llvm::ConstantPointerNull::get(ptr_type)});
+};
+
+llvm::Value* compiler::Compiler::_gcRootTemp(llvm::Value* value, std::shared_ptr<enviornment::RecordStructInstance> type) {
+    // a fresh array or string must survive allocations made before it reaches a variable, e.g. while later arguments are evaluated
+    if (type->struct_type != this->enviornment.get_struct("array") && type->struct_type != this->enviornment.get_struct("str")) {
+        return value;
+    }
+    auto slot = this->_createEntryBlockAlloca(value->getType(), nullptr, "gc.tmp");
+    this->_gcRoot(slot, type);
+    this->llvm_ir_builder.CreateStore(value, slot);
+    return value;
+};
+
+std::shared_ptr<enviornment::RecordStructType> compiler::Compiler::_visitStructStatement(std::shared_ptr<AST::StructStatement> struct_statement,
+                                                                                         std::shared_ptr<enviornment::RecordGenericStructType> generic, const std::string& generic_key) {
     std::string struct_name = std::static_pointer_cast<AST::IdentifierLiteral>(struct_statement->name)->value;
+    if (generic == nullptr && !struct_statement->generics.empty()) {
+        // generic structs are only compiled once they are instantiated with concrete types
+        auto symbol_name = this->fc_st_name_prefix != "main.." ? this->fc_st_name_prefix + struct_name : struct_name;
+        this->enviornment.add(std::make_shared<enviornment::RecordGenericStructType>(struct_name, struct_statement, symbol_name));
+        this->ir_gc_map_json["structs"][struct_name] = symbol_name;
+        return nullptr;
+    }
+    GIGLY_TRACE(Codegen, Info, "Compiling struct " << struct_name << generic_key);
     std::vector<llvm::Type*> field_types;
     auto fields = struct_statement->fields;
-    auto struct_record = std::make_shared<enviornment::RecordStructType>(struct_name);
-    this->enviornment.add(struct_record);
+    auto struct_record = std::make_shared<enviornment::RecordStructType>(struct_name + generic_key);
+    // named after the declaring module like functions, so same-named structs of two modules keep apart symbols
+    if (generic != nullptr) {
+        struct_record->symbol_name = generic->symbol_name + generic_key;
+    } else if (this->fc_st_name_prefix != "main..") {
+        struct_record->symbol_name = this->fc_st_name_prefix + struct_name;
+    }
+    struct_record->struct_type = llvm::StructType::create(this->llvm_context, struct_record->symbol_name);
+    if (generic != nullptr) {
+        generic->instances[generic_key] = struct_record;
+        for (auto param : struct_statement->generics) {
+            struct_record->generic_arguments.push_back(this->enviornment.get_generic_parameter(std::static_pointer_cast<AST::IdentifierLiteral>(param)->value)->instance);
+        }
+    } else {
+        this->enviornment.add(struct_record);
+    }
+    // Fields are laid out before any method is compiled so methods can use the complete struct type
     for(auto field : fields) {
         if (field->type() == AST::NodeType::VariableDeclarationStatement) {
             auto field_decl = std::static_pointer_cast<AST::VariableDeclarationStatement>(field);
@@ -1118,52 +3825,34 @@ void compiler::Compiler::_visitStructStatement(std::shared_ptr<AST::StructStatem
                 field_types.push_back(field_type->struct_type->stand_alone_type);
             }
             struct_record->sub_types[field_name] = field_type;
-
         }
-        else if (field->type() == AST::NodeType::FunctionStatement) {
+    }
+    struct_record->struct_type->setBody(field_types);
+    this->_recordPointerFields(struct_record);
+    for(auto field : fields) {
+        if (field->type() == AST::NodeType::FunctionStatement) {
             auto field_decl = std::static_pointer_cast<AST::FunctionStatement>(field);
             auto name = std::static_pointer_cast<AST::IdentifierLiteral>(field_decl->name)->value;
             auto body = field_decl->body;
             auto params = field_decl->parameters;
-            std::vector<std::string> param_name;
-            std::vector<llvm::Type*> param_types;
             std::vector<std::shared_ptr<enviornment::RecordStructInstance>> param_inst_record;
             for(auto param : params) {
-                param_name.push_back(std::static_pointer_cast<AST::IdentifierLiteral>(param->name)->value);
                 param_inst_record.push_back(this->_parseType(param->value_type));
-                param_types.push_back(param_inst_record.back()->struct_type->stand_alone_type ? param_inst_record.back()->struct_type->stand_alone_type : param_inst_record.back()->struct_type->struct_type);
             }
             auto return_type = this->_parseType(field_decl->return_type);
-            auto llvm_return_type = return_type->struct_type->stand_alone_type ? return_type->struct_type->stand_alone_type : return_type->struct_type->struct_type;
-            auto func_type = llvm::FunctionType::get(llvm_return_type, param_types, false);
-            auto func = llvm::Function::Create(func_type, llvm::Function::ExternalLinkage, name, this->llvm_module.get());
-            unsigned idx = 0;
-            for(auto& arg : func->args()) {
-                arg.setName(param_name[idx++]);
-            }
+            auto func = this->_createFunction(field_decl, struct_record->symbol_name + "::" + name, generic != nullptr ? llvm::Function::LinkOnceODRLinkage : this->_exportLinkage(struct_record->name + "::" + name),
+                                              param_inst_record, return_type);
+            this->_applyFunctionAttributes(field_decl, func);
+            auto func_type = func->getFunctionType();
             auto bb = llvm::BasicBlock::Create(this->llvm_context, "entry", func);
             this->function_entery_block.push_back(bb);
             this->llvm_ir_builder.SetInsertPoint(bb);
             auto prev_env = std::make_shared<enviornment::Enviornment>(this->enviornment);
             this->enviornment = enviornment::Enviornment(prev_env, {}, name);
-            std::vector<std::tuple<std::string, std::shared_ptr<enviornment::RecordVariable>>> arguments;
-            auto func_record = std::make_shared<enviornment::RecordFunction>(name, func, func_type, arguments, return_type);
+            auto func_record = std::make_shared<enviornment::RecordFunction>(name, func, func_type, std::vector<std::tuple<std::string, std::shared_ptr<enviornment::RecordVariable>>>{}, return_type);
+            struct_record->add_method(name, func_record);
             this->enviornment.current_function = func_record;
-            for(const auto& [arg, param_type_record] : llvm::zip(func->args(), param_inst_record)) {
-                llvm::AllocaInst* alloca = nullptr;
-                if (!arg.getType()->isPointerTy() || this->_checkType(param_type_record, this->enviornment.get_struct("array"))) {
-                    alloca = this->llvm_ir_builder.CreateAlloca(arg.getType(), nullptr, arg.getName());
-                    auto storeInst = this->llvm_ir_builder.CreateStore(&arg, alloca);
-                }
-                else {
-                    alloca = this->llvm_ir_builder.CreateAlloca(param_type_record->struct_type->struct_type, nullptr, arg.getName());
-                    auto loaded_arg = this->llvm_ir_builder.CreateLoad(param_type_record->struct_type->struct_type, &arg, arg.getName() + ".load");
-                    auto storeInst = this->llvm_ir_builder.CreateStore(loaded_arg, alloca);
-                }
-                auto record = std::make_shared<enviornment::RecordVariable>(std::string(arg.getName()), &arg, alloca, param_type_record);
-                arguments.push_back({std::string(arg.getName()), record});
-                this->enviornment.add(record);
-            }
+            this->_bindFunctionParameters(field_decl, func, param_inst_record, func_record->arguments);
             func_record->set_meta_data(field_decl->meta_data.st_line_no, field_decl->meta_data.st_col_no,
                                        field_decl->meta_data.end_line_no, field_decl->meta_data.end_col_no);
             func_record->meta_data.more_data["name_line_no"] = field_decl->name->meta_data.st_line_no;
@@ -1172,18 +3861,43 @@ void compiler::Compiler::_visitStructStatement(std::shared_ptr<AST::StructStatem
             func_record->meta_data.more_data["name_end_line_no"] = field_decl->name->meta_data.end_line_no;
             this->enviornment.add(func_record);
             this->compile(body);
+            this->_checkTailCalls(field_decl, func);
+            this->_checkPure(field_decl, func);
             this->enviornment = *prev_env;
             this->function_entery_block.pop_back();
             if (!this->function_entery_block.empty()) {
                 this->llvm_ir_builder.SetInsertPoint(this->function_entery_block.at(this->function_entery_block.size() - 1));
             }
-            struct_record->methods[name] = func_record;
         }
     }
-    auto struct_type = llvm::StructType::create(this->llvm_context, field_types, struct_name);
-    struct_type->setBody(field_types);
-    struct_record->struct_type = struct_type;
-    this->ir_gc_map_json["structs"][struct_name] = struct_record->struct_type->getName().str();
+    if (generic == nullptr) {
+        this->ir_gc_map_json["structs"][struct_name] = struct_record->symbol_name;
+    }
+    return struct_record;
+};
+
+std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::RecordStructInstance>, std::shared_ptr<enviornment::RecordModule>>> compiler::Compiler::_visitStructConstruction(
+    std::shared_ptr<enviornment::RecordStructType> struct_record, const std::vector<llvm::Value*>& args, const std::vector<std::shared_ptr<enviornment::RecordStructInstance>>& params_types) {
+    auto struct_type = struct_record->struct_type;
+    auto alloca = this->_createEntryBlockAlloca(struct_type, nullptr, struct_record->name);
+    this->_gcRoot(alloca, std::make_shared<enviornment::RecordStructInstance>(struct_record));
+    for (unsigned int i = 0; i < args.size(); ++i) {
+        auto field_type = struct_record->sub_types[struct_record->fields[i]];
+        auto [arg, arg_type] = this->_implicitCast(args[i], params_types[i], field_type, nullptr);
+        if (!this->_checkType(field_type, arg_type)) {
+            std::cerr << "Struct Type MissMatch" << std::endl;
+            exit(1);
+        }
+        auto field_ptr = this->llvm_ir_builder.CreateStructGEP(struct_type, alloca, i);
+        if (field_type->struct_type->stand_alone_type == nullptr) {
+            // nested structs are passed around by pointer, copy the value into the field
+            auto load = this->llvm_ir_builder.CreateLoad(field_type->struct_type->struct_type, arg);
+            this->llvm_ir_builder.CreateStore(load, field_ptr);
+        } else {
+            this->llvm_ir_builder.CreateStore(arg, field_ptr);
+        }
+    }
+    return {{alloca}, std::make_shared<enviornment::RecordStructInstance>(struct_record, struct_record->generic_arguments)};
 };
 
 // Function to read the file content into a string
@@ -1193,6 +3907,7 @@ void compiler::Compiler::_visitImportStatement(std::shared_ptr<AST::ImportStatem
     auto gc_source_path = std::filesystem::path(this->file_path.parent_path().string() + "/" + import_statement->relativePath + ".gc");
     nlohmann::json ir_gc_map_json;
     auto ir_gc_map = std::filesystem::path(this->ir_gc_map.parent_path().string() + "/" + import_statement->relativePath + ".json");
+    GIGLY_TRACE(Import, Info, "Importing " << import_statement->relativePath << " from " << gc_source_path.string());
     std::ifstream ir_gc_map_file(ir_gc_map);
     if (!ir_gc_map_file.is_open()) {
         std::cerr << "Failed to open ir_gc_map file: " << ir_gc_map << std::endl;
@@ -1202,7 +3917,7 @@ void compiler::Compiler::_visitImportStatement(std::shared_ptr<AST::ImportStatem
     ir_gc_map_file.close();
     bool uptodate = ir_gc_map_json["uptodate"];
     if (!uptodate) {
-        std::cerr << "IR GC map not uptodate, throwing NotCompiledError" << std::endl;
+        GIGLY_TRACE(Import, Info, gc_source_path.string() << " is not compiled yet, compiling it first");
         throw compiler::NotCompiledError(gc_source_path.string());
     }
     auto prev_path = this->file_path;
@@ -1227,7 +3942,10 @@ void compiler::Compiler::_visitImportStatement(std::shared_ptr<AST::ImportStatem
         module->record_map[new_mod->name] = new_mod;
         module = new_mod;
     }
+    auto prev_env = std::make_shared<enviornment::Enviornment>(this->enviornment);
     for (auto& stmt : program->statements) {
+        // declarations name types as the imported module sees them, not as the importer does
+        this->enviornment = this->_genericEnviornment(prev_env, module, module->name);
         switch (stmt->type()) {
             case AST::NodeType::FunctionStatement: {
                 this->_importFunctionDeclarationStatement(std::static_pointer_cast<AST::FunctionStatement>(stmt), module, ir_gc_map_json);
@@ -1244,42 +3962,62 @@ void compiler::Compiler::_visitImportStatement(std::shared_ptr<AST::ImportStatem
                 break;
             }
             default:
-                std::cerr << "Unknown statement type, skipping" << std::endl;
+                GIGLY_TRACE(Import, Debug, "Skipping statement that declares nothing in " << gc_source_path.string());
                 break;
         }
     }
+    this->enviornment = *prev_env;
 }
 
 void compiler::Compiler::_importFunctionDeclarationStatement(std::shared_ptr<AST::FunctionStatement> function_declaration_statement, std::shared_ptr<enviornment::RecordModule> module, nlohmann::json& ir_gc_map_json) {
     auto name = std::static_pointer_cast<AST::IdentifierLiteral>(function_declaration_statement->name)->value;
+    if (!function_declaration_statement->extern_abi.empty()) {
+        module->record_map[name] = this->_declareExternFunction(function_declaration_statement);
+        return;
+    }
+    if (!function_declaration_statement->generics.empty()) {
+        module->record_map[name] = std::make_shared<enviornment::RecordGenericFunction>(name, function_declaration_statement, ir_gc_map_json["functions"][name].get<std::string>(), module);
+        return;
+    }
+    if (!ir_gc_map_json["functions"].contains(name)) {
+        GIGLY_TRACE(Import, Debug, "Skipping module-private function " << name);
+        return;
+    }
+    GIGLY_TRACE(Import, Debug, "Importing function " << name << " into module " << module->name);
     auto params = function_declaration_statement->parameters;
-    std::vector<std::string> param_names;
-    std::vector<llvm::Type*> param_types;
+    std::vector<std::shared_ptr<enviornment::RecordStructInstance>> param_inst_records;
 
     for (auto param : params) {
-        param_names.push_back(std::static_pointer_cast<AST::IdentifierLiteral>(param->name)->value);
-        param_types.push_back(this->_parseType(param->value_type)->struct_type->stand_alone_type ? this->_parseType(param->value_type)->struct_type->stand_alone_type : llvm::PointerType::get(this->_parseType(param->value_type)->struct_type->struct_type, 0));
+        param_inst_records.push_back(this->_parseType(param->value_type));
     }
 
     auto return_type = this->_parseType(function_declaration_statement->return_type);
-    auto llvm_return_type = return_type->struct_type->stand_alone_type ? return_type->struct_type->stand_alone_type : return_type->struct_type->struct_type->getPointerTo();
-    auto func_type = llvm::FunctionType::get(llvm_return_type, param_types, false);
-    auto func = llvm::Function::Create(func_type, llvm::Function::ExternalLinkage, ir_gc_map_json["functions"][name].get<std::string>(), this->llvm_module.get());
-    unsigned idx = 0;
-    for (auto& arg : func->args()) {
-        arg.setName(param_names[idx++]);
-    }
+    auto func = this->_createFunction(function_declaration_statement, ir_gc_map_json["functions"][name].get<std::string>(), llvm::Function::ExternalLinkage, param_inst_records, return_type);
+    this->_applyFunctionAttributes(function_declaration_statement, func);
+    this->_applyImportedAttributes(func, ir_gc_map_json);
+    auto func_type = func->getFunctionType();
 
+    // parameter types only, calls need them to convert literal arguments
     std::vector<std::tuple<std::string, std::shared_ptr<enviornment::RecordVariable>>> arguments;
+    for (size_t idx = 0; idx < params.size(); ++idx) {
+        auto param_name = std::static_pointer_cast<AST::IdentifierLiteral>(params[idx]->name)->value;
+        arguments.push_back({param_name, std::make_shared<enviornment::RecordVariable>(param_name, nullptr, nullptr, param_inst_records[idx])});
+    }
     auto func_record = std::make_shared<enviornment::RecordFunction>(name, func, func_type, arguments, return_type);
     module->record_map[func_record->name] = func_record;
 }
 
 void compiler::Compiler::_importStructStatement(std::shared_ptr<AST::StructStatement> struct_statement, std::shared_ptr<enviornment::RecordModule> module, nlohmann::json& ir_gc_map_json) {
     std::string struct_name = std::static_pointer_cast<AST::IdentifierLiteral>(struct_statement->name)->value;
+    if (!struct_statement->generics.empty()) {
+        module->record_map[struct_name] = std::make_shared<enviornment::RecordGenericStructType>(struct_name, struct_statement, ir_gc_map_json["structs"][struct_name].get<std::string>(), module);
+        return;
+    }
+    GIGLY_TRACE(Import, Debug, "Importing struct " << struct_name << " into module " << module->name);
     std::vector<llvm::Type*> field_types;
     auto fields = struct_statement->fields;
     auto struct_record = std::make_shared<enviornment::RecordStructType>(struct_name);
+    struct_record->symbol_name = ir_gc_map_json["structs"][struct_name].get<std::string>();
 
     for (auto field : fields) {
         if (field->type() == AST::NodeType::VariableDeclarationStatement) {
@@ -1293,41 +4031,37 @@ void compiler::Compiler::_importStructStatement(std::shared_ptr<AST::StructState
                 field_types.push_back(field_type->struct_type->stand_alone_type);
             }
             struct_record->sub_types[field_name] = field_type;
-        } else if (field->type() == AST::NodeType::FunctionStatement) {
+        }
+    }
+
+    struct_record->struct_type = llvm::StructType::create(this->llvm_context, field_types, struct_record->symbol_name);
+    this->_recordPointerFields(struct_record);
+    module->record_map[struct_record->name] = struct_record;
+    // methods name the struct itself in their parameters
+    this->enviornment.add(struct_record);
+
+    for (auto field : fields) {
+        if (field->type() == AST::NodeType::FunctionStatement) {
             auto field_decl = std::static_pointer_cast<AST::FunctionStatement>(field);
             auto method_name = std::static_pointer_cast<AST::IdentifierLiteral>(field_decl->name)->value;
             auto method_params = field_decl->parameters;
-            std::vector<std::string> param_names;
-            std::vector<llvm::Type*> param_types;
             std::vector<std::shared_ptr<enviornment::RecordStructInstance>> param_inst_records;
 
             for (auto param : method_params) {
-                param_names.push_back(std::static_pointer_cast<AST::IdentifierLiteral>(param->name)->value);
                 param_inst_records.push_back(this->_parseType(param->value_type));
-                param_types.push_back(param_inst_records.back()->struct_type->stand_alone_type ? param_inst_records.back()->struct_type->stand_alone_type : llvm::PointerType::get(param_inst_records.back()->struct_type->struct_type, 0));
             }
 
             auto return_type = this->_parseType(field_decl->return_type);
-            auto llvm_return_type = return_type->struct_type->stand_alone_type ? return_type->struct_type->stand_alone_type : return_type->struct_type->struct_type->getPointerTo();
-            auto func_type = llvm::FunctionType::get(llvm_return_type, param_types, false);
-            auto func = llvm::Function::Create(func_type, llvm::Function::ExternalLinkage, struct_name + "::" + method_name, this->llvm_module.get());
-
-            unsigned idx = 0;
-            for (auto& arg : func->args()) {
-                arg.setName(param_names[idx++]);
-            }
+            auto func = this->_createFunction(field_decl, struct_record->symbol_name + "::" + method_name, llvm::Function::ExternalLinkage, param_inst_records, return_type);
+            this->_applyFunctionAttributes(field_decl, func);
+            this->_applyImportedAttributes(func, ir_gc_map_json);
+            auto func_type = func->getFunctionType();
 
             std::vector<std::tuple<std::string, std::shared_ptr<enviornment::RecordVariable>>> arguments;
             auto func_record = std::make_shared<enviornment::RecordFunction>(method_name, func, func_type, arguments, return_type);
-            struct_record->methods[method_name] = func_record;
+            struct_record->add_method(method_name, func_record);
         }
     }
-
-    auto struct_type = llvm::StructType::create(this->llvm_context, field_types, ir_gc_map_json["structs"][struct_name].get<std::string>());
-    struct_type->setBody(field_types);
-    struct_record->struct_type = struct_type;
-
-    module->record_map[struct_record->name] = struct_record;
 }
 
 bool compiler::Compiler::_checkType(std::shared_ptr<enviornment::RecordStructInstance> type1, std::shared_ptr<enviornment::RecordStructInstance> type2) {
@@ -1344,7 +4078,7 @@ bool compiler::Compiler::_checkType(std::shared_ptr<enviornment::RecordStructIns
             return false;
         }
     }
-    return type1->struct_type->stand_alone_type == type2->struct_type->stand_alone_type;
+    return type1->struct_type->stand_alone_type == type2->struct_type->stand_alone_type && type1->struct_type->is_unsigned == type2->struct_type->is_unsigned;
 };
 
 bool compiler::Compiler::_checkType(std::shared_ptr<enviornment::RecordStructInstance> type1, std::shared_ptr<enviornment::RecordStructType> type2) {
@@ -1356,7 +4090,7 @@ bool compiler::Compiler::_checkType(std::shared_ptr<enviornment::RecordStructIns
             return false;
         }
     }
-    return type1->struct_type->stand_alone_type == type2->stand_alone_type;
+    return type1->struct_type->stand_alone_type == type2->stand_alone_type && type1->struct_type->is_unsigned == type2->is_unsigned;
 };
 
 bool compiler::Compiler::_checkType(std::shared_ptr<enviornment::RecordStructType> type1, std::shared_ptr<enviornment::RecordStructType> type2) {
@@ -1368,7 +4102,7 @@ bool compiler::Compiler::_checkType(std::shared_ptr<enviornment::RecordStructTyp
             return false;
         }
     }
-    return type1->stand_alone_type == type2->stand_alone_type;
+    return type1->stand_alone_type == type2->stand_alone_type && type1->is_unsigned == type2->is_unsigned;
 };
 
 bool compiler::Compiler::_checkFunctionParameterType(std::shared_ptr<enviornment::RecordFunction> func_record, std::vector<std::shared_ptr<enviornment::RecordStructInstance>> params) {
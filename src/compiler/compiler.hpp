@@ -5,6 +5,7 @@
 #include <memory>
 #include <string>
 #include <variant>
+#include <llvm/IR/Constants.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
@@ -48,6 +49,15 @@ class Compiler {
 
     std::vector<llvm::BasicBlock*> function_entery_block = {};
 
+    llvm::StructType* array_header = nullptr; // {ptr data, i64 len, i64 cap, ptr arena}, `array` values point at one on the heap
+    std::shared_ptr<enviornment::RecordStructType> line_reader = nullptr; // gigly_line_reader, the state of a loop over lines(...)
+    bool bounds_checks = true;                // false with --unchecked, element accesses are then never checked
+    bool declares_generics = false;           // importers compile the generic bodies, so the module-private functions they call stay exported
+
+    std::vector<std::shared_ptr<enviornment::RecordStructType>> vector_types = {}; // builtin SIMD vectors and lane masks, signed and unsigned ones share LLVM types
+    std::unordered_map<std::string, llvm::Constant*> string_literals = {}; // deduplicated literals of this module
+    std::unordered_map<llvm::Value*, std::tuple<llvm::CallInst*, std::vector<llvm::Value*>>> string_concats = {}; // concatenation results and their parts
+
     Compiler(const std::string& source, std::filesystem::path file_path, std::filesystem::path ir_gc_map);
 
     void compile(std::shared_ptr<AST::Node> node);
@@ -61,30 +71,131 @@ class Compiler {
 
     std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::RecordStructInstance>, std::shared_ptr<enviornment::RecordModule>>> _visitInfixExpression(
         std::shared_ptr<AST::InfixExpression> infixed_expression);
+    std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::RecordStructInstance>, std::shared_ptr<enviornment::RecordModule>>> _emitInfixOperation(
+        std::shared_ptr<AST::InfixExpression> infixed_expression, llvm::Value* left_val, std::shared_ptr<enviornment::RecordStructInstance> left_type, llvm::Value* right_val,
+        std::shared_ptr<enviornment::RecordStructInstance> right_type);
+    std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::RecordStructInstance>, std::shared_ptr<enviornment::RecordModule>>> _visitPrefixExpression(
+        std::shared_ptr<AST::PrefixExpression> prefixed_expression);
+    std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::RecordStructInstance>, std::shared_ptr<enviornment::RecordModule>>> _emitLogical(
+        std::shared_ptr<AST::InfixExpression> infixed_expression);
+    bool _isSpeculatable(std::shared_ptr<AST::Node> node, int& budget);
+    void _emitCondBr(llvm::Value* condition, llvm::BasicBlock* true_block, llvm::BasicBlock* false_block);
     std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::RecordStructInstance>, std::shared_ptr<enviornment::RecordModule>>> _visitIndexExpression(
         std::shared_ptr<AST::IndexExpression> index_expression);
 
     void _visitVariableDeclarationStatement(std::shared_ptr<AST::VariableDeclarationStatement> variable_declaration_statement);
     void _visitVariableAssignmentStatement(std::shared_ptr<AST::VariableAssignmentStatement> variable_assignment_statement);
+    std::tuple<llvm::Value*, std::shared_ptr<enviornment::RecordStructInstance>, bool> _resolveAddress(std::shared_ptr<AST::Expression> node);
+    void _emitStore(llvm::Value* address, std::shared_ptr<enviornment::RecordStructInstance> type, llvm::Value* value, bool is_volatile);
 
     void _visitIfElseStatement(std::shared_ptr<AST::IfElseStatement> if_statement);
 
-    void _visitFunctionDeclarationStatement(std::shared_ptr<AST::FunctionStatement> function_declaration_statement);
+    std::shared_ptr<enviornment::RecordFunction> _visitFunctionDeclarationStatement(std::shared_ptr<AST::FunctionStatement> function_declaration_statement,
+                                                                                   std::shared_ptr<enviornment::RecordGenericFunction> generic = nullptr, const std::string& generic_key = "");
     std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::RecordStructInstance>, std::shared_ptr<enviornment::RecordModule>>> _visitCallExpression(std::shared_ptr<AST::CallExpression>);
     std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::RecordStructInstance>, std::shared_ptr<enviornment::RecordModule>>> _visitArrayLiteral(std::shared_ptr<AST::ArrayLiteral> array_literal);
     void _visitReturnStatement(std::shared_ptr<AST::ReturnStatement> return_statement);
+    void _markTailCall(llvm::Instruction* ret_inst);
+    void _checkTailCalls(std::shared_ptr<AST::FunctionStatement> function_declaration_statement, llvm::Function* func);
+    void _checkPure(std::shared_ptr<AST::FunctionStatement> function_declaration_statement, llvm::Function* func);
     void _visitBlockStatement(std::shared_ptr<AST::BlockStatement> block_statement);
     void _visitWhileStatement(std::shared_ptr<AST::WhileStatement> while_statement);
-    void _visitStructStatement(std::shared_ptr<AST::StructStatement> struct_statement);
+    void _visitForStatement(std::shared_ptr<AST::ForStatement> for_statement);
+    void _visitLinesLoop(std::shared_ptr<AST::ForStatement> for_statement, std::shared_ptr<AST::CallExpression> lines_call);
+    void _visitArenaStatement(std::shared_ptr<AST::ArenaStatement> arena_statement);
+    void _exitArenas(size_t depth);
+    bool _holdsHeap(std::shared_ptr<enviornment::RecordStructInstance> type);
+    void _checkArenaEscape(std::shared_ptr<AST::Expression> target, std::shared_ptr<enviornment::RecordStructInstance> value_type, std::shared_ptr<AST::Node> node);
+    llvm::MDNode* _loopMetadata();
+    llvm::Value* _arrayLength(llvm::Value* array);
+    llvm::Value* _arrayData(llvm::Value* array);
+    void _declareRuntimeBuiltin(const std::string& name, const std::string& symbol, std::shared_ptr<enviornment::RecordStructType> return_type,
+                                const std::vector<std::shared_ptr<enviornment::RecordStructType>>& param_types);
+    llvm::Constant* _stringLiteral(const std::string& value);
+    llvm::Value* _stringLength(llvm::Value* string);
+    llvm::Value* _emitStringConcat(llvm::Value* left, llvm::Value* right);
+    llvm::Value* _emitStringSlice(llvm::Value* string, llvm::Value* start, llvm::Value* end);
+    std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::RecordStructInstance>, std::shared_ptr<enviornment::RecordModule>>> _visitPrintBuiltin(
+        std::shared_ptr<AST::CallExpression> call_expression, const std::vector<llvm::Value*>& args, const std::vector<std::shared_ptr<enviornment::RecordStructInstance>>& params_types);
+    std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::RecordStructInstance>, std::shared_ptr<enviornment::RecordModule>>> _visitArrayBuiltin(
+        std::shared_ptr<AST::CallExpression> call_expression, const std::vector<llvm::Value*>& args, const std::vector<std::shared_ptr<enviornment::RecordStructInstance>>& params_types);
+    std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::RecordStructInstance>, std::shared_ptr<enviornment::RecordModule>>> _visitVectorBuiltin(
+        std::shared_ptr<AST::CallExpression> call_expression, const std::vector<llvm::Value*>& args, const std::vector<std::shared_ptr<enviornment::RecordStructInstance>>& params_types);
+    std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::RecordStructInstance>, std::shared_ptr<enviornment::RecordModule>>> _emitVectorOperation(
+        std::shared_ptr<AST::InfixExpression> infixed_expression, llvm::Value* left_val, std::shared_ptr<enviornment::RecordStructInstance> left_type, llvm::Value* right_val,
+        std::shared_ptr<enviornment::RecordStructInstance> right_type);
+    std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::RecordStructInstance>, std::shared_ptr<enviornment::RecordModule>>> _emitPower(
+        std::shared_ptr<AST::InfixExpression> infixed_expression, llvm::Value* base, std::shared_ptr<enviornment::RecordStructInstance> base_type, llvm::Value* exponent,
+        std::shared_ptr<enviornment::RecordStructInstance> exponent_type);
+    bool _isVector(std::shared_ptr<enviornment::RecordStructInstance> type);
+    std::shared_ptr<enviornment::RecordStructType> _vectorType(std::shared_ptr<enviornment::RecordStructInstance> lane_type, unsigned lanes);
+    llvm::Value* _toVectorLane(llvm::Value* value, std::shared_ptr<enviornment::RecordStructInstance> type, std::shared_ptr<enviornment::RecordStructType> vector,
+                               std::shared_ptr<AST::Node> node);
+    llvm::AllocaInst* _createEntryBlockAlloca(llvm::Type* type, llvm::Value* array_size = nullptr, const llvm::Twine& name = "");
+    void _recordPointerFields(std::shared_ptr<enviornment::RecordStructType> struct_record);
+    llvm::Constant* _gcDescriptor(std::shared_ptr<enviornment::RecordStructInstance> type);
+    void _gcRoot(llvm::Value* slot, std::shared_ptr<enviornment::RecordStructInstance> type);
+    llvm::Value* _gcRootTemp(llvm::Value* value, std::shared_ptr<enviornment::RecordStructInstance> type);
+    std::shared_ptr<enviornment::RecordStructType> _visitStructStatement(std::shared_ptr<AST::StructStatement> struct_statement,
+                                                                        std::shared_ptr<enviornment::RecordGenericStructType> generic = nullptr, const std::string& generic_key = "");
+    std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::RecordStructInstance>, std::shared_ptr<enviornment::RecordModule>>> _visitStructConstruction(
+        std::shared_ptr<enviornment::RecordStructType> struct_record, const std::vector<llvm::Value*>& args, const std::vector<std::shared_ptr<enviornment::RecordStructInstance>>& params_types);
 
     void _visitImportStatement(std::shared_ptr<AST::ImportStatement> import_statement, std::shared_ptr<enviornment::RecordModule> module = nullptr);
 
     std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::RecordStructInstance>, std::shared_ptr<enviornment::RecordModule>>> _resolveValue(std::shared_ptr<AST::Node> node);
+    std::tuple<llvm::Constant*, std::shared_ptr<enviornment::RecordStructInstance>> _resolveConstant(std::shared_ptr<AST::Node> node);
+    llvm::Value* _materializeConstant(llvm::Constant* constant, const std::string& name);
+    std::tuple<llvm::Value*, std::shared_ptr<enviornment::RecordStructInstance>> _implicitCast(llvm::Value* value, std::shared_ptr<enviornment::RecordStructInstance> type,
+                                                                                              std::shared_ptr<enviornment::RecordStructInstance> target, std::shared_ptr<AST::Node> node);
+    void _implicitCastArguments(std::shared_ptr<enviornment::RecordFunction> func_record, std::vector<llvm::Value*>& args,
+                                std::vector<std::shared_ptr<enviornment::RecordStructInstance>>& params_types, std::shared_ptr<AST::Node> node);
+    std::tuple<std::vector<llvm::Value*>, std::variant<std::shared_ptr<enviornment::RecordStructInstance>, std::shared_ptr<enviornment::RecordModule>>> _visitCastBuiltin(
+        std::shared_ptr<AST::CallExpression> call_expression, const std::vector<llvm::Value*>& args, const std::vector<std::shared_ptr<enviornment::RecordStructInstance>>& params_types);
 
     void _importFunctionDeclarationStatement(std::shared_ptr<AST::FunctionStatement> function_declaration_statement, std::shared_ptr<enviornment::RecordModule> module, nlohmann::json& ir_gc_map_json);
     void _importStructStatement(std::shared_ptr<AST::StructStatement> struct_statement, std::shared_ptr<enviornment::RecordModule> module, nlohmann::json& ir_gc_map_json);
 
+    llvm::Function* _createFunction(std::shared_ptr<AST::FunctionStatement> function_declaration_statement, const std::string& symbol_name, llvm::GlobalValue::LinkageTypes linkage,
+                                    const std::vector<std::shared_ptr<enviornment::RecordStructInstance>>& param_inst_records, std::shared_ptr<enviornment::RecordStructInstance> return_type);
+    void _bindFunctionParameters(std::shared_ptr<AST::FunctionStatement> function_declaration_statement, llvm::Function* func,
+                                 const std::vector<std::shared_ptr<enviornment::RecordStructInstance>>& param_inst_records,
+                                 std::vector<std::tuple<std::string, std::shared_ptr<enviornment::RecordVariable>>>& arguments);
+    llvm::Value* _createCall(std::shared_ptr<enviornment::RecordFunction> func_record, std::vector<llvm::Value*> args);
+    std::shared_ptr<enviornment::RecordFunction> _declareExternFunction(std::shared_ptr<AST::FunctionStatement> function_declaration_statement);
+    void _applyFunctionAttributes(std::shared_ptr<AST::FunctionStatement> function_declaration_statement, llvm::Function* func);
+    void _inferFunctionAttributes();
+    llvm::GlobalValue::LinkageTypes _exportLinkage(const std::string& name);
+    void _stripDeadFunctions();
+    bool _mayCapture(llvm::Value* pointer);
+    void _applyImportedAttributes(llvm::Function* func, nlohmann::json& ir_gc_map_json);
+    bool _isMutated(std::shared_ptr<AST::Node> node, const std::string& name);
+    bool _mayWriteMemory(std::shared_ptr<AST::Node> node);
+    bool _isBorrowed(std::shared_ptr<AST::FunctionStatement> function_declaration_statement, size_t idx);
+    void _emitBoundsCheck(llvm::Value* array, llvm::Value* index, std::shared_ptr<AST::IndexExpression> index_expression);
+    void _emitBoundsBranch(llvm::Value* in_bounds, llvm::Value* index, llvm::Value* len);
+    std::pair<std::string, std::string> _boundsFactKey(std::shared_ptr<AST::IndexExpression> index_expression);
+    void _invalidateBoundsFacts(std::shared_ptr<AST::Node> node);
+    void _recordArrayLength(const std::string& name, std::shared_ptr<AST::Node> value);
+
     std::shared_ptr<enviornment::RecordStructInstance> _parseType(std::shared_ptr<AST::GenericType> type);
+
+    std::string _mangleGenerics(const std::vector<std::shared_ptr<enviornment::RecordStructInstance>>& generics);
+    enviornment::Enviornment _genericEnviornment(std::shared_ptr<enviornment::Enviornment> prev_env, std::shared_ptr<enviornment::RecordModule> module, const std::string& name);
+    std::shared_ptr<enviornment::RecordStructType> _instantiateGenericStruct(std::shared_ptr<enviornment::RecordGenericStructType> generic,
+                                                                            const std::vector<std::shared_ptr<enviornment::RecordStructInstance>>& generics);
+    std::shared_ptr<enviornment::RecordFunction> _instantiateGenericFunction(std::shared_ptr<enviornment::RecordGenericFunction> generic,
+                                                                            const std::vector<std::shared_ptr<enviornment::RecordStructInstance>>& generics);
+    std::shared_ptr<enviornment::RecordStructType> _inferGenericStruct(std::shared_ptr<enviornment::RecordGenericStructType> generic,
+                                                                      const std::vector<std::shared_ptr<enviornment::RecordStructInstance>>& params_types, std::shared_ptr<AST::Node> node);
+    std::shared_ptr<enviornment::RecordFunction> _inferGenericFunction(std::shared_ptr<enviornment::RecordGenericFunction> generic,
+                                                                      const std::vector<std::shared_ptr<enviornment::RecordStructInstance>>& params_types, std::shared_ptr<AST::Node> node);
+    std::vector<std::shared_ptr<enviornment::RecordStructInstance>> _inferGenerics(const std::vector<std::shared_ptr<AST::Expression>>& generic_parameters,
+                                                                                  const std::vector<std::shared_ptr<AST::GenericType>>& declared_types,
+                                                                                  const std::vector<std::shared_ptr<enviornment::RecordStructInstance>>& params_types, std::shared_ptr<AST::Node> node);
+    bool _bindGeneric(std::shared_ptr<AST::GenericType> declared_type, std::shared_ptr<enviornment::RecordStructInstance> param_type,
+                      std::unordered_map<std::string, std::shared_ptr<enviornment::RecordStructInstance>>& bindings);
+
     bool _checkType(std::shared_ptr<enviornment::RecordStructInstance> type1, std::shared_ptr<enviornment::RecordStructInstance> type2);
     bool _checkType(std::shared_ptr<enviornment::RecordStructInstance> type1, std::shared_ptr<enviornment::RecordStructType> type2);
     bool _checkType(std::shared_ptr<enviornment::RecordStructType> type1, std::shared_ptr<enviornment::RecordStructType> type2);
@@ -1,4 +1,5 @@
 #include "enviornment.hpp"
+#include "../../trace/trace.hpp"
 #include <memory>
 
 bool enviornment::RecordModule::is_function(std::string name) {
@@ -44,7 +45,67 @@ std::shared_ptr<enviornment::RecordModule> enviornment::RecordModule::get_module
     return nullptr;
 };
 
-void enviornment::Enviornment::add(std::shared_ptr<Record> record) { record_map[record->name] = record; }
+void enviornment::RecordStructType::add_method(std::string name, std::shared_ptr<RecordFunction> method) {
+    if (method_index.find(name) != method_index.end()) {
+        methods[method_index.at(name)] = method;
+    } else {
+        method_index[name] = methods.size();
+        methods.push_back(method);
+    }
+    if (operator_slot_methods.find(name) != operator_slot_methods.end()) {
+        operator_slots[static_cast<size_t>(operator_slot_methods.at(name))] = method;
+    }
+};
+
+bool enviornment::RecordStructType::is_method(std::string name) {
+    return method_index.find(name) != method_index.end();
+};
+
+std::shared_ptr<enviornment::RecordFunction> enviornment::RecordStructType::get_method(std::string name) {
+    if (method_index.find(name) != method_index.end())
+        return methods.at(method_index.at(name));
+    return nullptr;
+};
+
+std::shared_ptr<enviornment::RecordFunction> enviornment::RecordStructType::get_operator(OperatorSlot slot) {
+    return operator_slots[static_cast<size_t>(slot)];
+};
+
+bool enviornment::RecordModule::is_generic_struct(std::string name) {
+    if(record_map.find(name) != record_map.end())
+        return record_map.at(name)->type == RecordType::RecordGenericStructType;
+    else
+        return false;
+}
+
+std::shared_ptr<enviornment::RecordGenericStructType> enviornment::RecordModule::get_generic_struct(std::string name) {
+    if(record_map.find(name) != record_map.end())
+        if (record_map.at(name)->type == RecordType::RecordGenericStructType)
+            return std::static_pointer_cast<enviornment::RecordGenericStructType>(record_map.at(name));
+    return nullptr;
+};
+
+bool enviornment::RecordModule::is_generic_function(std::string name) {
+    if(record_map.find(name) != record_map.end())
+        return record_map.at(name)->type == RecordType::RecordGenericFunction;
+    else
+        return false;
+}
+
+std::shared_ptr<enviornment::RecordGenericFunction> enviornment::RecordModule::get_generic_function(std::string name) {
+    if(record_map.find(name) != record_map.end())
+        if (record_map.at(name)->type == RecordType::RecordGenericFunction)
+            return std::static_pointer_cast<enviornment::RecordGenericFunction>(record_map.at(name));
+    return nullptr;
+};
+
+void enviornment::Enviornment::add(std::shared_ptr<Record> record) {
+    GIGLY_TRACE(Env, Trace, "Adding " << record->name << " to scope " << this->name);
+    if (record->type == RecordType::RecordVariable) {
+        std::static_pointer_cast<RecordVariable>(record)->arena_depth = this->arenas.size();
+    }
+    record_map[record->name] = record;
+}
 
 std::shared_ptr<enviornment::Record> enviornment::Enviornment::get(std::string name, bool limit2current_scope) {
     if(record_map.find(name) != record_map.end()) {
@@ -149,3 +210,66 @@ std::shared_ptr<enviornment::RecordModule> enviornment::Enviornment::get_module(
     }
     return nullptr;
 };
+
+bool enviornment::Enviornment::is_generic_struct(std::string name, bool limit2current_scope) {
+    if(record_map.find(name) != record_map.end()) {
+        return record_map.at(name)->type == RecordType::RecordGenericStructType;
+    } else if(parent != nullptr & !limit2current_scope) {
+        return parent->is_generic_struct(name);
+    } else {
+        return false;
+    }
+};
+
+std::shared_ptr<enviornment::RecordGenericStructType> enviornment::Enviornment::get_generic_struct(std::string name, bool limit2current_scope) {
+    if(record_map.find(name) != record_map.end()) {
+        if(record_map.at(name)->type == RecordType::RecordGenericStructType) {
+            return std::static_pointer_cast<enviornment::RecordGenericStructType>(record_map.at(name));
+        }
+    } else if(parent != nullptr & !limit2current_scope) {
+        return parent->get_generic_struct(name);
+    }
+    return nullptr;
+};
+
+bool enviornment::Enviornment::is_generic_function(std::string name, bool limit2current_scope) {
+    if(record_map.find(name) != record_map.end()) {
+        return record_map.at(name)->type == RecordType::RecordGenericFunction;
+    } else if(parent != nullptr & !limit2current_scope) {
+        return parent->is_generic_function(name);
+    } else {
+        return false;
+    }
+};
+
+std::shared_ptr<enviornment::RecordGenericFunction> enviornment::Enviornment::get_generic_function(std::string name, bool limit2current_scope) {
+    if(record_map.find(name) != record_map.end()) {
+        if(record_map.at(name)->type == RecordType::RecordGenericFunction) {
+            return std::static_pointer_cast<enviornment::RecordGenericFunction>(record_map.at(name));
+        }
+    } else if(parent != nullptr & !limit2current_scope) {
+        return parent->get_generic_function(name);
+    }
+    return nullptr;
+};
+
+bool enviornment::Enviornment::is_generic_parameter(std::string name, bool limit2current_scope) {
+    if(record_map.find(name) != record_map.end()) {
+        return record_map.at(name)->type == RecordType::RecordGenericParameter;
+    } else if(parent != nullptr & !limit2current_scope) {
+        return parent->is_generic_parameter(name);
+    } else {
+        return false;
+    }
+};
+
+std::shared_ptr<enviornment::RecordGenericParameter> enviornment::Enviornment::get_generic_parameter(std::string name, bool limit2current_scope) {
+    if(record_map.find(name) != record_map.end()) {
+        if(record_map.at(name)->type == RecordType::RecordGenericParameter) {
+            return std::static_pointer_cast<enviornment::RecordGenericParameter>(record_map.at(name));
+        }
+    } else if(parent != nullptr & !limit2current_scope) {
+        return parent->get_generic_parameter(name);
+    }
+    return nullptr;
+};
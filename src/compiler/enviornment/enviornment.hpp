@@ -5,14 +5,16 @@
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/Type.h>
 #include <llvm/IR/Value.h>
+#include <array>
 #include <memory>
+#include <set>
 #include <string>
 #include <tuple>
 #include <unordered_map>
 #include <vector>
 
 namespace enviornment {
-enum class RecordType { RecordStructInst, RecordVariable, RecordFunction, RecordModule };
+enum class RecordType { RecordStructInst, RecordVariable, RecordFunction, RecordModule, RecordGenericStructType, RecordGenericFunction, RecordGenericParameter };
 
 class Record {
   public:
@@ -32,12 +34,37 @@ class RecordVariable;
 class RecordStructType;
 class RecordStructInstance;
 
+// Overloadable operators, each struct resolves its dunder methods into these slots once when declared
+enum class OperatorSlot { Add, Sub, Mul, Div, Mod, Eq, Neq, Lt, Gt, Lte, Gte, Pow, Count };
+
+static const std::unordered_map<std::string, OperatorSlot> operator_slot_methods = {
+    {"__add__", OperatorSlot::Add}, {"__sub__", OperatorSlot::Sub}, {"__mul__", OperatorSlot::Mul}, {"__div__", OperatorSlot::Div},
+    {"__mod__", OperatorSlot::Mod}, {"__eq__", OperatorSlot::Eq},   {"__neq__", OperatorSlot::Neq}, {"__lt__", OperatorSlot::Lt},
+    {"__gt__", OperatorSlot::Gt},   {"__lte__", OperatorSlot::Lte}, {"__gte__", OperatorSlot::Gte}, {"__pow__", OperatorSlot::Pow},
+};
+
+static const std::unordered_map<token::TokenType, OperatorSlot> operator_slot_tokens = {
+    {token::TokenType::Plus, OperatorSlot::Add},
+    {token::TokenType::Dash, OperatorSlot::Sub},
+    {token::TokenType::Asterisk, OperatorSlot::Mul},
+    {token::TokenType::ForwardSlash, OperatorSlot::Div},
+    {token::TokenType::Percent, OperatorSlot::Mod},
+    {token::TokenType::EqualEqual, OperatorSlot::Eq},
+    {token::TokenType::NotEquals, OperatorSlot::Neq},
+    {token::TokenType::LessThan, OperatorSlot::Lt},
+    {token::TokenType::GreaterThan, OperatorSlot::Gt},
+    {token::TokenType::LessThanOrEqual, OperatorSlot::Lte},
+    {token::TokenType::GreaterThanOrEqual, OperatorSlot::Gte},
+    {token::TokenType::AsteriskAsterisk, OperatorSlot::Pow},
+};
+
 class RecordFunction : public Record {
   public:
     llvm::Function* function = nullptr;
     llvm::FunctionType* function_type = nullptr;
     std::vector<std::tuple<std::string, std::shared_ptr<RecordVariable>>> arguments;
     std::shared_ptr<RecordStructInstance> return_inst;
+    bool c_abi = false; // extern "C": str crosses as const gigly_str*, a str result comes back through a leading out pointer
     RecordFunction(std::string name) : Record(RecordType::RecordFunction, name) {};
     RecordFunction(std::string name, llvm::Function* function, llvm::FunctionType* function_type,
                    std::vector<std::tuple<std::string, std::shared_ptr<RecordVariable>>> arguments, std::shared_ptr<RecordStructInstance> return_inst)
@@ -50,13 +77,24 @@ class RecordStructType : public Record {
     llvm::StructType* struct_type = nullptr;
     std::vector<std::string> fields = {};
     std::unordered_map<std::string, std::shared_ptr<RecordStructInstance>> sub_types = {};
-    std::unordered_map<std::string, std::shared_ptr<RecordFunction>> methods = {};
-    RecordStructType(std::string name) : Record(RecordType::RecordStructInst, name) {};
+    std::vector<std::shared_ptr<RecordFunction>> methods = {};         // declaration order
+    std::unordered_map<std::string, size_t> method_index = {};          // method name -> index into methods
+    std::array<std::shared_ptr<RecordFunction>, static_cast<size_t>(OperatorSlot::Count)> operator_slots = {};
+    std::vector<std::shared_ptr<RecordStructInstance>> generic_arguments = {}; // bound type arguments when this is a monomorphized generic struct
+    std::vector<std::vector<unsigned>> pointer_fields = {}; // GEP paths to every heap pointer in the layout, the collector's type descriptor is built from them
+    std::vector<std::vector<unsigned>> string_fields = {};  // GEP paths to every `str` in the layout
+    bool is_unsigned = false;                                // u8..u64 and their vectors: division, remainder, comparisons and right shifts ignore the sign
+    std::string symbol_name;                                 // name prefixed with the declaring module, methods and generic instances are named after it
+    RecordStructType(std::string name) : Record(RecordType::RecordStructInst, name), symbol_name(name) {};
     RecordStructType(std::string name, llvm::StructType* struct_type, std::vector<std::string> variable_names,
                     std::unordered_map<std::string, std::shared_ptr<RecordFunction>> functions = {})
-        : Record(RecordType::RecordStructInst, name), struct_type(struct_type), fields(variable_names) {};
+        : Record(RecordType::RecordStructInst, name), struct_type(struct_type), fields(variable_names), symbol_name(name) {};
     RecordStructType(std::string name, llvm::Type* stand_alone_type)
-        : Record(RecordType::RecordStructInst, name), stand_alone_type(stand_alone_type) {};
+        : Record(RecordType::RecordStructInst, name), stand_alone_type(stand_alone_type), symbol_name(name) {};
+    void add_method(std::string name, std::shared_ptr<RecordFunction> method);
+    bool is_method(std::string name);
+    std::shared_ptr<RecordFunction> get_method(std::string name);
+    std::shared_ptr<RecordFunction> get_operator(OperatorSlot slot);
 };
 
 class RecordStructInstance {
@@ -68,13 +106,46 @@ class RecordStructInstance {
         : struct_type(struct_type), generic(generic) {};
 };
 
+// Type parameter bound to a concrete type while a generic declaration is being monomorphized
+class RecordGenericParameter : public Record {
+  public:
+    std::shared_ptr<RecordStructInstance> instance;
+    RecordGenericParameter(std::string name, std::shared_ptr<RecordStructInstance> instance) : Record(RecordType::RecordGenericParameter, name), instance(instance) {};
+};
+
+class RecordModule;
+
+// Generic struct declaration, every instantiation is compiled once and cached by its mangled type arguments
+class RecordGenericStructType : public Record {
+  public:
+    std::shared_ptr<AST::StructStatement> declaration;
+    std::string symbol_name; // base symbol name, instances append their mangled type arguments
+    std::shared_ptr<RecordModule> module = nullptr; // declaring module when imported, nullptr when local
+    std::unordered_map<std::string, std::shared_ptr<RecordStructType>> instances = {};
+    RecordGenericStructType(std::string name, std::shared_ptr<AST::StructStatement> declaration, std::string symbol_name, std::shared_ptr<RecordModule> module = nullptr)
+        : Record(RecordType::RecordGenericStructType, name), declaration(declaration), symbol_name(symbol_name), module(module) {};
+};
+
+// Generic function declaration, every instantiation is compiled once and cached by its mangled type arguments
+class RecordGenericFunction : public Record {
+  public:
+    std::shared_ptr<AST::FunctionStatement> declaration;
+    std::string symbol_name; // base symbol name, instances append their mangled type arguments
+    std::shared_ptr<RecordModule> module = nullptr; // declaring module when imported, nullptr when local
+    std::unordered_map<std::string, std::shared_ptr<RecordFunction>> instances = {};
+    RecordGenericFunction(std::string name, std::shared_ptr<AST::FunctionStatement> declaration, std::string symbol_name, std::shared_ptr<RecordModule> module = nullptr)
+        : Record(RecordType::RecordGenericFunction, name), declaration(declaration), symbol_name(symbol_name), module(module) {};
+};
+
 class RecordVariable : public Record {
   public:
     llvm::Value* value;
-    llvm::AllocaInst* allocainst;
+    llvm::Value* allocainst; // storage of the variable, a borrowed struct parameter points straight at the caller's memory
     std::shared_ptr<RecordStructInstance> variableType = nullptr;
+    bool is_volatile = false; // every load and store of the variable and its fields is volatile
+    size_t arena_depth = 0;   // arena blocks open where the variable was declared, heap values stored into it must outlive them
     RecordVariable(std::string name) : Record(RecordType::RecordVariable, name) {};
-    RecordVariable(std::string name, llvm::Value* value, llvm::AllocaInst* allocainst, std::shared_ptr<RecordStructInstance> generic)
+    RecordVariable(std::string name, llvm::Value* value, llvm::Value* allocainst, std::shared_ptr<RecordStructInstance> generic)
     : Record(RecordType::RecordVariable, name), value(value), allocainst(allocainst), variableType(generic) {};
 };
 
@@ -90,6 +161,10 @@ class RecordModule : public Record {
     std::shared_ptr<RecordStructType> get_struct(std::string name);
     bool is_module(std::string name);
     std::shared_ptr<RecordModule> get_module(std::string name);
+    bool is_generic_struct(std::string name);
+    std::shared_ptr<RecordGenericStructType> get_generic_struct(std::string name);
+    bool is_generic_function(std::string name);
+    std::shared_ptr<RecordGenericFunction> get_generic_function(std::string name);
 };
 
 class Enviornment {
@@ -103,6 +178,13 @@ class Enviornment {
     std::vector<llvm::BasicBlock*> loop_body_block = {};
     std::vector<llvm::BasicBlock*> loop_end_block = {};
     std::vector<llvm::BasicBlock*> loop_condition_block = {};
+    std::vector<size_t> loop_arena_depth = {}; // number of open arenas when each loop was entered
+
+    std::vector<llvm::Value*> arenas = {}; // arena blocks open at this point of the function, innermost last
+
+    // Bounds-check elimination facts, valid on every path reaching the code being compiled
+    std::set<std::pair<std::string, std::string>> checked_indices = {}; // (array, index) pairs already proven in bounds
+    std::unordered_map<std::string, int64_t> array_min_lengths = {};   // lower bound on the length of array variables
 
     Enviornment(std::shared_ptr<Enviornment> parent = nullptr, std::unordered_map<std::string, std::shared_ptr<Record>> records = {},
                 std::string name = "unnamed")
@@ -120,5 +202,11 @@ class Enviornment {
     bool is_module(std::string name, bool limit2current_scope = false);
     std::shared_ptr<RecordModule> get_module(std::string
         name, bool limit2current_scope = false);
+    bool is_generic_struct(std::string name, bool limit2current_scope = false);
+    std::shared_ptr<RecordGenericStructType> get_generic_struct(std::string name, bool limit2current_scope = false);
+    bool is_generic_function(std::string name, bool limit2current_scope = false);
+    std::shared_ptr<RecordGenericFunction> get_generic_function(std::string name, bool limit2current_scope = false);
+    bool is_generic_parameter(std::string name, bool limit2current_scope = false);
+    std::shared_ptr<RecordGenericParameter> get_generic_parameter(std::string name, bool limit2current_scope = false);
 }; // class Environment
 } // namespace enviornment
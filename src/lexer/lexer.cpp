@@ -1,6 +1,7 @@
 #include "../errors/errors.hpp"
 #include "token.hpp"
 #include "lexer.hpp"
+#include "../trace/trace.hpp"
 
 Lexer::Lexer(const std::string& source) {
     this->source = source;
@@ -50,6 +51,10 @@ token::TokenType Lexer::_lookupIdent(std::shared_ptr<std::string> ident) {
     return token::TokenType::Use;
     } else if(*ident == "import") {
         return token::TokenType::Import;
+    } else if(*ident == "arena") {
+        return token::TokenType::Arena;
+    } else if(*ident == "extern") {
+        return token::TokenType::Extern;
     } else if(*ident == "True") {
         return token::TokenType::True;
     } else if(*ident == "False") {
@@ -188,19 +193,21 @@ std::shared_ptr<token::Token> Lexer::nextToken() {
             token = this->_newToken(token::TokenType::BitwiseAnd, this->current_char + *this->_peekChar());
             this->_readChar();
         } else {
-            token = this->_newToken(token::TokenType::Illegal, this->current_char);
+            token = this->_newToken(token::TokenType::BitwiseAnd, this->current_char);
         }
     } else if(this->current_char == "|") {
         if(*this->_peekChar() == "|") {
             token = this->_newToken(token::TokenType::BitwiseOr, this->current_char + *this->_peekChar());
             this->_readChar();
         } else {
-            token = this->_newToken(token::TokenType::Illegal, this->current_char);
+            token = this->_newToken(token::TokenType::BitwiseOr, this->current_char);
         }
     } else if(this->current_char == "~") {
         token = this->_newToken(token::TokenType::BitwiseNot, this->current_char);
     } else if(this->current_char == ",") {
         token = this->_newToken(token::TokenType::Comma, this->current_char);
+    } else if(this->current_char == "@") {
+        token = this->_newToken(token::TokenType::At, this->current_char);
     } else if(this->current_char == "") {
         token = this->_newToken(token::TokenType::EndOfFile, "");
     } else {
@@ -220,6 +227,7 @@ std::shared_ptr<token::Token> Lexer::nextToken() {
         }
     }
     this->_readChar();
+    GIGLY_TRACE(Lexer, Trace, token->toString(false));
     return token;
 }
 
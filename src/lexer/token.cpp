@@ -117,6 +117,8 @@ std::shared_ptr<std::string> token::tokenTypeString(TokenType type) {
         return std::make_shared<std::string>("RightArrow");
     case TokenType::Comma:
         return std::make_shared<std::string>("Comma");
+    case TokenType::At:
+        return std::make_shared<std::string>("At");
     case TokenType::Equals:
         return std::make_shared<std::string>("Equals");
     case TokenType::Illegal:
@@ -191,6 +193,10 @@ std::shared_ptr<std::string> token::tokenTypeString(TokenType type) {
     //     return std::make_shared<std::string>("Maybe");
     case TokenType::Import:
         return std::make_shared<std::string>("Import");
+    case TokenType::Arena:
+        return std::make_shared<std::string>("Arena");
+    case TokenType::Extern:
+        return std::make_shared<std::string>("Extern");
     case TokenType::None:
         return std::make_shared<std::string>("None");
     case TokenType::String:
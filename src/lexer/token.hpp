@@ -33,7 +33,7 @@ enum class TokenType {
     DashEqual,          // Subtraction assignment -=
     AsteriskEqual,      // Multiplication assignment *=
     PercentEqual,       // Modulus assignment %=
-    CaretEqual,         // Exponentiation assignment ^=
+    CaretEqual,         // Bitwise xor assignment ^=
     ForwardSlashEqual,  // Division assignment /=
     BackwardSlashEqual, // Division assignment \=
     Equals,             // Equals sign =
@@ -44,8 +44,8 @@ enum class TokenType {
     Decrement, // Decrement --
 
     // Bitwise Operators
-    BitwiseAnd, // Bitwise AND &&
-    BitwiseOr,  // Bitwise OR ||
+    BitwiseAnd, // Bitwise AND & or &&
+    BitwiseOr,  // Bitwise OR | or ||
     BitwiseXor, // Bitwise XOR ^
     BitwiseNot, // Bitwise NOT ~
     LeftShift,  // Left shift <<
@@ -73,6 +73,7 @@ enum class TokenType {
     Semicolon,    // Semicolon ;
     RightArrow,   // Right Arrow ->
     Comma,        // Comma ,
+    At,           // At sign @, starts an attribute
 
     // Keywords
     And,      // Logical AND and
@@ -93,6 +94,8 @@ enum class TokenType {
     Volatile, // volatile
     Use,
     Import,   // import
+    Arena,    // Arena Statement arena
+    Extern,   // External declaration extern
     True,     // Boolean true true
     False,    // Boolean false false
     // Maybe,    // Maybe type maybe
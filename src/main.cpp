@@ -1,10 +1,14 @@
+#include <algorithm>
+#include <cstdio>
 #include <exception>
 #include <iostream>
 #include <string>
 #include <fstream>
 #include <sstream>
 #include <filesystem>
+#include <optional>
 #include <tuple>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 #include "include/json.hpp"
@@ -12,11 +16,18 @@
 #include "lexer/lexer.hpp"
 #include "parser/parser.hpp"
 #include "compiler/compiler.hpp"
+#include "trace/trace.hpp"
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/TimeProfiler.h>
+#include <llvm/Support/raw_ostream.h>
 
 // #define DEBUG_LEXER
 // #define DEBUG_PARSER
 #define DEBUG_LEXER_OUTPUT_PATH "./dump/lexer_output.log"
 #define DEBUG_PARSER_OUTPUT_PATH "./dump/parser_output.json"
+#ifndef GIGGLY_RUNTIME_DIR
+#define GIGGLY_RUNTIME_DIR "./src/runtime"
+#endif
 
 using json = nlohmann::json;
 
@@ -75,8 +86,13 @@ void setIrGcMap(const std::string& filePath, const std::string& ir_gc_map, json&
     ir_gc_map_file_out.close();
 }
 
-void compileFile(const std::string& filePath, const std::string& outputFilePath, const std::string& ir_gc_map, const std::string& objFilePath, json& compiledFilesRecord, const std::string& optimizationLevel) {
-    std::string fileContent = readFileToString(filePath);
+void compileFile(const std::string& filePath, const std::string& outputFilePath, const std::string& ir_gc_map, const std::string& objFilePath, json& compiledFilesRecord, const std::string& optimizationLevel, bool unchecked) {
+    llvm::TimeTraceScope fileScope("File", filePath);
+    std::string fileContent;
+    {
+        llvm::TimeTraceScope scope("ReadFile", filePath);
+        fileContent = readFileToString(filePath);
+    }
 
     // Check if the file has changed
     std::hash<std::string> hasher;
@@ -135,34 +151,50 @@ void compileFile(const std::string& filePath, const std::string& outputFilePath,
         std::cout << "Parser output dumped to " << DEBUG_PARSER_OUTPUT_PATH << std::endl;
     }
 #endif
-    // Lexer
-    Lexer lexer(fileContent);
-    // Parser
-    parser::Parser parsr(std::make_shared<Lexer>(lexer));
-    auto program = parsr.parseProgram();
-    for (auto& err : parsr.errors) {
-        err->raise(false);
-    }
-    if (parsr.errors.size() > 0) {
-            return;
+    // Lexer, tokens are produced on demand while parsing
+    std::shared_ptr<AST::Program> program;
+    {
+        llvm::TimeTraceScope scope("Parse", filePath);
+        Lexer lexer(fileContent);
+        // Parser
+        parser::Parser parsr(std::make_shared<Lexer>(lexer));
+        program = parsr.parseProgram();
+        for (auto& err : parsr.errors) {
+            err->raise(false);
+        }
+        if (parsr.errors.size() > 0) {
+                return;
+        }
     }
     // Compiler
     auto comp = compiler::Compiler(fileContent, std::filesystem::absolute(filePath), std::filesystem::path(ir_gc_map));
-    comp.compile(program);
-    std::error_code EC;
-    llvm::raw_fd_ostream file(outputFilePath, EC, llvm::sys::fs::OF_None);
-    if (EC) {
-            std::cerr << "Could not open file " << outputFilePath << ": " << EC.message() << std::endl;
-            exit(1);
+    comp.bounds_checks = !unchecked;
+    {
+        llvm::TimeTraceScope scope("Codegen", filePath);
+        comp.compile(program);
+    }
+    {
+        llvm::TimeTraceScope scope("PrintIR", outputFilePath);
+        std::error_code EC;
+        llvm::raw_fd_ostream file(outputFilePath, EC, llvm::sys::fs::OF_None);
+        if (EC) {
+                std::cerr << "Could not open file " << outputFilePath << ": " << EC.message() << std::endl;
+                exit(1);
+        }
+        comp.llvm_module->print(file, nullptr);
+        file.close();
     }
-    comp.llvm_module->print(file, nullptr);
-    file.close();
     std::cout << "Output File: " << outputFilePath << std::endl;
 
-    // Convert .ll to .o using clang
+    // Convert .ll to .o using clang, with --time-trace clang writes its own trace next to the object file
     std::filesystem::create_directories(std::filesystem::path(objFilePath).parent_path());
-    std::string command = "clang -c " + outputFilePath + " -o " + objFilePath + " -Woverride-module" + (optimizationLevel != "" ? (" -O" + optimizationLevel) : "");
-    int result = std::system(command.c_str());
+    std::string command = "clang -c " + outputFilePath + " -o " + objFilePath + " -Woverride-module -ffunction-sections -fdata-sections" + (optimizationLevel != "" ? (" -O" + optimizationLevel) : "") +
+                          (llvm::timeTraceProfilerEnabled() ? " -ftime-trace" : "");
+    int result;
+    {
+        llvm::TimeTraceScope scope("Clang", objFilePath);
+        result = std::system(command.c_str());
+    }
     if (result != 0) {
         std::cerr << "Error: Failed to convert " << outputFilePath << " to " << objFilePath << std::endl;
     } else {
@@ -181,7 +213,7 @@ void compileFile(const std::string& filePath, const std::string& outputFilePath,
     std::cout << "Done Working on File: " << filePath << std::endl;
 }
 
-void compileDirectory(const std::string& srcDir, const std::string& buildDir, json& compiledFilesRecord, const std::string& optimizationLevel) {
+void compileDirectory(const std::string& srcDir, const std::string& buildDir, json& compiledFilesRecord, const std::string& optimizationLevel, bool unchecked) {
     std::unordered_set<std::string> currentFiles;
 
     // update the ir_gc_map file
@@ -203,7 +235,7 @@ void compileDirectory(const std::string& srcDir, const std::string& buildDir, js
             while (!filesRecord.empty()) {
                 try {
                     auto& fileTuple = filesRecord.back();
-                    compileFile(std::get<0>(fileTuple), std::get<1>(fileTuple), std::get<2>(fileTuple), std::get<3>(fileTuple), compiledFilesRecord, optimizationLevel);
+                    compileFile(std::get<0>(fileTuple), std::get<1>(fileTuple), std::get<2>(fileTuple), std::get<3>(fileTuple), compiledFilesRecord, optimizationLevel, unchecked);
                     filesRecord.pop_back();
                 }
                 catch (const compiler::NotCompiledError& e) {
@@ -223,6 +255,125 @@ void compileDirectory(const std::string& srcDir, const std::string& buildDir, js
     }
 }
 
+// Compiles the C runtime the generated code calls into, its objects are linked like any other .o in the build
+void compileRuntime(const std::string& buildDir) {
+    llvm::TimeTraceScope scope("CompileRuntime");
+    std::string runtimeObjDir = buildDir + "/obj/gigly_runtime";
+    std::filesystem::create_directories(runtimeObjDir);
+    // gigly_runtime.h shares struct layouts with the compiler, editing it has to rebuild every object
+    auto headers_time = std::filesystem::file_time_type::min();
+    for (const auto& entry : std::filesystem::directory_iterator(GIGGLY_RUNTIME_DIR)) {
+        if (entry.is_regular_file() && entry.path().extension() != ".c") {
+            headers_time = std::max(headers_time, entry.last_write_time());
+        }
+    }
+    for (const auto& entry : std::filesystem::directory_iterator(GIGGLY_RUNTIME_DIR)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".c") {
+            std::string objFilePath = runtimeObjDir + "/" + entry.path().stem().string() + ".o";
+            if (std::filesystem::exists(objFilePath) && std::filesystem::last_write_time(objFilePath) >= std::max(entry.last_write_time(), headers_time)) {
+                continue;
+            }
+            std::string command = "clang -c " + entry.path().string() + " -o " + objFilePath + " -O2 -ffunction-sections -fdata-sections -I" + GIGGLY_RUNTIME_DIR;
+            if (std::system(command.c_str()) != 0) {
+                std::cerr << "Error: Failed to compile runtime " << entry.path().string() << std::endl;
+                exit(1);
+            }
+        }
+    }
+}
+
+// Compiles C and C++ sources found next to the .gc files, extern "C" declarations link against them.
+// Returns true when any of them is C++ so the C++ standard library gets linked.
+bool compileForeignSources(const std::string& srcDir, const std::string& buildDir) {
+    llvm::TimeTraceScope scope("CompileForeign");
+    bool cpp = false;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(srcDir)) {
+        auto extension = entry.path().extension();
+        if (!entry.is_regular_file() || (extension != ".c" && extension != ".cpp" && extension != ".cc")) {
+            continue;
+        }
+        cpp = cpp || extension != ".c";
+        std::string relativePath = std::filesystem::relative(entry.path(), srcDir).string();
+        std::string objFilePath = buildDir + "/obj/foreign/" + relativePath.substr(0, relativePath.find_last_of('.')) + ".o";
+        std::filesystem::create_directories(std::filesystem::path(objFilePath).parent_path());
+        if (std::filesystem::exists(objFilePath) && std::filesystem::last_write_time(objFilePath) >= entry.last_write_time()) {
+            continue;
+        }
+        std::string command = std::string(extension == ".c" ? "clang" : "clang++") + " -c " + entry.path().string() + " -o " + objFilePath + " -O2 -ffunction-sections -fdata-sections -I" + GIGGLY_RUNTIME_DIR;
+        if (std::system(command.c_str()) != 0) {
+            std::cerr << "Error: Failed to compile " << entry.path().string() << std::endl;
+            exit(1);
+        }
+    }
+    return cpp;
+}
+
+// Writes the --time-trace profile as Chrome trace JSON (chrome://tracing, ui.perfetto.dev) and prints the time spent per phase.
+// The traces clang wrote for this build's objects are merged in as separate processes, shifted onto the compiler's clock.
+void writeTimeTrace(const std::string& buildDir, const std::string& tracePath) {
+    llvm::SmallString<0> buffer;
+    llvm::raw_svector_ostream bufferStream(buffer);
+    llvm::timeTraceProfilerWrite(bufferStream);
+    llvm::timeTraceProfilerCleanup();
+    json trace = json::parse(buffer.str().str());
+    auto beginningOfTime = trace.value("beginningOfTime", int64_t(0));
+    auto& events = trace["traceEvents"];
+    int pid = 1;
+    for (const auto& event : events) {
+        pid = std::max(pid, event.value("pid", 0));
+    }
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(buildDir + "/obj")) {
+        if (!entry.is_regular_file() || entry.path().extension() != ".json") {
+            continue;
+        }
+        std::ifstream clangTraceFile(entry.path());
+        json clangTrace = json::parse(clangTraceFile, nullptr, false);
+        // objects skipped as unchanged keep the trace of an earlier build
+        if (clangTrace.is_discarded() || clangTrace.value("beginningOfTime", int64_t(0)) < beginningOfTime) {
+            continue;
+        }
+        int64_t offset = clangTrace["beginningOfTime"].get<int64_t>() - beginningOfTime;
+        pid++;
+        for (auto& event : clangTrace["traceEvents"]) {
+            event["pid"] = pid;
+            if (event.value("ph", "") == "X" && !event.value("name", "").starts_with("Total ")) {
+                event["ts"] = event["ts"].get<int64_t>() + offset;
+            }
+            events.push_back(event);
+        }
+        events.push_back({{"ph", "M"}, {"pid", pid}, {"tid", 0}, {"name", "process_name"}, {"args", {{"name", "clang " + entry.path().stem().string()}}}});
+    }
+    std::ofstream traceFile(tracePath, std::ios::trunc);
+    if (!traceFile.is_open()) {
+        std::cerr << "Error: Could not open time trace file " << tracePath << std::endl;
+        return;
+    }
+    traceFile << trace.dump();
+    traceFile.close();
+
+    // Summary: total duration and count per event name, nested events count towards their parents as well
+    std::unordered_map<std::string, std::pair<int64_t, int>> phases;
+    int64_t wallTime = 0;
+    for (const auto& event : events) {
+        auto name = event.value("name", "");
+        if (event.value("ph", "") != "X" || name.starts_with("Total ")) {
+            continue;
+        }
+        auto& [duration, count] = phases[name];
+        duration += event.value("dur", int64_t(0));
+        count++;
+        if (name == "Build") {
+            wallTime = event.value("dur", int64_t(0));
+        }
+    }
+    std::vector<std::pair<std::string, std::pair<int64_t, int>>> rows(phases.begin(), phases.end());
+    std::sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) { return a.second.first > b.second.first; });
+    std::printf("===== Time trace (%s) =====\n%12s %7s %7s  %s\n", tracePath.c_str(), "ms", "%", "count", "phase");
+    for (const auto& [name, phase] : rows) {
+        std::printf("%12.3f %6.1f%% %7d  %s\n", phase.first / 1000.0, wallTime ? 100.0 * phase.first / wallTime : 0.0, phase.second, name.c_str());
+    }
+}
+
 int main(int argc, char* argv[]) {
     CLI::App app{"Folder Compiler"};
 
@@ -235,8 +386,41 @@ int main(int argc, char* argv[]) {
     std::string executablePath;
     app.add_option("-o,--output", executablePath, "Output executable path")->required();
 
+    bool unchecked = false;
+    app.add_flag("--unchecked", unchecked, "Drop array bounds checks (release builds)");
+
+    std::vector<std::string> libraries;
+    app.add_option("-l,--library", libraries, "Link against a system library, e.g. -l m for libm")->required(false);
+
+    std::vector<std::string> traces;
+    app.add_option("--trace", traces, "Trace the compiler, e.g. --trace=codegen:debug,import (lexer, parser, env, codegen, import or all; error, warn, info, debug or trace)")
+        ->delimiter(',')
+        ->required(false);
+
+    bool timeTrace = false;
+    app.add_flag("--time-trace", timeTrace, "Profile the build, writes <output>.time-trace.json in Chrome trace format and prints a summary");
+
+    unsigned timeTraceGranularity = 500;
+    app.add_option("--time-trace-granularity", timeTraceGranularity, "Minimum duration in microseconds of a recorded --time-trace event")->required(false);
+
     CLI11_PARSE(app, argc, argv);
 
+    for (const auto& spec : traces) {
+        if (!trace::configure(spec)) {
+            std::cerr << "Error: Unknown trace category or level: " << spec << std::endl;
+            return 1;
+        }
+    }
+    if (!traces.empty() && !trace::compiled_in) {
+        std::cerr << "Warning: --trace has no effect, tracing is compiled out of release builds" << std::endl;
+    }
+
+    if (timeTrace) {
+        llvm::timeTraceProfilerInitialize(timeTraceGranularity, "gigly");
+    }
+    std::optional<llvm::TimeTraceScope> buildScope;
+    buildScope.emplace("Build", executablePath);
+
     std::string srcDir = inputFolderPath + "/src";
     std::string buildDir = inputFolderPath + "/build";
     std::string irDir = buildDir + "/ir";
@@ -265,7 +449,7 @@ int main(int argc, char* argv[]) {
     }
 
     // Compile the files in the src directory
-    compileDirectory(srcDir, buildDir, compiledFilesRecord, optimizationLevel);
+    compileDirectory(srcDir, buildDir, compiledFilesRecord, optimizationLevel, unchecked);
 
     // Save the compiled files record
     std::ofstream recordFile(recordFilePath, std::ios::trunc);
@@ -274,6 +458,9 @@ int main(int argc, char* argv[]) {
         recordFile.close();
     }
 
+    compileRuntime(buildDir);
+    bool foreignCpp = compileForeignSources(srcDir, buildDir);
+
     // Link all .o files into a single executable
     std::string objFiles;
     for (const auto& entry : std::filesystem::recursive_directory_iterator(buildDir + "/obj")) {
@@ -282,8 +469,28 @@ int main(int argc, char* argv[]) {
         }
     }
 
-    std::string linkCommand = "clang " + objFiles + "-o " + executablePath;
-    int linkResult = std::system(linkCommand.c_str());
+    // every function and global sits in its own section, the linker drops the ones nothing reaches from main
+#ifdef __APPLE__
+    std::string linkCommand = "clang " + objFiles + "-o " + executablePath + " -Wl,-dead_strip";
+#else
+    // float ** lowers to llvm.pow, which becomes a libm call; macOS keeps libm in libSystem
+    std::string linkCommand = "clang " + objFiles + "-o " + executablePath + " -Wl,--gc-sections -lm";
+#endif
+    for (const auto& library : libraries) {
+        linkCommand += " -l" + library;
+    }
+    if (foreignCpp) {
+        linkCommand += " -lstdc++";
+    }
+    int linkResult;
+    {
+        llvm::TimeTraceScope scope("Link", executablePath);
+        linkResult = std::system(linkCommand.c_str());
+    }
+    buildScope.reset();
+    if (timeTrace) {
+        writeTimeTrace(buildDir, executablePath + ".time-trace.json");
+    }
     if (linkResult != 0) {
         std::cerr << "Error: Failed to link object files into executable " << executablePath << std::endl;
         return 1;
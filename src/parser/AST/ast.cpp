@@ -28,6 +28,8 @@ std::shared_ptr<std::string> AST::nodeTypeToString(NodeType type) {
         return std::make_shared<std::string>("UnionType");
     case NodeType::InfixedExpression:
         return std::make_shared<std::string>("InfixedExpression");
+    case NodeType::PrefixedExpression:
+        return std::make_shared<std::string>("PrefixedExpression");
     case NodeType::IntegerLiteral:
         return std::make_shared<std::string>("IntegerLiteral");
     case NodeType::FloatLiteral:
@@ -42,6 +44,10 @@ std::shared_ptr<std::string> AST::nodeTypeToString(NodeType type) {
         return std::make_shared<std::string>("IfElseStatement");
     case NodeType::WhileStatement:
         return std::make_shared<std::string>("WhileStatement");
+    case NodeType::ForStatement:
+        return std::make_shared<std::string>("ForStatement");
+    case NodeType::ArenaStatement:
+        return std::make_shared<std::string>("ArenaStatement");
     case NodeType::BreakStatement:
         return std::make_shared<std::string>("BreakStatement");
     case NodeType::ContinueStatement:
@@ -113,7 +119,18 @@ std::shared_ptr<nlohmann::json> AST::FunctionStatement::toJSON() {
         jsonAst["parameters"].push_back(*param->toJSON());
     }
     jsonAst["return_type"] = *this->return_type->toJSON();
-    jsonAst["body"] = *this->body->toJSON();
+    jsonAst["body"] = this->body ? *this->body->toJSON() : nlohmann::json();
+    jsonAst["generics"] = nlohmann::json::array();
+    for(auto& gen : this->generics) {
+        jsonAst["generics"].push_back(*gen->toJSON());
+    }
+    jsonAst["attributes"] = nlohmann::json::array();
+    for(auto& attribute : this->attributes) {
+        jsonAst["attributes"].push_back(*attribute->toJSON());
+    }
+    if(!this->extern_abi.empty()) {
+        jsonAst["extern"] = this->extern_abi;
+    }
     return std::make_shared<nlohmann::json>(jsonAst);
 }
 
@@ -153,6 +170,23 @@ std::shared_ptr<nlohmann::json> AST::WhileStatement::toJSON() {
     return std::make_shared<nlohmann::json>(jsonAst);
 }
 
+std::shared_ptr<nlohmann::json> AST::ForStatement::toJSON() {
+    auto jsonAst = nlohmann::json();
+    jsonAst["type"] = *nodeTypeToString(this->type());
+    jsonAst["variable"] = *this->variable->toJSON();
+    jsonAst["iterable"] = *this->iterable->toJSON();
+    jsonAst["body"] = *this->body->toJSON();
+    return std::make_shared<nlohmann::json>(jsonAst);
+}
+
+std::shared_ptr<nlohmann::json> AST::ArenaStatement::toJSON() {
+    auto jsonAst = nlohmann::json();
+    jsonAst["type"] = *nodeTypeToString(this->type());
+    jsonAst["chunk_size"] = this->chunk_size ? *this->chunk_size->toJSON() : nullptr;
+    jsonAst["body"] = *this->body->toJSON();
+    return std::make_shared<nlohmann::json>(jsonAst);
+}
+
 std::shared_ptr<nlohmann::json> AST::BreakStatement::toJSON() {
     auto jsonAst = nlohmann::json();
     jsonAst["type"] = *nodeTypeToString(this->type());
@@ -189,6 +223,7 @@ std::shared_ptr<nlohmann::json> AST::VariableAssignmentStatement::toJSON() {
     jsonAst["type"] = *nodeTypeToString(this->type());
     jsonAst["name"] = *this->name->toJSON();
     jsonAst["value"] = *value->toJSON();
+    jsonAst["compound"] = this->is_compound;
     return std::make_shared<nlohmann::json>(jsonAst);
 }
 
@@ -201,11 +236,20 @@ std::shared_ptr<nlohmann::json> AST::InfixExpression::toJSON() {
     return std::make_shared<nlohmann::json>(jsonAst);
 }
 
+std::shared_ptr<nlohmann::json> AST::PrefixExpression::toJSON() {
+    auto jsonAst = nlohmann::json();
+    jsonAst["type"] = *nodeTypeToString(this->type());
+    jsonAst["operator"] = *token::tokenTypeString(this->op);
+    jsonAst["right_node"] = this->right == nullptr ? nullptr : *right->toJSON();
+    return std::make_shared<nlohmann::json>(jsonAst);
+}
+
 std::shared_ptr<nlohmann::json> AST::IndexExpression::toJSON() {
     auto jsonAst = nlohmann::json();
     jsonAst["type"] = *nodeTypeToString(this->type());
     jsonAst["left_node"] = *(left->toJSON());
     jsonAst["index"] = *(index->toJSON());
+    jsonAst["end"] = end ? *(end->toJSON()) : nullptr;
     return std::make_shared<nlohmann::json>(jsonAst);
 }
 
@@ -252,6 +296,10 @@ std::shared_ptr<nlohmann::json> AST::StructStatement::toJSON() {
     for(auto& field : this->fields) {
         jsonAst["fields"].push_back(*field->toJSON());
     }
+    jsonAst["generics"] = nlohmann::json::array();
+    for(auto& gen : this->generics) {
+        jsonAst["generics"].push_back(*gen->toJSON());
+    }
     return std::make_shared<nlohmann::json>(jsonAst);
 }
 
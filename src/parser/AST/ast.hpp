@@ -25,6 +25,8 @@ enum class NodeType {
     ReturnStatement,
     IfElseStatement,
     WhileStatement,
+    ForStatement,
+    ArenaStatement,
     BreakStatement,
     ContinueStatement,
     StructStatement,
@@ -36,6 +38,7 @@ enum class NodeType {
 
     // Expressions
     InfixedExpression,
+    PrefixedExpression,
     IndexExpression,
 
     // Literals
@@ -127,6 +130,8 @@ class FunctionParameter : public Node {
     std::shared_ptr<nlohmann::json> toJSON() override;
 };
 
+class CallExpression;
+
 class FunctionStatement : public Statement {
   public:
     std::shared_ptr<Expression> name;
@@ -134,9 +139,12 @@ class FunctionStatement : public Statement {
     std::vector<std::shared_ptr<FunctionParameter>> closure_parameters;
     std::shared_ptr<GenericType> return_type;
     std::shared_ptr<BlockStatement> body;
+    std::vector<std::shared_ptr<Expression>> generics = {}; // type parameters, e.g. def f[T](...)
+    std::vector<std::shared_ptr<CallExpression>> attributes = {}; // @name or @name(args) lines before the declaration
+    std::string extern_abi = "";                                  // "C" for extern "C" declarations, which have no body
     inline FunctionStatement(std::shared_ptr<Expression> name, std::vector<std::shared_ptr<FunctionParameter>> parameters, std::vector<std::shared_ptr<FunctionParameter>> closure_parameters,
-                             std::shared_ptr<GenericType> return_type, std::shared_ptr<BlockStatement> body)
-        : name(name), parameters(parameters), closure_parameters(closure_parameters), return_type(return_type), body(body) {}
+                             std::shared_ptr<GenericType> return_type, std::shared_ptr<BlockStatement> body, std::vector<std::shared_ptr<Expression>> generics = {})
+        : name(name), parameters(parameters), closure_parameters(closure_parameters), return_type(return_type), body(body), generics(generics) {}
     inline NodeType type() override { return NodeType::FunctionStatement; };
     std::shared_ptr<nlohmann::json> toJSON() override;
 };
@@ -172,6 +180,26 @@ class WhileStatement : public Statement {
     std::shared_ptr<nlohmann::json> toJSON() override;
 };
 
+class ForStatement : public Statement {
+  public:
+    std::shared_ptr<Expression> variable;
+    std::shared_ptr<Expression> iterable;
+    std::shared_ptr<Statement> body;
+    inline ForStatement(std::shared_ptr<Expression> variable, std::shared_ptr<Expression> iterable, std::shared_ptr<Statement> body)
+        : variable(variable), iterable(iterable), body(body) {}
+    inline NodeType type() override { return NodeType::ForStatement; };
+    std::shared_ptr<nlohmann::json> toJSON() override;
+};
+
+class ArenaStatement : public Statement {
+  public:
+    std::shared_ptr<Expression> chunk_size; // optional, bytes reserved per arena chunk
+    std::shared_ptr<Statement> body;
+    inline ArenaStatement(std::shared_ptr<Expression> chunk_size, std::shared_ptr<Statement> body) : chunk_size(chunk_size), body(body) {}
+    inline NodeType type() override { return NodeType::ArenaStatement; };
+    std::shared_ptr<nlohmann::json> toJSON() override;
+};
+
 class BreakStatement : public Statement {
   public:
     int loopIdx = 0;
@@ -212,7 +240,9 @@ class VariableAssignmentStatement : public Statement {
   public:
     std::shared_ptr<Expression> name;
     std::shared_ptr<Expression> value;
-    inline VariableAssignmentStatement(std::shared_ptr<Expression> name, std::shared_ptr<Expression> value) : name(name), value(value) {}
+    bool is_compound = false; // `x op= e` and `x++`, value is then the `x op e` infix
+    inline VariableAssignmentStatement(std::shared_ptr<Expression> name, std::shared_ptr<Expression> value, bool is_compound = false)
+        : name(name), value(value), is_compound(is_compound) {}
     inline NodeType type() override { return NodeType::VariableAssignmentStatement; };
     std::shared_ptr<nlohmann::json> toJSON() override;
 };
@@ -231,11 +261,23 @@ class InfixExpression : public Expression {
     std::shared_ptr<nlohmann::json> toJSON() override;
 };
 
+class PrefixExpression : public Expression {
+  public:
+    std::shared_ptr<Expression> right;
+    token::TokenType op;
+    inline PrefixExpression(token::TokenType op, const std::string& literal, std::shared_ptr<Expression> right = nullptr) : right(right), op(op) {
+        this->meta_data.more_data["operator_literal"] = literal;
+    }
+    inline NodeType type() override { return NodeType::PrefixedExpression; };
+    std::shared_ptr<nlohmann::json> toJSON() override;
+};
+
 class IndexExpression : public Expression {
   public:
     std::shared_ptr<Expression> left;
     std::shared_ptr<Expression> index;
-    inline IndexExpression(std::shared_ptr<Expression> left, std::shared_ptr<Expression> index) : left(left), index(index) {}
+    std::shared_ptr<Expression> end = nullptr; // set for slices `left[index:end]`
+    inline IndexExpression(std::shared_ptr<Expression> left, std::shared_ptr<Expression> index, std::shared_ptr<Expression> end = nullptr) : left(left), index(index), end(end) {}
     inline IndexExpression(std::shared_ptr<Expression> left) : left(left), index(nullptr) {}
     inline NodeType type() override { return NodeType::IndexExpression; };
     std::shared_ptr<nlohmann::json> toJSON() override;
@@ -244,7 +286,8 @@ class IndexExpression : public Expression {
 class IntegerLiteral : public Expression {
   public:
     long long int value;
-    inline IntegerLiteral(long long int value) : value(value) {}
+    bool is_unsigned = false; // above INT64_MAX, `value` holds the bits and the literal only fits u64
+    inline IntegerLiteral(long long int value, bool is_unsigned = false) : value(value), is_unsigned(is_unsigned) {}
     inline NodeType type() override { return NodeType::IntegerLiteral; };
     std::shared_ptr<nlohmann::json> toJSON() override;
 };
@@ -285,8 +328,9 @@ class StructStatement : public Statement {
   public:
     std::shared_ptr<Expression> name = nullptr;
     std::vector<std::shared_ptr<Statement>> fields = {};
-    inline StructStatement(std::shared_ptr<Expression> name, std::vector<std::shared_ptr<Statement>> fields)
-        : name(name), fields(fields) {}
+    std::vector<std::shared_ptr<Expression>> generics = {}; // type parameters, e.g. struct Box[T]
+    inline StructStatement(std::shared_ptr<Expression> name, std::vector<std::shared_ptr<Statement>> fields, std::vector<std::shared_ptr<Expression>> generics = {})
+        : name(name), fields(fields), generics(generics) {}
     inline NodeType type() override { return NodeType::StructStatement; };
     std::shared_ptr<nlohmann::json> toJSON() override;
 };
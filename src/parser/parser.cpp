@@ -1,6 +1,8 @@
 #include "parser.hpp"
 #include "AST/ast.hpp"
+#include "../trace/trace.hpp"
 #include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <memory>
 #include <ostream>
@@ -27,6 +29,7 @@ std::shared_ptr<AST::Program> parser::Parser::parseProgram() {
     int end_line_no = current_token->line_no;
     int end_col_no = current_token->col_no;
     program->set_meta_data(st_line_no, st_col_no, end_line_no, end_col_no);
+    GIGLY_TRACE(Parser, Info, "Parsed " << program->statements.size() << " top level statements with " << this->errors.size() << " errors");
     return program;
 }
 
@@ -37,7 +40,7 @@ std::shared_ptr<AST::Statement> parser::Parser::_parseStatement() {
         auto identifier = std::make_shared<AST::IdentifierLiteral>(this->current_token->literal);
         if(this->_peekTokenIs(token::TokenType::Colon)) {
             return this->_parseVariableDeclaration(identifier, st_line_no, st_col_no);
-        } else if(this->_peekTokenIs(token::TokenType::Equals)) {
+        } else if(this->_peekTokenIs(token::TokenType::Equals) || compound_assignment_operators.contains(peek_token->type)) {
             return this->_parseVariableAssignment(identifier, st_line_no, st_col_no);
         } else if(this->_peekTokenIs(token::TokenType::LeftParen)) {
             auto smt = std::make_shared<AST::ExpressionStatement>(this->_parseFunctionCall(identifier, st_line_no, st_col_no));
@@ -54,10 +57,16 @@ std::shared_ptr<AST::Statement> parser::Parser::_parseStatement() {
         return this->_parseReturnStatement();
     } else if(this->_currentTokenIs(token::TokenType::Def)) {
         return this->_parseFunctionStatement();
+    } else if(this->_currentTokenIs(token::TokenType::At) || this->_currentTokenIs(token::TokenType::Extern)) {
+        return this->_parseAttributedStatement();
     } else if(this->_currentTokenIs(token::TokenType::If)) {
         return this->_parseIfElseStatement();
     } else if(this->_currentTokenIs(token::TokenType::While)) {
         return this->_parseWhileStatement();
+    } else if(this->_currentTokenIs(token::TokenType::For)) {
+        return this->_parseForStatement();
+    } else if(this->_currentTokenIs(token::TokenType::Arena)) {
+        return this->_parseArenaStatement();
     } else if(this->_currentTokenIs(token::TokenType::Break)) {
         return this->_parseBreakStatement();
     } else if(this->_currentTokenIs(token::TokenType::Continue)) {
@@ -74,7 +83,7 @@ std::shared_ptr<AST::Statement> parser::Parser::_parseStatement() {
     }
 }
 
-std::shared_ptr<AST::FunctionStatement> parser::Parser::_parseFunctionStatement() {
+std::shared_ptr<AST::FunctionStatement> parser::Parser::_parseFunctionStatement(bool declaration_only) {
     int st_line_no = current_token->line_no;
     int st_col_no = current_token->col_no;
     if(!this->_expectPeek(token::TokenType::Identifier)) {
@@ -82,6 +91,7 @@ std::shared_ptr<AST::FunctionStatement> parser::Parser::_parseFunctionStatement(
     }
     auto name = std::make_shared<AST::IdentifierLiteral>(this->current_token->literal);
     name->set_meta_data(current_token->line_no, current_token->col_no, current_token->line_no, current_token->end_col_no);
+    auto generics = this->_parseGenericParameters();
     if(!this->_expectPeek(token::TokenType::LeftParen)) {
         return nullptr;
     }
@@ -146,17 +156,119 @@ std::shared_ptr<AST::FunctionStatement> parser::Parser::_parseFunctionStatement(
     }
     this->_nextToken();
     auto return_type = this->_parseType();
-    if(!this->_expectPeek(token::TokenType::LeftBrace)) {
-        return nullptr;
+    std::shared_ptr<AST::BlockStatement> body = nullptr;
+    if(declaration_only) {
+        if(!this->_expectPeek(token::TokenType::Semicolon)) {
+            return nullptr;
+        }
+    } else {
+        if(!this->_expectPeek(token::TokenType::LeftBrace)) {
+            return nullptr;
+        }
+        body = this->_parseBlockStatement();
     }
-    auto body = this->_parseBlockStatement();
     int end_line_no = current_token->line_no;
     int end_col_no = current_token->col_no;
-    auto function_statement = std::make_shared<AST::FunctionStatement>(name, parameters, closure_parameters, return_type, body);
+    auto function_statement = std::make_shared<AST::FunctionStatement>(name, parameters, closure_parameters, return_type, body, generics);
     function_statement->set_meta_data(st_line_no, st_col_no, end_line_no, end_col_no);
     return function_statement;
 }
 
+std::shared_ptr<AST::FunctionStatement> parser::Parser::_parseAttributedStatement() {
+    // `@name` and `@name(args)` apply to the declaration that follows, which may be `extern "C" def ...;`
+    std::vector<std::shared_ptr<AST::CallExpression>> attributes;
+    while(this->_currentTokenIs(token::TokenType::At)) {
+        int st_line_no = current_token->line_no;
+        int st_col_no = current_token->col_no;
+        if(!this->_expectPeek(token::TokenType::Identifier)) {
+            return nullptr;
+        }
+        auto identifier = std::make_shared<AST::IdentifierLiteral>(this->current_token->literal);
+        if(this->_peekTokenIs(token::TokenType::LeftParen)) {
+            attributes.push_back(std::static_pointer_cast<AST::CallExpression>(this->_parseFunctionCall(identifier, st_line_no, st_col_no)));
+        } else {
+            identifier->set_meta_data(current_token->line_no, current_token->col_no, current_token->line_no, current_token->end_col_no);
+            auto attribute = std::make_shared<AST::CallExpression>(identifier);
+            attribute->set_meta_data(st_line_no, st_col_no, current_token->line_no, current_token->end_col_no);
+            attributes.push_back(attribute);
+        }
+        this->_nextToken();
+    }
+    std::string extern_abi = "";
+    if(this->_currentTokenIs(token::TokenType::Extern)) {
+        if(!this->_expectPeek(token::TokenType::String)) {
+            return nullptr;
+        }
+        extern_abi = current_token->literal;
+        if(!this->_expectPeek(token::TokenType::Def)) {
+            return nullptr;
+        }
+    } else if(!this->_currentTokenIs(token::TokenType::Def)) {
+        this->_peekError(current_token->type, token::TokenType::Def);
+        return nullptr;
+    }
+    auto function_statement = this->_parseFunctionStatement(!extern_abi.empty());
+    if(function_statement != nullptr) {
+        function_statement->attributes = attributes;
+        function_statement->extern_abi = extern_abi;
+    }
+    return function_statement;
+}
+
+std::shared_ptr<AST::ForStatement> parser::Parser::_parseForStatement() {
+    int st_line_no = current_token->line_no;
+    int st_col_no = current_token->col_no;
+    // the header may be written as `for x in xs` or `for (x in xs)`
+    bool parenthesized = this->_peekTokenIs(token::TokenType::LeftParen);
+    if(parenthesized) {
+        this->_nextToken();
+    }
+    if(!this->_expectPeek(token::TokenType::Identifier)) {
+        return nullptr;
+    }
+    auto variable = std::make_shared<AST::IdentifierLiteral>(this->current_token->literal);
+    variable->set_meta_data(current_token->line_no, current_token->col_no, current_token->line_no, current_token->end_col_no);
+    if(!this->_expectPeek(token::TokenType::In)) {
+        return nullptr;
+    }
+    this->_nextToken();
+    auto iterable = this->_parseExpression(PrecedenceType::LOWEST);
+    if(parenthesized && !this->_expectPeek(token::TokenType::RightParen)) {
+        return nullptr;
+    }
+    this->_nextToken();
+    auto body = this->_parseStatement();
+    int end_line_no = current_token->line_no;
+    int end_col_no = current_token->col_no;
+    auto for_statement = std::make_shared<AST::ForStatement>(variable, iterable, body);
+    for_statement->set_meta_data(st_line_no, st_col_no, end_line_no, end_col_no);
+    return for_statement;
+}
+
+std::shared_ptr<AST::ArenaStatement> parser::Parser::_parseArenaStatement() {
+    int st_line_no = current_token->line_no;
+    int st_col_no = current_token->col_no;
+    // `arena { ... }` or `arena (chunk_size) { ... }`
+    std::shared_ptr<AST::Expression> chunk_size = nullptr;
+    if(this->_peekTokenIs(token::TokenType::LeftParen)) {
+        this->_nextToken();
+        this->_nextToken();
+        chunk_size = this->_parseExpression(PrecedenceType::LOWEST);
+        if(!this->_expectPeek(token::TokenType::RightParen)) {
+            return nullptr;
+        }
+    }
+    if(!this->_expectPeek(token::TokenType::LeftBrace)) {
+        return nullptr;
+    }
+    auto body = this->_parseStatement();
+    int end_line_no = current_token->line_no;
+    int end_col_no = current_token->col_no;
+    auto arena_statement = std::make_shared<AST::ArenaStatement>(chunk_size, body);
+    arena_statement->set_meta_data(st_line_no, st_col_no, end_line_no, end_col_no);
+    return arena_statement;
+}
+
 std::shared_ptr<AST::WhileStatement> parser::Parser::_parseWhileStatement() {
     int st_line_no = current_token->line_no;
     int st_col_no = current_token->col_no;
@@ -180,12 +292,12 @@ std::shared_ptr<AST::WhileStatement> parser::Parser::_parseWhileStatement() {
 std::shared_ptr<AST::BreakStatement> parser::Parser::_parseBreakStatement() {
     int st_line_no = current_token->line_no;
     int st_col_no = current_token->col_no;
-    this->_nextToken();
     int loopNum = 0;
-    if (this->_currentTokenIs(token::TokenType::Integer)){
+    if (this->_peekTokenIs(token::TokenType::Integer)) {
+        this->_nextToken();
         loopNum = std::stoi(current_token->literal);
-        this->_nextToken();}
-    if (this->_currentTokenIs(token::TokenType::Semicolon))
+    }
+    if (this->_peekTokenIs(token::TokenType::Semicolon))
         this->_nextToken();
     int end_line_no = current_token->line_no;
     int end_col_no = current_token->col_no;
@@ -197,13 +309,12 @@ std::shared_ptr<AST::BreakStatement> parser::Parser::_parseBreakStatement() {
 std::shared_ptr<AST::ContinueStatement> parser::Parser::_parseContinueStatement() {
     int st_line_no = current_token->line_no;
     int st_col_no = current_token->col_no;
-    this->_nextToken();
     int loopNum = 0;
-    if (this->_currentTokenIs(token::TokenType::Integer)){
-        loopNum = std::stoi(current_token->literal);
+    if (this->_peekTokenIs(token::TokenType::Integer)) {
         this->_nextToken();
+        loopNum = std::stoi(current_token->literal);
     }
-    if (this->_currentTokenIs(token::TokenType::Semicolon))
+    if (this->_peekTokenIs(token::TokenType::Semicolon))
         this->_nextToken();
     int end_line_no = current_token->line_no;
     int end_col_no = current_token->col_no;
@@ -299,13 +410,17 @@ std::shared_ptr<AST::BlockStatement> parser::Parser::_parseBlockStatement() {
     return block_statement;
 }
 
-std::shared_ptr<AST::ExpressionStatement> parser::Parser::_parseExpressionStatement(std::shared_ptr<AST::Expression> identifier, int st_line_no, int st_col_no) {
+std::shared_ptr<AST::Statement> parser::Parser::_parseExpressionStatement(std::shared_ptr<AST::Expression> identifier, int st_line_no, int st_col_no) {
     if (identifier == nullptr) {
         st_line_no = current_token->line_no;
         st_col_no = current_token->col_no;
         identifier = std::make_shared<AST::IdentifierLiteral>(this->current_token->literal);
     }
     auto expr = this->_parseExpression(PrecedenceType::LOWEST, identifier, st_line_no, st_col_no);
+    if(this->_peekTokenIs(token::TokenType::Equals) || compound_assignment_operators.contains(peek_token->type)) {
+        // `a[i] = e`, `s.field += e`, `s.field++`
+        return this->_parseVariableAssignment(expr, st_line_no, st_col_no);
+    }
     if(this->_peekTokenIs(token::TokenType::Semicolon)) {
         this->_nextToken();
     }
@@ -378,19 +493,58 @@ std::shared_ptr<AST::GenericType> parser::Parser::_parseType() {
     return generic_type_node;
 }
 
+std::vector<std::shared_ptr<AST::Expression>> parser::Parser::_parseGenericParameters() {
+    std::vector<std::shared_ptr<AST::Expression>> generics;
+    if(!this->_peekTokenIs(token::TokenType::LeftBracket)) {
+        return generics;
+    }
+    this->_nextToken();
+    while(!this->_peekTokenIs(token::TokenType::RightBracket)) {
+        if(!this->_expectPeek(token::TokenType::Identifier)) {
+            return generics;
+        }
+        auto generic = std::make_shared<AST::IdentifierLiteral>(this->current_token->literal);
+        generic->set_meta_data(current_token->line_no, current_token->col_no, current_token->line_no, current_token->end_col_no);
+        generics.push_back(generic);
+        if(this->_peekTokenIs(token::TokenType::Comma)) {
+            this->_nextToken();
+        }
+    }
+    this->_nextToken();
+    return generics;
+}
+
 std::shared_ptr<AST::Statement> parser::Parser::_parseVariableAssignment(std::shared_ptr<AST::Expression> identifier, int st_line_no, int st_col_no) {
     if (identifier == nullptr) {
         st_line_no = current_token->line_no;
         st_col_no = current_token->col_no;
         identifier = std::make_shared<AST::IdentifierLiteral>(this->current_token->literal);
     }
-    if(!this->_expectPeek(token::TokenType::Equals)) {
-        return nullptr;
+    std::shared_ptr<AST::Expression> expr = nullptr;
+    bool is_compound = compound_assignment_operators.contains(peek_token->type);
+    if(is_compound) {
+        // kept as `x = x op e`, the compiler computes the address of x only once
+        this->_nextToken();
+        auto op_token = current_token;
+        std::shared_ptr<AST::Expression> right = nullptr;
+        if(op_token->type == token::TokenType::Increment || op_token->type == token::TokenType::Decrement) {
+            right = std::make_shared<AST::IntegerLiteral>(1);
+            right->set_meta_data(op_token->line_no, op_token->col_no, op_token->line_no, op_token->end_col_no);
+        } else {
+            this->_nextToken();
+            right = this->_parseExpression(PrecedenceType::LOWEST);
+        }
+        expr = std::make_shared<AST::InfixExpression>(identifier, compound_assignment_operators.at(op_token->type), op_token->literal.substr(0, 1), right);
+        expr->set_meta_data(st_line_no, st_col_no, current_token->line_no, current_token->end_col_no);
+    } else {
+        if(!this->_expectPeek(token::TokenType::Equals)) {
+            return nullptr;
+        }
+        this->_nextToken();
+        expr = this->_parseExpression(PrecedenceType::LOWEST);
     }
     this->_nextToken();
-    auto expr = this->_parseExpression(PrecedenceType::LOWEST);
-    this->_nextToken();
-    auto stmt = std::make_shared<AST::VariableAssignmentStatement>(identifier, expr);
+    auto stmt = std::make_shared<AST::VariableAssignmentStatement>(identifier, expr, is_compound);
     int end_line_no = current_token->line_no;
     int end_col_no = current_token->col_no;
     stmt->set_meta_data(st_line_no, st_col_no, end_line_no, end_col_no);
@@ -405,6 +559,7 @@ std::shared_ptr<AST::StructStatement> parser::Parser::_parseStructStatement() {
         return nullptr;
     }
     std::shared_ptr<AST::Expression> name = std::make_shared<AST::IdentifierLiteral>(this->current_token->literal);
+    auto generics = this->_parseGenericParameters();
 
     if(!this->_expectPeek(token::TokenType::LeftBrace)) {
         return nullptr;
@@ -413,8 +568,8 @@ std::shared_ptr<AST::StructStatement> parser::Parser::_parseStructStatement() {
     std::vector<std::shared_ptr<AST::Statement>> statements;
 
     while(!this->_currentTokenIs(token::TokenType::RightBrace) && !this->_currentTokenIs(token::TokenType::EndOfFile)) {
-        if (this->_currentTokenIs(token::TokenType::Def)) {
-            auto stmt = this->_parseFunctionStatement();
+        if (this->_currentTokenIs(token::TokenType::Def) || this->_currentTokenIs(token::TokenType::At)) {
+            std::shared_ptr<AST::FunctionStatement> stmt = this->_currentTokenIs(token::TokenType::At) ? this->_parseAttributedStatement() : this->_parseFunctionStatement();
             if(stmt != nullptr) {
                 statements.push_back(stmt);
             } else {
@@ -432,7 +587,7 @@ std::shared_ptr<AST::StructStatement> parser::Parser::_parseStructStatement() {
     int end_line_no = current_token->line_no;
     int end_col_no = current_token->col_no;
 
-    auto struct_stmt = std::make_shared<AST::StructStatement>(name, statements);
+    auto struct_stmt = std::make_shared<AST::StructStatement>(name, statements, generics);
     struct_stmt->set_meta_data(st_line_no, st_col_no, end_line_no, end_col_no);
     return struct_stmt;
 }
@@ -498,6 +653,10 @@ std::shared_ptr<AST::Expression> parser::Parser::_parseInfixExpression(std::shar
     infix_expr->meta_data.more_data["operator_st_col_no"] = this->current_token->col_no;
     infix_expr->meta_data.more_data["operator_end_col_no"] = this->current_token->end_col_no;
     auto precedence = this->_currentPrecedence();
+    if (infix_expr->op == token::TokenType::AsteriskAsterisk) {
+        // `**` is right associative, 2 ** 3 ** 2 is 2 ** 9
+        precedence = PrecedenceType::PRODUCT;
+    }
     this->_nextToken();
     infix_expr->right = this->_parseExpression(precedence);
     int end_line_no = infix_expr->right->meta_data.end_line_no;
@@ -506,6 +665,20 @@ std::shared_ptr<AST::Expression> parser::Parser::_parseInfixExpression(std::shar
     return infix_expr;
 }
 
+std::shared_ptr<AST::Expression> parser::Parser::_parsePrefixExpression() {
+    int st_line_no = this->current_token->line_no;
+    int st_col_no = this->current_token->col_no;
+    auto prefix_expr = std::make_shared<AST::PrefixExpression>(this->current_token->type, this->current_token->literal);
+    this->_nextToken();
+    // `not` binds looser than comparisons and tighter than `and`, not a == b is not (a == b)
+    prefix_expr->right = this->_parseExpression(PrecedenceType::LOGICAL_NOT);
+    if (prefix_expr->right == nullptr) {
+        return nullptr;
+    }
+    prefix_expr->set_meta_data(st_line_no, st_col_no, prefix_expr->right->meta_data.end_line_no, prefix_expr->right->meta_data.end_col_no);
+    return prefix_expr;
+}
+
 std::shared_ptr<AST::Expression> parser::Parser::_parseIndexExpression(std::shared_ptr<AST::Expression> leftNode) {
     int st_line_no = leftNode->meta_data.st_line_no;
     int st_col_no = leftNode->meta_data.st_col_no;
@@ -514,9 +687,16 @@ std::shared_ptr<AST::Expression> parser::Parser::_parseIndexExpression(std::shar
     index_expr->meta_data.more_data["index_st_col_no"] = this->current_token->col_no;
     index_expr->meta_data.more_data["index_end_col_no"] = this->current_token->end_col_no;
     this->_nextToken();
-    index_expr->index = this->_parseExpression(PrecedenceType::INDEX);
-    int end_line_no = index_expr->index->meta_data.end_line_no;
-    int end_col_no = index_expr->index->meta_data.end_col_no;
+    // `:` and `]` end both bounds, so they take full expressions like `a[i + 1]` and `a[0:len(a) - 1]`
+    index_expr->index = this->_parseExpression(PrecedenceType::LOWEST);
+    if(this->_peekTokenIs(token::TokenType::Colon)) {
+        this->_nextToken();
+        this->_nextToken();
+        index_expr->end = this->_parseExpression(PrecedenceType::LOWEST);
+    }
+    auto last = index_expr->end ? index_expr->end : index_expr->index;
+    int end_line_no = last->meta_data.end_line_no;
+    int end_col_no = last->meta_data.end_col_no;
     index_expr->set_meta_data(st_line_no, st_col_no, end_line_no, end_col_no);
     if(!this->_expectPeek(token::TokenType::RightBracket)) {
         return nullptr;
@@ -540,7 +720,24 @@ std::shared_ptr<AST::Expression> parser::Parser::_parseGroupedExpression() {
 
 
 std::shared_ptr<AST::Expression> parser::Parser::_parseIntegerLiteral() {
-    auto expr = std::make_shared<AST::IntegerLiteral>(std::stoll(current_token->literal));
+    // positive literals are parsed unsigned so every u64 can be written, negative ones signed. A literal that does not
+    // fit in 64 bits is an error rather than an exception
+    bool negative = current_token->literal.starts_with("-");
+    long long int value = 0;
+    bool is_unsigned = false;
+    try {
+        if (negative) {
+            value = std::stoll(current_token->literal);
+        } else {
+            auto magnitude = std::stoull(current_token->literal);
+            value = static_cast<long long int>(magnitude);
+            is_unsigned = magnitude > static_cast<unsigned long long>(INT64_MAX);
+        }
+    } catch (const std::out_of_range&) {
+        this->errors.push_back(std::make_shared<errors::CompletionError>("Literal out of range", this->lexer->source, current_token->line_no, current_token->line_no,
+                                                                         current_token->literal + " does not fit in 64 bits"));
+    }
+    auto expr = std::make_shared<AST::IntegerLiteral>(value, is_unsigned);
     expr->meta_data.st_line_no = current_token->line_no;
     expr->meta_data.st_col_no = current_token->col_no;
     expr->meta_data.end_line_no = current_token->line_no;
@@ -13,6 +13,9 @@ namespace parser {
 enum class PrecedenceType {
     LOWEST,
     ASSIGN,        // =, +=, -=, *=, /=, %=
+    LOGICAL_OR,    // or
+    LOGICAL_AND,   // and
+    LOGICAL_NOT,   // not X
     COMPARISION,   // >, <, >=, <=, ==, !=
     SUM,           // +
     PRODUCT,       // *
@@ -24,6 +27,18 @@ enum class PrecedenceType {
     POSTFIX        // X++
 };
 
+// `x op= e` and `x++` assign `x op e` and `x op 1`
+static const std::unordered_map<token::TokenType, token::TokenType> compound_assignment_operators = {
+    {token::TokenType::PlusEqual, token::TokenType::Plus},
+    {token::TokenType::DashEqual, token::TokenType::Dash},
+    {token::TokenType::AsteriskEqual, token::TokenType::Asterisk},
+    {token::TokenType::ForwardSlashEqual, token::TokenType::ForwardSlash},
+    {token::TokenType::PercentEqual, token::TokenType::Percent},
+    {token::TokenType::CaretEqual, token::TokenType::BitwiseXor},
+    {token::TokenType::Increment, token::TokenType::Plus},
+    {token::TokenType::Decrement, token::TokenType::Dash},
+};
+
 static const std::unordered_map<token::TokenType, PrecedenceType> token_precedence = {
     {token::TokenType::Illegal, PrecedenceType::LOWEST},
     {token::TokenType::GreaterThan, PrecedenceType::COMPARISION},
@@ -39,8 +54,8 @@ static const std::unordered_map<token::TokenType, PrecedenceType> token_preceden
     {token::TokenType::BitwiseNot, PrecedenceType::PREFIX},
     {token::TokenType::LeftShift, PrecedenceType::COMPARISION},
     {token::TokenType::RightShift, PrecedenceType::COMPARISION},
-    {token::TokenType::Or, PrecedenceType::COMPARISION},
-    {token::TokenType::And, PrecedenceType::COMPARISION},
+    {token::TokenType::Or, PrecedenceType::LOGICAL_OR},
+    {token::TokenType::And, PrecedenceType::LOGICAL_AND},
     {token::TokenType::NotEquals, PrecedenceType::COMPARISION},
     {token::TokenType::PlusEqual, PrecedenceType::ASSIGN},
     {token::TokenType::DashEqual, PrecedenceType::ASSIGN},
@@ -80,6 +95,7 @@ class Parser {
         {token::TokenType::Identifier, std::bind(&Parser::_parseIdentifier, this)},
         {token::TokenType::LeftParen, std::bind(&Parser::_parseGroupedExpression, this)},
         {token::TokenType::LeftBracket, std::bind(&Parser::_parseArrayLiteral, this)},
+        {token::TokenType::Not, std::bind(&Parser::_parsePrefixExpression, this)},
     };
     std::unordered_map<token::TokenType, std::function<std::shared_ptr<AST::Expression>(std::shared_ptr<AST::Expression>)>> infix_parse_Fns = {
         {token::TokenType::Or, std::bind(&Parser::_parseInfixExpression, this, std::placeholders::_1)},
@@ -96,6 +112,11 @@ class Parser {
         {token::TokenType::LessThanOrEqual, std::bind(&Parser::_parseInfixExpression, this, std::placeholders::_1)},
         {token::TokenType::EqualEqual, std::bind(&Parser::_parseInfixExpression, this, std::placeholders::_1)},
         {token::TokenType::NotEquals, std::bind(&Parser::_parseInfixExpression, this, std::placeholders::_1)},
+        {token::TokenType::BitwiseAnd, std::bind(&Parser::_parseInfixExpression, this, std::placeholders::_1)},
+        {token::TokenType::BitwiseOr, std::bind(&Parser::_parseInfixExpression, this, std::placeholders::_1)},
+        {token::TokenType::BitwiseXor, std::bind(&Parser::_parseInfixExpression, this, std::placeholders::_1)},
+        {token::TokenType::LeftShift, std::bind(&Parser::_parseInfixExpression, this, std::placeholders::_1)},
+        {token::TokenType::RightShift, std::bind(&Parser::_parseInfixExpression, this, std::placeholders::_1)},
         {token::TokenType::Dot, std::bind(&Parser::_parseInfixExpression, this, std::placeholders::_1)},
         {token::TokenType::LeftBracket, std::bind(&Parser::_parseIndexExpression, this, std::placeholders::_1)},
     };
@@ -113,21 +134,25 @@ class Parser {
     PrecedenceType _peekPrecedence();
     std::shared_ptr<AST::Statement> _parseStatement();
 
-    std::shared_ptr<AST::ExpressionStatement> _parseExpressionStatement(std::shared_ptr<AST::Expression> identifier = nullptr, int st_line_no = -1, int st_col_no = -1);
+    std::shared_ptr<AST::Statement> _parseExpressionStatement(std::shared_ptr<AST::Expression> identifier = nullptr, int st_line_no = -1, int st_col_no = -1);
     std::shared_ptr<AST::Statement> _parseVariableDeclaration(std::shared_ptr<AST::Expression> identifier = nullptr, int st_line_no = -1, int st_col_no = -1, bool is_volatile = false);
     std::shared_ptr<AST::Statement> _parseVariableAssignment(std::shared_ptr<AST::Expression> identifier = nullptr, int st_line_no = -1, int st_col_no = -1);
     std::shared_ptr<AST::ReturnStatement> _parseReturnStatement();
-    std::shared_ptr<AST::FunctionStatement> _parseFunctionStatement();
+    std::shared_ptr<AST::FunctionStatement> _parseFunctionStatement(bool declaration_only = false);
+    std::shared_ptr<AST::FunctionStatement> _parseAttributedStatement();
     std::shared_ptr<AST::Expression> _parseFunctionCall(std::shared_ptr<AST::Expression> identifier = nullptr, int st_line_no = -1, int st_col_no = -1);
     std::shared_ptr<AST::BlockStatement> _parseBlockStatement();
     std::shared_ptr<AST::Statement> _parseIfElseStatement();
     std::shared_ptr<AST::WhileStatement> _parseWhileStatement();
+    std::shared_ptr<AST::ForStatement> _parseForStatement();
+    std::shared_ptr<AST::ArenaStatement> _parseArenaStatement();
     std::shared_ptr<AST::BreakStatement> _parseBreakStatement();
     std::shared_ptr<AST::ContinueStatement> _parseContinueStatement();
     std::shared_ptr<AST::ImportStatement> _parseImportStatement();
     std::shared_ptr<AST::StructStatement> _parseStructStatement();
 
     std::shared_ptr<AST::GenericType> _parseType();
+    std::vector<std::shared_ptr<AST::Expression>> _parseGenericParameters();
 
     std::shared_ptr<AST::Expression> _parseExpression(PrecedenceType precedence, std::shared_ptr<AST::Expression> leftNode = nullptr, int st_line_no = -1, int st_col_no = -1);
 
@@ -136,6 +161,7 @@ class Parser {
     std::shared_ptr<AST::Expression> _parseBooleanLiteral();
     std::shared_ptr<AST::Expression> _parseStringLiteral();
     std::shared_ptr<AST::Expression> _parseGroupedExpression();
+    std::shared_ptr<AST::Expression> _parsePrefixExpression();
     std::shared_ptr<AST::Expression> _parseIdentifier();
     std::shared_ptr<AST::Expression> _parseArrayLiteral();
 
@@ -0,0 +1,147 @@
+#include "gigly_runtime.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define GIGLY_ALIGN 16
+#define GIGLY_ARENA_DEFAULT_CHUNK (64 * 1024)
+#define GIGLY_POOL_CLASSES 8 // 16, 32, ..., 128 bytes
+#define GIGLY_POOL_SLAB (64 * 1024)
+
+typedef struct gigly_arena_chunk {
+    struct gigly_arena_chunk* next;
+    size_t size;
+    _Alignas(GIGLY_ALIGN) char data[];
+} gigly_arena_chunk;
+
+struct gigly_arena {
+    char* ptr;
+    char* end;
+    gigly_arena_chunk* chunks;
+    int64_t chunk_size;
+    gigly_arena* prev; // enclosing arena, restored on exit
+};
+
+static _Thread_local gigly_arena* gigly_current_arena = NULL;
+
+static void* gigly_checked_malloc(size_t size) {
+    void* memory = malloc(size);
+    if (memory == NULL) {
+        fprintf(stderr, "Out of memory while allocating %zu bytes\n", size);
+        exit(1);
+    }
+    return memory;
+}
+
+static size_t gigly_align(int64_t size) {
+    return ((size_t)size + GIGLY_ALIGN - 1) & ~(size_t)(GIGLY_ALIGN - 1);
+}
+
+gigly_arena* gigly_arena_enter(int64_t chunk_size) {
+    gigly_arena* arena = gigly_checked_malloc(sizeof(gigly_arena));
+    arena->ptr = NULL;
+    arena->end = NULL;
+    arena->chunks = NULL;
+    arena->chunk_size = chunk_size > 0 ? chunk_size : GIGLY_ARENA_DEFAULT_CHUNK;
+    arena->prev = gigly_current_arena;
+    gigly_current_arena = arena;
+    return arena;
+}
+
+// Frees the whole region at once, no per-object bookkeeping is ever done
+void gigly_arena_exit(gigly_arena* arena) {
+    gigly_current_arena = arena->prev;
+    gigly_arena_chunk* chunk = arena->chunks;
+    while (chunk != NULL) {
+        gigly_arena_chunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    free(arena);
+}
+
+gigly_arena* gigly_arena_current(void) {
+    return gigly_current_arena;
+}
+
+static int gigly_arena_owns(const gigly_arena* arena, const void* ptr) {
+    for (const gigly_arena_chunk* chunk = arena->chunks; chunk != NULL; chunk = chunk->next) {
+        if ((const char*)ptr >= chunk->data && (const char*)ptr < chunk->data + chunk->size) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Appends in a function that opened no arena itself can still move a value out of the caller's arena, the compiler
+// cannot see that statically. Every arena opened after the one holding the array closes first.
+void gigly_arena_check_escape(const gigly_array* array, const void* element, const gigly_gc_desc* elem_desc) {
+    for (const gigly_arena* arena = gigly_current_arena; arena != NULL && arena != array->arena; arena = arena->prev) {
+        for (int64_t i = 0; i < elem_desc->count + elem_desc->strings; ++i) {
+            const char* field = (const char*)element + elem_desc->offsets[i];
+            const void* ptr = NULL;
+            if (i < elem_desc->count) {
+                ptr = *(void* const*)field;
+            } else if (((const gigly_str*)field)->len >= 0) {
+                ptr = ((const gigly_str*)field)->data; // inline strings hold no pointer
+            }
+            if (ptr != NULL && gigly_arena_owns(arena, ptr)) {
+                gigly_io_flush(); // keep the program's output ahead of the error
+                fprintf(stderr, "Value appended to an array outlives the arena block it was allocated in\n");
+                exit(1);
+            }
+        }
+    }
+}
+
+void* gigly_arena_alloc(gigly_arena* arena, int64_t size) {
+    size_t aligned = gigly_align(size);
+    if (arena->ptr == NULL || (size_t)(arena->end - arena->ptr) < aligned) {
+        // objects larger than a chunk get a chunk of their own
+        size_t chunk_size = aligned > (size_t)arena->chunk_size ? aligned : (size_t)arena->chunk_size;
+        gigly_arena_chunk* chunk = gigly_checked_malloc(sizeof(gigly_arena_chunk) + chunk_size);
+        chunk->next = arena->chunks;
+        chunk->size = chunk_size;
+        arena->chunks = chunk;
+        arena->ptr = chunk->data;
+        arena->end = chunk->data + chunk_size;
+    }
+    void* memory = arena->ptr;
+    arena->ptr += aligned;
+    return memory;
+}
+
+// Each size class keeps an intrusive free list and carves new objects out of slabs
+static _Thread_local void* gigly_pool_free_lists[GIGLY_POOL_CLASSES] = {0};
+static _Thread_local char* gigly_pool_ptr = NULL;
+static _Thread_local char* gigly_pool_end = NULL;
+
+void* gigly_pool_alloc(int64_t size) {
+    size_t aligned = gigly_align(size);
+    size_t size_class = aligned / GIGLY_ALIGN - 1;
+    if (size <= 0 || size_class >= GIGLY_POOL_CLASSES) {
+        return gigly_checked_malloc(aligned);
+    }
+    void* memory = gigly_pool_free_lists[size_class];
+    if (memory != NULL) {
+        gigly_pool_free_lists[size_class] = *(void**)memory;
+        return memory;
+    }
+    if (gigly_pool_ptr == NULL || (size_t)(gigly_pool_end - gigly_pool_ptr) < aligned) {
+        gigly_pool_ptr = gigly_checked_malloc(GIGLY_POOL_SLAB);
+        gigly_pool_end = gigly_pool_ptr + GIGLY_POOL_SLAB;
+    }
+    memory = gigly_pool_ptr;
+    gigly_pool_ptr += aligned;
+    return memory;
+}
+
+void gigly_pool_free(void* ptr, int64_t size) {
+    size_t size_class = gigly_align(size) / GIGLY_ALIGN - 1;
+    if (size <= 0 || size_class >= GIGLY_POOL_CLASSES) {
+        free(ptr);
+        return;
+    }
+    *(void**)ptr = gigly_pool_free_lists[size_class];
+    gigly_pool_free_lists[size_class] = ptr;
+}
@@ -0,0 +1,89 @@
+#include "gigly_runtime.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GIGLY_ARRAY_MIN_CAP 4
+
+static void* gigly_array_alloc(void* data, int64_t size) {
+    void* memory = realloc(data, (size_t)size);
+    if (memory == NULL && size != 0) {
+        fprintf(stderr, "Out of memory while allocating %lld bytes for an array\n", (long long)size);
+        exit(1);
+    }
+    return memory;
+}
+
+gigly_array* gigly_array_new(int64_t elem_size, int64_t cap, const gigly_gc_desc* elem_desc) {
+    // an array lives where it was created, inside an arena block both header and elements come from the arena,
+    // on the heap the header is a collected object that owns its element buffer
+    gigly_array* array = gigly_gc_alloc(sizeof(gigly_array), GIGLY_GC_ARRAY, elem_desc);
+    array->arena = gigly_arena_current();
+    array->len = 0;
+    array->cap = cap;
+    array->data = NULL;
+    if (cap > 0 && array->arena != NULL) {
+        array->data = gigly_arena_alloc(array->arena, elem_size * cap);
+    } else if (cap > 0) {
+        array->data = gigly_array_alloc(NULL, elem_size * cap);
+        gigly_gc_account(array, elem_size * cap);
+    }
+    return array;
+}
+
+// Slow path of append, the inline fast path only calls this when len == cap.
+// Capacity doubles so a run of appends costs amortized O(1) per element.
+void gigly_array_grow(gigly_array* array, int64_t elem_size, int64_t min_cap, const gigly_gc_desc* elem_desc) {
+    // `[]` does not know its element type, the first append tells the collector how to trace the elements
+    gigly_gc_header_of(array)->desc = elem_desc;
+    int64_t cap = array->cap * 2;
+    if (cap < GIGLY_ARRAY_MIN_CAP) {
+        cap = GIGLY_ARRAY_MIN_CAP;
+    }
+    if (cap < min_cap) {
+        cap = min_cap;
+    }
+    if (array->arena != NULL) {
+        // arena memory cannot be resized, the old block is reclaimed with the arena
+        void* data = gigly_arena_alloc(array->arena, elem_size * cap);
+        if (array->len > 0) {
+            memcpy(data, array->data, (size_t)(array->len * elem_size));
+        }
+        array->data = data;
+    } else {
+        array->data = gigly_array_alloc(array->data, elem_size * cap);
+        gigly_gc_account(array, (cap - array->cap) * elem_size);
+    }
+    array->cap = cap;
+}
+
+// Copies array[start:end] into a new array, bounds are clamped to the source like Python slices
+gigly_array* gigly_array_slice(gigly_array* array, int64_t elem_size, int64_t start, int64_t end) {
+    if (start < 0) {
+        start = 0;
+    }
+    if (end > array->len) {
+        end = array->len;
+    }
+    int64_t len = end > start ? end - start : 0;
+    gigly_array* slice = gigly_array_new(elem_size, len, gigly_gc_header_of(array)->desc);
+    if (len > 0) {
+        memcpy(slice->data, (char*)array->data + start * elem_size, (size_t)(len * elem_size));
+    }
+    slice->len = len;
+    return slice;
+}
+
+// Target of every failed bounds check, kept out of line so the checks stay a compare and a branch
+_Noreturn void gigly_bounds_fail(int64_t index, int64_t len) {
+    gigly_io_flush(); // keep the program's output ahead of the error
+    fprintf(stderr, "Index %lld out of bounds for array of length %lld\n", (long long)index, (long long)len);
+    exit(1);
+}
+
+// Target of the check on a `range` step that is only known at runtime, a zero step would loop forever
+_Noreturn void gigly_range_step_fail(void) {
+    gigly_io_flush();
+    fprintf(stderr, "range step cannot be zero\n");
+    exit(1);
+}
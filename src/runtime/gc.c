@@ -0,0 +1,306 @@
+#include "gigly_runtime.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Precise non-moving mark-sweep collector.
+//
+// Roots come from LLVM's shadow-stack GC strategy: every function with roots links a frame
+// into llvm_gc_root_chain on entry. A root slot without metadata holds a heap pointer, a slot
+// with metadata holds the address of a stack value described by that gigly_gc_desc.
+//
+// Strings may point into the middle of their buffer after slicing, so string buffers are found
+// by address in a sorted index rebuilt at the start of every collection.
+//
+// Tuning, read once on the first allocation:
+//   GIGLY_GC_HEAP    bytes allocated before the first collection (k/m/g suffixes), default 8m
+//   GIGLY_GC_GROWTH  the next collection runs once the heap reaches live * growth, default 2.0
+//   GIGLY_GC_STATS   1 prints a summary at exit, 2 also prints every collection
+
+#define GIGLY_GC_HEADER_BYTES ((int64_t)sizeof(gigly_gc_header))
+
+typedef struct gigly_frame_map {
+    int32_t num_roots;
+    int32_t num_meta;
+    const void* meta[];
+} gigly_frame_map;
+
+typedef struct gigly_stack_entry {
+    struct gigly_stack_entry* next;
+    const gigly_frame_map* map;
+    void* roots[];
+} gigly_stack_entry;
+
+// Defined here so programs without any root still link, the compiled modules only emit a weak copy
+gigly_stack_entry* llvm_gc_root_chain = NULL;
+
+static struct {
+    int initialized;
+    gigly_gc_header* objects; // every heap object, newest first
+    uint32_t epoch;           // objects whose mark equals the epoch are reachable in the current cycle
+    gigly_gc_header** mark_stack;
+    size_t mark_top;
+    size_t mark_cap;
+    gigly_gc_header** strings; // string buffers sorted by address, valid during a collection
+    size_t string_count;
+    size_t string_cap;
+    int64_t allocated;        // bytes allocated since the last collection
+    int64_t live;             // bytes that survived the last collection
+    int64_t threshold;
+    int64_t initial_heap;
+    double growth;
+    int stats;
+    // statistics
+    int64_t collections;
+    int64_t total_allocated;
+    int64_t total_freed;
+    double total_pause;
+    double max_pause;
+    double start_time;
+} gigly_gc;
+
+static double gigly_gc_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+static int64_t gigly_gc_env_bytes(const char* name, int64_t fallback) {
+    const char* value = getenv(name);
+    if (value == NULL || *value == '\0') {
+        return fallback;
+    }
+    char* end = NULL;
+    int64_t bytes = strtoll(value, &end, 10);
+    switch (*end) {
+    case 'k': case 'K': bytes <<= 10; break;
+    case 'm': case 'M': bytes <<= 20; break;
+    case 'g': case 'G': bytes <<= 30; break;
+    default: break;
+    }
+    return bytes > 0 ? bytes : fallback;
+}
+
+static void gigly_gc_report(void) {
+    double elapsed = gigly_gc_now() - gigly_gc.start_time;
+    double mutator = elapsed - gigly_gc.total_pause;
+    fprintf(stderr, "[gc] %lld collections, pause total %.3f ms, max %.3f ms, avg %.3f ms\n", (long long)gigly_gc.collections, gigly_gc.total_pause * 1e3,
+            gigly_gc.max_pause * 1e3, gigly_gc.collections > 0 ? gigly_gc.total_pause * 1e3 / (double)gigly_gc.collections : 0.0);
+    fprintf(stderr, "[gc] allocated %lld bytes, freed %lld bytes, live %lld bytes, throughput %.1f MB/s\n", (long long)gigly_gc.total_allocated,
+            (long long)gigly_gc.total_freed, (long long)(gigly_gc.live + gigly_gc.allocated),
+            mutator > 0 ? (double)gigly_gc.total_allocated / mutator / (1024.0 * 1024.0) : 0.0);
+}
+
+static void gigly_gc_init(void) {
+    gigly_gc.initialized = 1;
+    gigly_gc.epoch = 1;
+    gigly_gc.initial_heap = gigly_gc_env_bytes("GIGLY_GC_HEAP", 8 << 20);
+    gigly_gc.threshold = gigly_gc.initial_heap;
+    const char* growth = getenv("GIGLY_GC_GROWTH");
+    gigly_gc.growth = growth != NULL ? atof(growth) : 2.0;
+    if (gigly_gc.growth < 1.0) {
+        gigly_gc.growth = 2.0;
+    }
+    const char* stats = getenv("GIGLY_GC_STATS");
+    gigly_gc.stats = stats != NULL ? atoi(stats) : 0;
+    gigly_gc.start_time = gigly_gc_now();
+    if (gigly_gc.stats > 0) {
+        atexit(gigly_gc_report);
+    }
+}
+
+static void gigly_gc_mark(void* object) {
+    if (object == NULL) {
+        return;
+    }
+    gigly_gc_header* header = gigly_gc_header_of(object);
+    if (header->mark == gigly_gc.epoch) {
+        return;
+    }
+    header->mark = gigly_gc.epoch;
+    if (gigly_gc.mark_top == gigly_gc.mark_cap) {
+        gigly_gc.mark_cap = gigly_gc.mark_cap ? gigly_gc.mark_cap * 2 : 256;
+        gigly_gc.mark_stack = realloc(gigly_gc.mark_stack, gigly_gc.mark_cap * sizeof(gigly_gc_header*));
+        if (gigly_gc.mark_stack == NULL) {
+            fprintf(stderr, "Out of memory while growing the mark stack\n");
+            exit(1);
+        }
+    }
+    gigly_gc.mark_stack[gigly_gc.mark_top++] = header;
+}
+
+static int gigly_gc_compare_address(const void* left, const void* right) {
+    uintptr_t a = (uintptr_t)*(gigly_gc_header* const*)left;
+    uintptr_t b = (uintptr_t)*(gigly_gc_header* const*)right;
+    return a < b ? -1 : a > b;
+}
+
+static void gigly_gc_index_strings(void) {
+    gigly_gc.string_count = 0;
+    for (gigly_gc_header* header = gigly_gc.objects; header != NULL; header = header->next) {
+        if (header->kind != GIGLY_GC_STRING) {
+            continue;
+        }
+        if (gigly_gc.string_count == gigly_gc.string_cap) {
+            gigly_gc.string_cap = gigly_gc.string_cap ? gigly_gc.string_cap * 2 : 256;
+            gigly_gc.strings = realloc(gigly_gc.strings, gigly_gc.string_cap * sizeof(gigly_gc_header*));
+            if (gigly_gc.strings == NULL) {
+                fprintf(stderr, "Out of memory while indexing strings\n");
+                exit(1);
+            }
+        }
+        gigly_gc.strings[gigly_gc.string_count++] = header;
+    }
+    qsort(gigly_gc.strings, gigly_gc.string_count, sizeof(gigly_gc_header*), gigly_gc_compare_address);
+}
+
+static void gigly_gc_mark_string(const gigly_str* str) {
+    // inline and empty strings own nothing, literals and arena strings are not in the index
+    if (str->len <= 0) {
+        return;
+    }
+    uintptr_t address = (uintptr_t)str->data;
+    size_t low = 0;
+    size_t high = gigly_gc.string_count;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if ((uintptr_t)(gigly_gc.strings[mid] + 1) <= address) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low == 0) {
+        return;
+    }
+    gigly_gc_header* header = gigly_gc.strings[low - 1];
+    if (address < (uintptr_t)(header + 1) + (uintptr_t)(header->bytes - GIGLY_GC_HEADER_BYTES)) {
+        header->mark = gigly_gc.epoch;
+    }
+}
+
+// Marks every pointer and string inside `count` consecutive values laid out as `desc`
+static void gigly_gc_scan(const char* base, const gigly_gc_desc* desc, int64_t count) {
+    for (int64_t i = 0; i < count; i++) {
+        const char* value = base + i * desc->size;
+        for (int64_t j = 0; j < desc->count; j++) {
+            gigly_gc_mark(*(void* const*)(value + desc->offsets[j]));
+        }
+        for (int64_t j = desc->count; j < desc->count + desc->strings; j++) {
+            gigly_gc_mark_string((const gigly_str*)(value + desc->offsets[j]));
+        }
+    }
+}
+
+static void gigly_gc_trace(gigly_gc_header* header) {
+    if (header->desc == NULL) {
+        return;
+    }
+    if (header->kind == GIGLY_GC_ARRAY) {
+        gigly_array* array = (gigly_array*)(header + 1);
+        if (array->data != NULL) {
+            gigly_gc_scan(array->data, header->desc, array->len);
+        }
+    } else {
+        gigly_gc_scan((const char*)(header + 1), header->desc, (header->bytes - GIGLY_GC_HEADER_BYTES) / header->desc->size);
+    }
+}
+
+static int64_t gigly_gc_object_bytes(gigly_gc_header* header) {
+    // what was taken from the pools, an array's element buffer is accounted separately
+    return header->kind == GIGLY_GC_ARRAY ? GIGLY_GC_HEADER_BYTES + (int64_t)sizeof(gigly_array) : header->bytes;
+}
+
+static void gigly_gc_sweep(void) {
+    gigly_gc_header** link = &gigly_gc.objects;
+    int64_t live = 0;
+    while (*link != NULL) {
+        gigly_gc_header* header = *link;
+        if (header->mark == gigly_gc.epoch) {
+            live += header->bytes;
+            link = &header->next;
+            continue;
+        }
+        *link = header->next;
+        gigly_gc.total_freed += header->bytes;
+        if (header->kind == GIGLY_GC_ARRAY) {
+            free(((gigly_array*)(header + 1))->data);
+        }
+        gigly_pool_free(header, gigly_gc_object_bytes(header));
+    }
+    gigly_gc.live = live;
+}
+
+void gigly_gc_collect(void) {
+    if (!gigly_gc.initialized) {
+        gigly_gc_init();
+    }
+    double start = gigly_gc_now();
+    gigly_gc.epoch++;
+    gigly_gc_index_strings();
+    for (gigly_stack_entry* entry = llvm_gc_root_chain; entry != NULL; entry = entry->next) {
+        for (int32_t i = 0; i < entry->map->num_roots; i++) {
+            const gigly_gc_desc* desc = i < entry->map->num_meta ? entry->map->meta[i] : NULL;
+            if (desc != NULL) {
+                gigly_gc_scan(entry->roots[i], desc, 1);
+            } else {
+                gigly_gc_mark(entry->roots[i]);
+            }
+        }
+    }
+    while (gigly_gc.mark_top > 0) {
+        gigly_gc_trace(gigly_gc.mark_stack[--gigly_gc.mark_top]);
+    }
+    gigly_gc_sweep();
+    gigly_gc.allocated = 0;
+    gigly_gc.threshold = (int64_t)((double)gigly_gc.live * gigly_gc.growth);
+    if (gigly_gc.threshold < gigly_gc.initial_heap) {
+        gigly_gc.threshold = gigly_gc.initial_heap;
+    }
+    double pause = gigly_gc_now() - start;
+    gigly_gc.collections++;
+    gigly_gc.total_pause += pause;
+    if (pause > gigly_gc.max_pause) {
+        gigly_gc.max_pause = pause;
+    }
+    if (gigly_gc.stats > 1) {
+        fprintf(stderr, "[gc] collection %lld: %.3f ms, %lld bytes live, next at %lld\n", (long long)gigly_gc.collections, pause * 1e3, (long long)gigly_gc.live,
+                (long long)gigly_gc.threshold);
+    }
+}
+
+void* gigly_gc_alloc(int64_t size, uint32_t kind, const gigly_gc_desc* desc) {
+    gigly_arena* arena = gigly_arena_current();
+    gigly_gc_header* header = NULL;
+    if (arena != NULL) {
+        header = gigly_arena_alloc(arena, GIGLY_GC_HEADER_BYTES + size);
+        header->next = NULL;
+    } else {
+        if (!gigly_gc.initialized) {
+            gigly_gc_init();
+        }
+        if (gigly_gc.allocated >= gigly_gc.threshold) {
+            gigly_gc_collect();
+        }
+        // small objects come from the thread-local bump regions of the pools
+        header = gigly_pool_alloc(GIGLY_GC_HEADER_BYTES + size);
+        header->next = gigly_gc.objects;
+        gigly_gc.objects = header;
+        gigly_gc.allocated += GIGLY_GC_HEADER_BYTES + size;
+        gigly_gc.total_allocated += GIGLY_GC_HEADER_BYTES + size;
+    }
+    header->desc = desc;
+    header->bytes = GIGLY_GC_HEADER_BYTES + size;
+    header->kind = kind;
+    header->mark = gigly_gc.epoch;
+    memset(header + 1, 0, (size_t)size);
+    return header + 1;
+}
+
+// Charges memory an object owns outside of its header, such as an array's element buffer
+void gigly_gc_account(void* object, int64_t bytes) {
+    gigly_gc_header_of(object)->bytes += bytes;
+    gigly_gc.allocated += bytes;
+    gigly_gc.total_allocated += bytes;
+}
@@ -0,0 +1,130 @@
+#ifndef GIGLY_RUNTIME_H
+#define GIGLY_RUNTIME_H
+
+#include <stdint.h>
+
+// Runtime support linked into every GigglyCode executable. The compiler emits
+// calls to these functions, the layouts below must match the LLVM types it uses.
+// C and C++ code called through extern "C" declarations includes it for the same layouts.
+
+#ifdef __cplusplus
+#define GIGLY_NORETURN [[noreturn]]
+extern "C" {
+#else
+#define GIGLY_NORETURN _Noreturn
+#endif
+
+typedef struct gigly_arena gigly_arena;
+
+// Heap array header, `array[T]` values are pointers to one of these
+typedef struct gigly_array {
+    void* data;
+    int64_t len;
+    int64_t cap;
+    gigly_arena* arena; // arena the array was created in, NULL when it lives on the heap
+} gigly_array;
+
+// Immutable string, `str` values. Strings of up to GIGLY_STR_SSO_MAX bytes are stored inline: the first 15 bytes
+// hold the characters and the top byte of len holds 0x80 | length, so a negative len marks an inline string.
+typedef struct gigly_str {
+    const char* data;
+    int64_t len;
+} gigly_str;
+
+#define GIGLY_STR_SSO_MAX 15
+
+static inline int64_t gigly_str_len(const gigly_str* str) {
+    return str->len < 0 ? (int64_t)(((uint64_t)str->len >> 56) & 0x7f) : str->len;
+}
+
+static inline const char* gigly_str_chars(const gigly_str* str) {
+    return str->len < 0 ? (const char*)str : str->data;
+}
+
+// Bump-pointer arenas back `arena { ... }` blocks, everything allocated while one is current is freed with it
+gigly_arena* gigly_arena_enter(int64_t chunk_size);
+void gigly_arena_exit(gigly_arena* arena);
+gigly_arena* gigly_arena_current(void);
+void* gigly_arena_alloc(gigly_arena* arena, int64_t size);
+
+// Size-class pools for small fixed-size objects outside of arenas
+void* gigly_pool_alloc(int64_t size);
+void gigly_pool_free(void* ptr, int64_t size);
+
+// Collector type descriptor: the stride of one value, then the offsets of its `count` heap pointers
+// followed by the offsets of its `strings` gigly_str values
+typedef struct gigly_gc_desc {
+    int64_t size;
+    int64_t count;
+    int64_t strings;
+    int64_t offsets[];
+} gigly_gc_desc;
+
+enum { GIGLY_GC_OBJECT = 0, GIGLY_GC_ARRAY = 1, GIGLY_GC_STRING = 2 };
+
+// Precedes every collected object. Heap objects are linked for the sweep, arena objects only carry it for marking.
+typedef struct gigly_gc_header {
+    struct gigly_gc_header* next;
+    const gigly_gc_desc* desc; // layout of the payload values (array elements), NULL when they hold no pointers
+    int64_t bytes;             // accounted size, an array includes its element buffer
+    uint32_t kind;
+    uint32_t mark;
+} gigly_gc_header;
+
+static inline gigly_gc_header* gigly_gc_header_of(void* object) {
+    return (gigly_gc_header*)object - 1;
+}
+
+// Allocates a zeroed object from the current arena, or from the collected heap when no arena is active
+void* gigly_gc_alloc(int64_t size, uint32_t kind, const gigly_gc_desc* desc);
+void gigly_gc_account(void* object, int64_t bytes);
+void gigly_gc_collect(void);
+
+gigly_array* gigly_array_new(int64_t elem_size, int64_t cap, const gigly_gc_desc* elem_desc);
+void gigly_array_grow(gigly_array* array, int64_t elem_size, int64_t min_cap, const gigly_gc_desc* elem_desc);
+gigly_array* gigly_array_slice(gigly_array* array, int64_t elem_size, int64_t start, int64_t end);
+// Stops the program when an element just appended to `array` points into an arena that is freed before the array is
+void gigly_arena_check_escape(const gigly_array* array, const void* element, const gigly_gc_desc* elem_desc);
+// Concatenates all parts into one buffer sized up front, a chain of `+` is a single call
+void gigly_str_concat(gigly_str* out, const gigly_str* parts, int64_t count);
+// str[start:end] shares the characters of str, only inline strings are copied
+void gigly_str_slice(gigly_str* out, const gigly_str* str, int64_t start, int64_t end);
+void gigly_str_puts(const gigly_str* str);
+
+// Buffered output to stdout (fd 1) or stderr (fd 2), flushed when full, by gigly_io_flush and at exit
+void gigly_io_write_str(int32_t fd, const gigly_str* str);
+void gigly_io_write_int(int32_t fd, int64_t value);
+void gigly_io_write_uint(int32_t fd, uint64_t value);
+void gigly_io_write_float(int32_t fd, double value);
+void gigly_io_write_f32(int32_t fd, float value);
+void gigly_io_write_bool(int32_t fd, int32_t value);
+void gigly_io_write_char(int32_t fd, int32_t value);
+void gigly_io_flush(void);
+
+// Files behind open/read/write/close, writes share the buffered output path
+int64_t gigly_file_open(const gigly_str* path, const gigly_str* mode);
+void gigly_file_read(gigly_str* out, int64_t fd, int64_t count);
+int64_t gigly_file_write(int64_t fd, const gigly_str* data);
+int64_t gigly_file_close(int64_t fd);
+// Maps a whole file read-only, the result is a str over the mapping
+void gigly_file_map(gigly_str* out, const gigly_str* path);
+
+// State of a `for line in lines(...)` loop, lines are slices of chunk
+typedef struct gigly_line_reader {
+    gigly_str chunk;     // the string being split, or the current buffer of a file
+    int64_t offset;      // start of the next line in chunk
+    int64_t fd;          // file being streamed, -1 once there is nothing left to read
+    int64_t buffer_size; // bytes read from the file at a time
+} gigly_line_reader;
+
+void gigly_lines_open(gigly_line_reader* reader, const gigly_str* text, int64_t fd, int64_t buffer_size);
+int32_t gigly_lines_next(gigly_line_reader* reader, gigly_str* line);
+
+GIGLY_NORETURN void gigly_bounds_fail(int64_t index, int64_t len);
+GIGLY_NORETURN void gigly_range_step_fail(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GIGLY_RUNTIME_H
@@ -0,0 +1,560 @@
+#include "gigly_runtime.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Buffered I/O. Files, and stdout when it is a pipe or a file, collect text in a 64 KiB buffer that is
+// handed to write(2) when it fills up, on flush(), on close() and at exit, so writing a line costs a memcpy
+// instead of a syscall. stdout on a terminal is flushed at every newline and stderr is written through,
+// so nothing shown before a crash is lost.
+// Numbers are formatted here instead of by printf: integers two digits at a time, floats with Grisu2,
+// which finds the shortest digits that read back as the same double.
+
+#define GIGLY_IO_BUFFER 65536
+
+typedef enum gigly_io_mode { GIGLY_IO_FULL, GIGLY_IO_LINE, GIGLY_IO_UNBUFFERED } gigly_io_mode;
+
+typedef struct gigly_io_stream {
+    int fd;
+    gigly_io_mode mode;
+    int64_t used;
+    char data[GIGLY_IO_BUFFER];
+} gigly_io_stream;
+
+static gigly_io_stream gigly_io_streams[2] = {{1, GIGLY_IO_FULL, 0, {0}}, {2, GIGLY_IO_UNBUFFERED, 0, {0}}};
+static gigly_io_stream** gigly_io_files = NULL; // streams of opened files, indexed by descriptor
+static int64_t gigly_io_file_count = 0;
+static int gigly_io_registered = 0;
+
+static void gigly_io_write_all(int fd, const char* chars, int64_t len) {
+    while (len > 0) {
+        ssize_t written = write(fd, chars, (size_t)len);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return; // nowhere left to report the error
+        }
+        chars += written;
+        len -= written;
+    }
+}
+
+static void gigly_io_drain(gigly_io_stream* stream) {
+    gigly_io_write_all(stream->fd, stream->data, stream->used);
+    stream->used = 0;
+}
+
+void gigly_io_flush(void) {
+    gigly_io_drain(&gigly_io_streams[0]);
+    gigly_io_drain(&gigly_io_streams[1]);
+    for (int64_t fd = 0; fd < gigly_io_file_count; fd++) {
+        if (gigly_io_files[fd] != NULL) {
+            gigly_io_drain(gigly_io_files[fd]);
+        }
+    }
+}
+
+static gigly_io_stream* gigly_io_stream_of(int64_t fd) {
+    if (!gigly_io_registered) {
+        gigly_io_registered = 1;
+        gigly_io_streams[0].mode = isatty(1) ? GIGLY_IO_LINE : GIGLY_IO_FULL;
+        atexit(gigly_io_flush);
+    }
+    if (fd == 1 || fd == 2) {
+        return &gigly_io_streams[fd - 1];
+    }
+    if (fd >= gigly_io_file_count) {
+        int64_t count = fd + 1 > gigly_io_file_count * 2 ? fd + 1 : gigly_io_file_count * 2;
+        gigly_io_files = realloc(gigly_io_files, (size_t)count * sizeof(gigly_io_stream*));
+        if (gigly_io_files == NULL) {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+        memset(gigly_io_files + gigly_io_file_count, 0, (size_t)(count - gigly_io_file_count) * sizeof(gigly_io_stream*));
+        gigly_io_file_count = count;
+    }
+    if (gigly_io_files[fd] == NULL) {
+        gigly_io_files[fd] = malloc(sizeof(gigly_io_stream));
+        if (gigly_io_files[fd] == NULL) {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+        gigly_io_files[fd]->fd = (int)fd;
+        gigly_io_files[fd]->mode = GIGLY_IO_FULL;
+        gigly_io_files[fd]->used = 0;
+    }
+    return gigly_io_files[fd];
+}
+
+static void gigly_io_put(int64_t fd, const char* chars, int64_t len) {
+    gigly_io_stream* stream = gigly_io_stream_of(fd);
+    if (stream->mode == GIGLY_IO_UNBUFFERED) {
+        gigly_io_write_all(stream->fd, chars, len);
+        return;
+    }
+    if (stream->used + len > GIGLY_IO_BUFFER) {
+        gigly_io_drain(stream);
+        if (len > GIGLY_IO_BUFFER) {
+            gigly_io_write_all(stream->fd, chars, len);
+            return;
+        }
+    }
+    memcpy(stream->data + stream->used, chars, (size_t)len);
+    stream->used += len;
+    if (stream->mode == GIGLY_IO_LINE && memchr(chars, '\n', (size_t)len) != NULL) {
+        gigly_io_drain(stream);
+    }
+}
+
+static const char gigly_io_digit_pairs[] = "00010203040506070809101112131415161718192021222324252627282930313233343536373839404142434445464748495051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+
+// Writes the digits of value so they end right before `end`, returns where they start
+static char* gigly_io_format_uint(char* end, uint64_t value) {
+    while (value >= 100) {
+        const char* pair = gigly_io_digit_pairs + (value % 100) * 2;
+        value /= 100;
+        *--end = pair[1];
+        *--end = pair[0];
+    }
+    if (value >= 10) {
+        const char* pair = gigly_io_digit_pairs + value * 2;
+        *--end = pair[1];
+        *--end = pair[0];
+    } else {
+        *--end = (char)('0' + value);
+    }
+    return end;
+}
+
+// Grisu2, after Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers"
+
+typedef struct gigly_fp {
+    uint64_t f;
+    int e;
+} gigly_fp;
+
+// Normalized 64-bit approximations of 10^k for k = -348, -340, ..., 340
+static const uint64_t gigly_fp_powers_f[] = {
+    0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL, 0xcf42894a5dce35eaULL,
+    0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL, 0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL,
+    0xbe5691ef416bd60cULL, 0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+    0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL, 0xc21094364dfb5637ULL,
+    0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL, 0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL,
+    0xb23867fb2a35b28eULL, 0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+    0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL, 0xb5b5ada8aaff80b8ULL,
+    0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL, 0x964e858c91ba2655ULL, 0xdff9772470297ebdULL,
+    0xa6dfbd9fb8e5b88fULL, 0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+    0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL, 0xaa242499697392d3ULL,
+    0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL, 0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL,
+    0x9c40000000000000ULL, 0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+    0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL, 0x9f4f2726179a2245ULL,
+    0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL, 0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL,
+    0x924d692ca61be758ULL, 0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+    0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL, 0x952ab45cfa97a0b3ULL,
+    0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL, 0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL,
+    0x88fcf317f22241e2ULL, 0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+    0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL, 0x8bab8eefb6409c1aULL,
+    0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL, 0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL,
+    0x80444b5e7aa7cf85ULL, 0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+    0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL,
+};
+
+static const int16_t gigly_fp_powers_e[] = {
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+    -901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+    -582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+    -263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+    56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+    694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+    1013, 1039, 1066,
+};
+
+static const uint64_t gigly_fp_pow10[] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+    10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL, 1000000000000000ULL,
+    10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL,
+};
+
+static gigly_fp gigly_fp_normalize(gigly_fp x) {
+    int shift = __builtin_clzll(x.f);
+    return (gigly_fp){x.f << shift, x.e - shift};
+}
+
+static gigly_fp gigly_fp_mul(gigly_fp x, gigly_fp y) {
+    unsigned __int128 product = (unsigned __int128)x.f * y.f;
+    uint64_t high = (uint64_t)(product >> 64);
+    if ((uint64_t)product & (1ULL << 63)) {
+        high++; // round to nearest
+    }
+    return (gigly_fp){high, x.e + y.e + 64};
+}
+
+static void gigly_grisu_round(char* digits, int len, uint64_t delta, uint64_t rest, uint64_t ten_kappa, uint64_t wp_w) {
+    while (rest < wp_w && delta - rest >= ten_kappa && (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w)) {
+        digits[len - 1]--;
+        rest += ten_kappa;
+    }
+}
+
+static int gigly_grisu_digits(gigly_fp w, gigly_fp mp, uint64_t delta, char* digits, int* k) {
+    gigly_fp one = {1ULL << -mp.e, mp.e};
+    uint64_t wp_w = mp.f - w.f;
+    uint32_t p1 = (uint32_t)(mp.f >> -one.e);
+    uint64_t p2 = mp.f & (one.f - 1);
+    int kappa = 1;
+    while (kappa < 10 && p1 >= gigly_fp_pow10[kappa]) {
+        kappa++;
+    }
+    int len = 0;
+    while (kappa > 0) {
+        uint32_t digit = (uint32_t)(p1 / gigly_fp_pow10[kappa - 1]);
+        p1 = (uint32_t)(p1 % gigly_fp_pow10[kappa - 1]);
+        if (digit || len) {
+            digits[len++] = (char)('0' + digit);
+        }
+        kappa--;
+        uint64_t rest = ((uint64_t)p1 << -one.e) + p2;
+        if (rest <= delta) {
+            *k += kappa;
+            gigly_grisu_round(digits, len, delta, rest, gigly_fp_pow10[kappa] << -one.e, wp_w);
+            return len;
+        }
+    }
+    for (;;) {
+        p2 *= 10;
+        delta *= 10;
+        char digit = (char)(p2 >> -one.e);
+        if (digit || len) {
+            digits[len++] = (char)('0' + digit);
+        }
+        p2 &= one.f - 1;
+        kappa--;
+        if (p2 < delta) {
+            *k += kappa;
+            gigly_grisu_round(digits, len, delta, p2, one.f, wp_w * gigly_fp_pow10[-kappa]);
+            return len;
+        }
+    }
+}
+
+// Shortest digits of a finite, positive value v with `fraction_bits` bits after its hidden bit (52 for a
+// double, 23 for a float), v equals digits * 10^k
+static int gigly_grisu2(gigly_fp v, int fraction_bits, char* digits, int* k) {
+    // neighbours halfway to the adjacent representable values, every number between them reads back as v
+    gigly_fp plus = gigly_fp_normalize((gigly_fp){(v.f << 1) + 1, v.e - 1});
+    gigly_fp minus = v.f == (1ULL << fraction_bits) ? (gigly_fp){(v.f << 2) - 1, v.e - 2} : (gigly_fp){(v.f << 1) - 1, v.e - 1};
+    minus.f <<= minus.e - plus.e;
+    minus.e = plus.e;
+    double dk = (-61 - plus.e) * 0.30102999566398114 + 347;
+    int power = (int)dk;
+    if (dk - power > 0.0) {
+        power++;
+    }
+    unsigned index = (unsigned)((power >> 3) + 1);
+    *k = -(-348 + (int)(index << 3));
+    gigly_fp cached = {gigly_fp_powers_f[index], gigly_fp_powers_e[index]};
+    gigly_fp w = gigly_fp_mul(gigly_fp_normalize(v), cached);
+    gigly_fp wp = gigly_fp_mul(plus, cached);
+    gigly_fp wm = gigly_fp_mul(minus, cached);
+    wm.f++;
+    wp.f--;
+    return gigly_grisu_digits(w, wp, wp.f - wm.f, digits, k);
+}
+
+// Formats value like Python's repr: 0.1, 100.0, 1e+16, 1.5e-07. Returns the length written to out.
+// With `single` the shortest digits that read back as the same float are used instead.
+static int gigly_io_format_float(char* out, double value, int single) {
+    char* cursor = out;
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    if ((bits & 0x7ff0000000000000ULL) == 0x7ff0000000000000ULL) {
+        const char* text = (bits & 0x000fffffffffffffULL) ? "nan" : (bits >> 63) ? "-inf" : "inf";
+        memcpy(out, text, strlen(text));
+        return (int)strlen(text);
+    }
+    if (bits >> 63) {
+        *cursor++ = '-';
+        value = -value;
+    }
+    if (value == 0.0) {
+        memcpy(cursor, "0.0", 3);
+        return (int)(cursor - out) + 3;
+    }
+    char digits[24];
+    int k;
+    int len;
+    if (single) {
+        float narrow = (float)value;
+        uint32_t narrow_bits;
+        memcpy(&narrow_bits, &narrow, sizeof(narrow_bits));
+        int biased_e = (int)((narrow_bits >> 23) & 0xff);
+        uint64_t fraction = narrow_bits & ((1U << 23) - 1);
+        len = gigly_grisu2(biased_e ? (gigly_fp){fraction | (1ULL << 23), biased_e - 150} : (gigly_fp){fraction, 1 - 150}, 23, digits, &k);
+    } else {
+        int biased_e = (int)((bits >> 52) & 0x7ff);
+        uint64_t fraction = bits & ((1ULL << 52) - 1);
+        len = gigly_grisu2(biased_e ? (gigly_fp){fraction | (1ULL << 52), biased_e - 1075} : (gigly_fp){fraction, 1 - 1075}, 52, digits, &k);
+    }
+    int point = len + k; // digits before the decimal point
+    if (point - 1 < -4 || point - 1 >= 16) {
+        *cursor++ = digits[0];
+        if (len > 1) {
+            *cursor++ = '.';
+            memcpy(cursor, digits + 1, (size_t)(len - 1));
+            cursor += len - 1;
+        }
+        int exponent = point - 1;
+        *cursor++ = 'e';
+        *cursor++ = exponent < 0 ? '-' : '+';
+        exponent = exponent < 0 ? -exponent : exponent;
+        if (exponent < 10) {
+            *cursor++ = '0';
+        }
+        char buffer[4];
+        char* start = gigly_io_format_uint(buffer + sizeof(buffer), (uint64_t)exponent);
+        memcpy(cursor, start, (size_t)(buffer + sizeof(buffer) - start));
+        cursor += buffer + sizeof(buffer) - start;
+    } else if (point >= len) {
+        memcpy(cursor, digits, (size_t)len);
+        memset(cursor + len, '0', (size_t)(point - len));
+        cursor += point;
+        memcpy(cursor, ".0", 2);
+        cursor += 2;
+    } else if (point > 0) {
+        memcpy(cursor, digits, (size_t)point);
+        cursor += point;
+        *cursor++ = '.';
+        memcpy(cursor, digits + point, (size_t)(len - point));
+        cursor += len - point;
+    } else {
+        memcpy(cursor, "0.", 2);
+        memset(cursor + 2, '0', (size_t)-point);
+        cursor += 2 - point;
+        memcpy(cursor, digits, (size_t)len);
+        cursor += len;
+    }
+    return (int)(cursor - out);
+}
+
+void gigly_io_write_str(int32_t fd, const gigly_str* str) {
+    gigly_io_put(fd, gigly_str_chars(str), gigly_str_len(str));
+}
+
+void gigly_io_write_int(int32_t fd, int64_t value) {
+    char buffer[24];
+    char* end = buffer + sizeof(buffer);
+    char* start = gigly_io_format_uint(end, value < 0 ? 0 - (uint64_t)value : (uint64_t)value);
+    if (value < 0) {
+        *--start = '-';
+    }
+    gigly_io_put(fd, start, end - start);
+}
+
+void gigly_io_write_uint(int32_t fd, uint64_t value) {
+    char buffer[24];
+    char* end = buffer + sizeof(buffer);
+    char* start = gigly_io_format_uint(end, value);
+    gigly_io_put(fd, start, end - start);
+}
+
+void gigly_io_write_float(int32_t fd, double value) {
+    char buffer[32];
+    gigly_io_put(fd, buffer, gigly_io_format_float(buffer, value, 0));
+}
+
+void gigly_io_write_f32(int32_t fd, float value) {
+    char buffer[32];
+    gigly_io_put(fd, buffer, gigly_io_format_float(buffer, value, 1));
+}
+
+void gigly_io_write_bool(int32_t fd, int32_t value) {
+    if (value) {
+        gigly_io_put(fd, "True", 4);
+    } else {
+        gigly_io_put(fd, "False", 5);
+    }
+}
+
+void gigly_io_write_char(int32_t fd, int32_t value) {
+    char c = (char)value;
+    gigly_io_put(fd, &c, 1);
+}
+
+// Files
+
+// Copies a str into a NUL-terminated path, returns NULL when it does not fit
+static const char* gigly_io_path(char* buffer, size_t size, const gigly_str* path) {
+    int64_t len = gigly_str_len(path);
+    if (len < 0 || (size_t)len >= size) {
+        return NULL;
+    }
+    memcpy(buffer, gigly_str_chars(path), (size_t)len);
+    buffer[len] = '\0';
+    return buffer;
+}
+
+int64_t gigly_file_open(const gigly_str* path, const gigly_str* mode) {
+    char buffer[4096];
+    const char* c_path = gigly_io_path(buffer, sizeof(buffer), path);
+    int64_t mode_len = gigly_str_len(mode);
+    const char* mode_chars = gigly_str_chars(mode);
+    int flags;
+    if (mode_len == 1 && mode_chars[0] == 'r') {
+        flags = O_RDONLY;
+    } else if (mode_len == 1 && mode_chars[0] == 'w') {
+        flags = O_WRONLY | O_CREAT | O_TRUNC;
+    } else if (mode_len == 1 && mode_chars[0] == 'a') {
+        flags = O_WRONLY | O_CREAT | O_APPEND;
+    } else {
+        return -1;
+    }
+    if (c_path == NULL) {
+        return -1;
+    }
+    int fd;
+    do {
+        fd = open(c_path, flags | O_CLOEXEC, 0644);
+    } while (fd < 0 && errno == EINTR);
+    return fd;
+}
+
+void gigly_file_read(gigly_str* out, int64_t fd, int64_t count) {
+    out->data = NULL;
+    out->len = 0;
+    if (count <= 0) {
+        return;
+    }
+    if (fd < gigly_io_file_count && gigly_io_files[fd] != NULL) {
+        gigly_io_drain(gigly_io_files[fd]);
+    }
+    char* buffer = gigly_gc_alloc(count, GIGLY_GC_STRING, NULL);
+    int64_t filled = 0;
+    while (filled < count) {
+        ssize_t got = read((int)fd, buffer + filled, (size_t)(count - filled));
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            break;
+        }
+        filled += got;
+    }
+    out->data = buffer;
+    out->len = filled;
+}
+
+int64_t gigly_file_write(int64_t fd, const gigly_str* data) {
+    if (fd < 0) {
+        return -1;
+    }
+    gigly_io_put(fd, gigly_str_chars(data), gigly_str_len(data));
+    return gigly_str_len(data);
+}
+
+int64_t gigly_file_close(int64_t fd) {
+    if (fd < 0) {
+        return -1;
+    }
+    if (fd < gigly_io_file_count && gigly_io_files[fd] != NULL) {
+        gigly_io_drain(gigly_io_files[fd]);
+        free(gigly_io_files[fd]);
+        gigly_io_files[fd] = NULL;
+    }
+    return close((int)fd);
+}
+
+void gigly_file_map(gigly_str* out, const gigly_str* path) {
+    char buffer[4096];
+    const char* c_path = gigly_io_path(buffer, sizeof(buffer), path);
+    int fd = c_path != NULL ? open(c_path, O_RDONLY | O_CLOEXEC) : -1;
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        gigly_io_flush();
+        fprintf(stderr, "Cannot open %.*s: %s\n", (int)gigly_str_len(path), gigly_str_chars(path), strerror(errno));
+        exit(1);
+    }
+    out->data = NULL;
+    out->len = 0;
+    if (info.st_size > 0) {
+        // the mapping stays for the rest of the run, strings sliced from it never dangle
+        void* map = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED) {
+            gigly_io_flush();
+            fprintf(stderr, "Cannot map %.*s: %s\n", (int)gigly_str_len(path), gigly_str_chars(path), strerror(errno));
+            exit(1);
+        }
+        madvise(map, (size_t)info.st_size, MADV_SEQUENTIAL);
+        out->data = map;
+        out->len = info.st_size;
+    }
+    close(fd);
+}
+
+// Line iteration
+
+void gigly_lines_open(gigly_line_reader* reader, const gigly_str* text, int64_t fd, int64_t buffer_size) {
+    memset(&reader->chunk, 0, sizeof(reader->chunk));
+    if (text != NULL) {
+        reader->chunk = *text;
+    }
+    reader->offset = 0;
+    reader->fd = text != NULL ? -1 : fd;
+    reader->buffer_size = buffer_size > 0 ? buffer_size : GIGLY_IO_BUFFER;
+}
+
+// Reads the next chunk of the file behind the unfinished line. Chunks are collected strings, so lines
+// handed out earlier keep their chunk alive and are never copied. Returns 0 at the end of the file.
+static int gigly_lines_refill(gigly_line_reader* reader) {
+    int64_t rest = gigly_str_len(&reader->chunk) - reader->offset;
+    int64_t size = reader->buffer_size > rest * 2 ? reader->buffer_size : rest * 2;
+    char* buffer = gigly_gc_alloc(size, GIGLY_GC_STRING, NULL);
+    if (rest > 0) {
+        memcpy(buffer, gigly_str_chars(&reader->chunk) + reader->offset, (size_t)rest);
+    }
+    ssize_t got;
+    do {
+        got = read((int)reader->fd, buffer + rest, (size_t)(size - rest));
+    } while (got < 0 && errno == EINTR);
+    reader->chunk.data = buffer;
+    reader->chunk.len = rest + (got > 0 ? got : 0);
+    reader->offset = 0;
+    if (got <= 0) {
+        reader->fd = -1;
+        return 0;
+    }
+    return 1;
+}
+
+int32_t gigly_lines_next(gigly_line_reader* reader, gigly_str* line) {
+    for (;;) {
+        int64_t len = gigly_str_len(&reader->chunk);
+        if (reader->offset < len) {
+            const char* chars = gigly_str_chars(&reader->chunk);
+            const char* newline = memchr(chars + reader->offset, '\n', (size_t)(len - reader->offset));
+            if (newline != NULL) {
+                int64_t end = newline - chars;
+                gigly_str_slice(line, &reader->chunk, reader->offset, end);
+                reader->offset = end + 1;
+                return 1;
+            }
+        }
+        if (reader->fd < 0 || !gigly_lines_refill(reader)) {
+            break;
+        }
+    }
+    // the last line may lack its newline
+    int64_t len = gigly_str_len(&reader->chunk);
+    if (reader->offset >= len) {
+        return 0;
+    }
+    gigly_str_slice(line, &reader->chunk, reader->offset, len);
+    reader->offset = len;
+    return 1;
+}
@@ -0,0 +1,55 @@
+#include "gigly_runtime.h"
+#include <string.h>
+
+// Builds an inline string, the caller guarantees len <= GIGLY_STR_SSO_MAX
+static gigly_str gigly_str_small(const char* chars, int64_t len) {
+    gigly_str str;
+    memset(&str, 0, sizeof(str));
+    memcpy(&str, chars, (size_t)len);
+    str.len = (int64_t)(((uint64_t)(0x80 | len)) << 56) | (str.len & 0x00ffffffffffffffLL);
+    return str;
+}
+
+void gigly_str_concat(gigly_str* out, const gigly_str* parts, int64_t count) {
+    int64_t len = 0;
+    for (int64_t i = 0; i < count; i++) {
+        len += gigly_str_len(&parts[i]);
+    }
+    char small[GIGLY_STR_SSO_MAX];
+    // short results never touch the heap
+    char* buffer = len <= GIGLY_STR_SSO_MAX ? small : gigly_gc_alloc(len, GIGLY_GC_STRING, NULL);
+    char* cursor = buffer;
+    for (int64_t i = 0; i < count; i++) {
+        int64_t part_len = gigly_str_len(&parts[i]);
+        memcpy(cursor, gigly_str_chars(&parts[i]), (size_t)part_len);
+        cursor += part_len;
+    }
+    if (len <= GIGLY_STR_SSO_MAX) {
+        *out = gigly_str_small(small, len);
+    } else {
+        out->data = buffer;
+        out->len = len;
+    }
+}
+
+void gigly_str_slice(gigly_str* out, const gigly_str* str, int64_t start, int64_t end) {
+    int64_t len = gigly_str_len(str);
+    if (start < 0) {
+        start = 0;
+    }
+    if (end > len) {
+        end = len;
+    }
+    int64_t slice_len = end > start ? end - start : 0;
+    if (str->len < 0) {
+        *out = gigly_str_small(gigly_str_chars(str) + start, slice_len);
+    } else {
+        out->data = str->data + (slice_len > 0 ? start : 0);
+        out->len = slice_len;
+    }
+}
+
+void gigly_str_puts(const gigly_str* str) {
+    gigly_io_write_str(1, str);
+    gigly_io_write_char(1, '\n');
+}
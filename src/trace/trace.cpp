@@ -0,0 +1,67 @@
+#include "trace.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <unordered_map>
+
+std::array<trace::Level, static_cast<size_t>(trace::Category::Count)> trace::levels = {};
+
+namespace {
+constexpr size_t sink_capacity = 64 * 1024;
+
+const char* category_names[] = {"lexer", "parser", "env", "codegen", "import"};
+const char* level_names[] = {"off", "error", "warn", "info", "debug", "trace"};
+
+std::string& sink() {
+    static std::string buffer;
+    return buffer;
+}
+} // namespace
+
+bool trace::configure(const std::string& spec) {
+    static const std::unordered_map<std::string, Level> level_map = {
+        {"off", Level::Off}, {"error", Level::Error}, {"warn", Level::Warn}, {"info", Level::Info}, {"debug", Level::Debug}, {"trace", Level::Trace},
+    };
+    auto colon = spec.find(':');
+    auto category = spec.substr(0, colon);
+    auto level = Level::Debug;
+    if (colon != std::string::npos) {
+        auto found = level_map.find(spec.substr(colon + 1));
+        if (found == level_map.end()) {
+            return false;
+        }
+        level = found->second;
+    }
+    bool matched = false;
+    for (size_t i = 0; i < static_cast<size_t>(Category::Count); i++) {
+        if (category == "all" || category == category_names[i]) {
+            levels[i] = level;
+            matched = true;
+        }
+    }
+    static bool registered = false;
+    if (matched && !registered) {
+        std::atexit(trace::flush);
+        registered = true;
+    }
+    return matched;
+}
+
+void trace::flush() {
+    auto& buffer = sink();
+    std::fwrite(buffer.data(), 1, buffer.size(), stderr);
+    std::fflush(stderr);
+    buffer.clear();
+}
+
+trace::Line::Line(Category category, Level level) {
+    this->stream << '[' << category_names[static_cast<size_t>(category)] << ':' << level_names[static_cast<size_t>(level)] << "] ";
+}
+
+trace::Line::~Line() {
+    auto& buffer = sink();
+    buffer += this->stream.str();
+    buffer += '\n';
+    if (buffer.size() >= sink_capacity) {
+        trace::flush();
+    }
+}
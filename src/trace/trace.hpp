@@ -0,0 +1,61 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+#include <array>
+#include <cstddef>
+#include <sstream>
+#include <string>
+
+// Tracing is compiled into debug builds only, release builds (NDEBUG) turn every GIGLY_TRACE into nothing.
+// Define GIGLY_TRACE_FORCE to keep it in an optimized build.
+#if !defined(NDEBUG) || defined(GIGLY_TRACE_FORCE)
+#define GIGLY_TRACE_ENABLED 1
+#else
+#define GIGLY_TRACE_ENABLED 0
+#endif
+
+namespace trace {
+enum class Category { Lexer, Parser, Env, Codegen, Import, Count };
+enum class Level { Off, Error, Warn, Info, Debug, Trace };
+
+constexpr bool compiled_in = GIGLY_TRACE_ENABLED;
+
+// Most verbose level enabled for each category, everything starts Off
+extern std::array<Level, static_cast<size_t>(Category::Count)> levels;
+
+inline bool enabled(Category category, Level level) { return level <= levels[static_cast<size_t>(category)]; }
+
+// Parses one `--trace` entry: `codegen:debug`, `import` (debug) or `all:info`. Returns false on an unknown category or level.
+bool configure(const std::string& spec);
+
+// Writes the buffered lines to stderr, also done when the buffer fills up and at exit
+void flush();
+
+// One trace line, collected while it is built and handed to the buffered sink as a whole
+class Line {
+  public:
+    Line(Category category, Level level);
+    ~Line();
+    template <typename T> Line& operator<<(const T& value) {
+        this->stream << value;
+        return *this;
+    }
+
+  private:
+    std::ostringstream stream;
+};
+} // namespace trace
+
+#if GIGLY_TRACE_ENABLED
+#define GIGLY_TRACE(category, level, message)                                                                                                                  \
+    do {                                                                                                                                                       \
+        if (trace::enabled(trace::Category::category, trace::Level::level)) {                                                                                  \
+            trace::Line(trace::Category::category, trace::Level::level) << message;                                                                            \
+        }                                                                                                                                                      \
+    } while (0)
+#else
+#define GIGLY_TRACE(category, level, message)                                                                                                                  \
+    do {                                                                                                                                                       \
+    } while (0)
+#endif
+
+#endif // TRACE_HPP
@@ -0,0 +1,70 @@
+#!/bin/bash
+# Builds and runs the test programs: usage test/run.sh [path/to/gigly]
+#   src/    one program, its output must match expected.txt; runs with a small GIGLY_GC_HEAP to collect often
+#   trap/   programs that must stop at runtime with the error named on their `# expect:` line
+#   fail/   programs that must fail to compile with the error named on their `# expect:` line
+set -u
+shopt -s nullglob
+gigly=$(realpath "${1:-./build/gigly}")
+tests=$(dirname "$(realpath "$0")")
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+failures=0
+
+fail() {
+    echo "FAIL $1: $2"
+    failures=$((failures + 1))
+}
+
+expected_error() {
+    sed -n 's/^# expect: //p' "$1" | head -n 1
+}
+
+# Copies a single program into a fresh project, gigly compiles a whole directory
+project() {
+    rm -rf "$work/$1"
+    mkdir -p "$work/$1/src"
+    cp "$2" "$work/$1/src/main.gc"
+}
+
+mkdir -p "$work/main"
+cp -r "$tests/src" "$work/main/src"
+if "$gigly" "$work/main" -o "$work/main/exec" > "$work/main.log" 2>&1; then
+    GIGLY_GC_HEAP=64k "$work/main/exec" > "$work/main.out" 2>&1
+    if ! diff -u "$tests/expected.txt" "$work/main.out"; then
+        fail src "output differs from expected.txt"
+    fi
+    checks=$(grep -c "call void @gigly_bounds_fail" "$work/main/build/ir/bounds.ll")
+    [ "$checks" -eq 2 ] || fail src "bounds.gc keeps $checks bounds checks, expected 2"
+else
+    cat "$work/main.log"
+    fail src "does not compile"
+fi
+
+for program in "$tests"/trap/*.gc; do
+    name=trap-$(basename "$program" .gc)
+    project "$name" "$program"
+    if ! "$gigly" "$work/$name" -o "$work/$name/exec" > "$work/$name.log" 2>&1; then
+        fail "$name" "does not compile"
+        continue
+    fi
+    if "$work/$name/exec" > "$work/$name.out" 2>&1; then
+        fail "$name" "exited successfully"
+    elif ! grep -qF "$(expected_error "$program")" "$work/$name.out"; then
+        fail "$name" "stopped without \"$(expected_error "$program")\""
+    fi
+done
+
+for program in "$tests"/fail/*.gc; do
+    name=fail-$(basename "$program" .gc)
+    project "$name" "$program"
+    "$gigly" "$work/$name" -o "$work/$name/exec" > "$work/$name.log" 2>&1
+    if [ -x "$work/$name/exec" ]; then
+        fail "$name" "compiled"
+    elif ! grep -qF "$(expected_error "$program")" "$work/$name.log"; then
+        fail "$name" "rejected without \"$(expected_error "$program")\""
+    fi
+done
+
+[ "$failures" -eq 0 ] && echo "All tests passed" || echo "$failures failed"
+[ "$failures" -eq 0 ]
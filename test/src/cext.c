@@ -0,0 +1,18 @@
+// C side of externs.gc, compiled and linked with the program
+#include "gigly_runtime.h"
+
+int64_t cext_scale(int64_t x, double factor) {
+    return (int64_t)((double)x * factor);
+}
+
+int64_t cext_sum(const gigly_array* xs) {
+    int64_t total = 0;
+    for (int64_t i = 0; i < xs->len; ++i) {
+        total += ((const int64_t*)xs->data)[i];
+    }
+    return total;
+}
+
+int64_t cext_length(const gigly_str* s) {
+    return gigly_str_len(s);
+}